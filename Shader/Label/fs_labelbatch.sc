@@ -0,0 +1,11 @@
+$input v_color0, v_texcoord0
+
+#include "../bgfx_shader.sh"
+
+SAMPLER2D(s_texColor, 0);
+
+// text color is multiplied into the vertex colors, see Label::onDrawBatched
+void main()
+{
+	gl_FragColor = vec4(v_color0.rgb, v_color0.a * texture2D(s_texColor, v_texcoord0).r);
+}
\ No newline at end of file
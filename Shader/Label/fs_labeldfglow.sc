@@ -4,14 +4,16 @@ $input v_color0, v_texcoord0
 
 uniform vec4 u_effectColor;
 uniform vec4 u_textColor;
+// x: distance where the glow fades out
+uniform vec4 u_effectParams;
 SAMPLER2D(s_texColor, 0);
 
 void main()
 {
-    float dist = texture2D(s_texColor, v_texcoord0).a;
+    float dist = texture2D(s_texColor, v_texcoord0).r;
     float width = fwidth(dist);
     float alpha = smoothstep(0.5-width, 0.5+width, dist);
-    float mu = smoothstep(0.5, 1.0, sqrt(dist));
-    vec4 color = u_effectColor*(1.0 - alpha) + u_textColor*alpha;
-	gl_FragColor = v_color0 * vec4(color.rgb, max(alpha, mu) * color.a);
+    float glow = smoothstep(u_effectParams.x, 0.5, dist);
+    vec4 color = mix(u_effectColor, u_textColor, alpha);
+	gl_FragColor = v_color0 * vec4(color.rgb, mix(glow * u_effectColor.a, u_textColor.a, alpha));
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+$input v_color0, v_texcoord0
+
+#include "../bgfx_shader.sh"
+
+uniform vec4 u_effectColor;
+uniform vec4 u_textColor;
+// x: distance of the outer edge of the outline
+uniform vec4 u_effectParams;
+SAMPLER2D(s_texColor, 0);
+
+void main()
+{
+    float dist = texture2D(s_texColor, v_texcoord0).r;
+    float width = fwidth(dist);
+    float alpha = smoothstep(0.5-width, 0.5+width, dist);
+    float outline = smoothstep(u_effectParams.x-width, u_effectParams.x+width, dist);
+    vec4 color = mix(u_effectColor, u_textColor, alpha);
+	gl_FragColor = v_color0 * vec4(color.rgb, color.a * outline);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+$input v_color0, v_texcoord0
+
+#include "../bgfx_shader.sh"
+
+SAMPLER2D(s_texColor, 0);
+
+// the layers of an outlined label share a batch, see Label::onDrawBatched,
+// 2 * layer is added to u: 0 the text, 1 the outline, 2 the shadow.
+// the atlas has the outlined glyph in r and the glyph in g.
+// v_texcoord0 is highp, see varying_effect.def.sc, u up to 6 loses whole texels at mediump
+void main()
+{
+	highp float layer = floor(v_texcoord0.x * 0.5);
+	highp vec2 texcoord = vec2(v_texcoord0.x - layer * 2.0, v_texcoord0.y);
+	vec4 texel = texture2D(s_texColor, texcoord);
+	float coverage = layer > 0.5 ? texel.r : texel.g;
+	gl_FragColor = vec4(v_color0.rgb, v_color0.a * coverage);
+}
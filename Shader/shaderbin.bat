@@ -19,10 +19,13 @@ shaderc.exe -f .\Sprite\fs_spritealphatest.sc -o .\shader\glsl\fs_spritealphates
 shaderc.exe -f .\Label\vs_labelposition.sc -o .\shader\glsl\vs_labelposition.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type vertex -O3
 shaderc.exe -f .\Label\vs_label.sc -o .\shader\glsl\vs_label.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type vertex -O3
 shaderc.exe -f .\Label\fs_labelnormal.sc -o .\shader\glsl\fs_labelnormal.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type fragment -O3
+shaderc.exe -f .\Label\fs_labelbatch.sc -o .\shader\glsl\fs_labelbatch.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type fragment -O3
+shaderc.exe -f .\Label\fs_labeleffect.sc -o .\shader\glsl\fs_labeleffect.bin  -i .\ --varyingdef .\Label\varying_effect.def.sc --platform linux -p 120 --type fragment -O3
 shaderc.exe -f .\Label\fs_labeloutline.sc -o .\shader\glsl\fs_labeloutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type fragment -O3
 shaderc.exe -f .\Label\fs_labelgradient.sc -o .\shader\glsl\fs_labelgradient.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type fragment -O3
 shaderc.exe -f .\Label\fs_labelgradientoutline.sc -o .\shader\glsl\fs_labelgradientoutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type fragment -O3
 shaderc.exe -f .\Label\fs_labeldfglow.sc -o .\shader\glsl\fs_labeldfglow.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type fragment -O3
 shaderc.exe -f .\Label\fs_labeldf.sc -o .\shader\glsl\fs_labeldf.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type fragment -O3
+shaderc.exe -f .\Label\fs_labeldfoutline.sc -o .\shader\glsl\fs_labeldfoutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type fragment -O3
 shaderc.exe -f .\Draw\vs_graphics.sc -o .\shader\glsl\vs_graphics.bin  -i .\ --varyingdef .\Draw\varying.def.sc --platform linux -p 120 --type vertex -O3
 shaderc.exe -f .\Draw\fs_graphics.sc -o .\shader\glsl\fs_graphics.bin  -i .\ --varyingdef .\Draw\varying.def.sc --platform linux -p 120 --type fragment -O3
\ No newline at end of file
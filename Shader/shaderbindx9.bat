@@ -20,10 +20,13 @@ shaderc.exe -f .\Sprite\fs_spritealphatest.sc -o .\shader\dx9\fs_spritealphatest
 shaderc.exe -f .\Label\vs_labelposition.sc -o .\shader\dx9\vs_labelposition.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p vs_3_0 -O 3 --type vertex -O3
 shaderc.exe -f .\Label\vs_label.sc -o .\shader\dx9\vs_label.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p vs_3_0 -O 3 --type vertex -O3
 shaderc.exe -f .\Label\fs_labelnormal.sc -o .\shader\dx9\fs_labelnormal.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p ps_3_0 -O 3 --type fragment -O3
+shaderc.exe -f .\Label\fs_labelbatch.sc -o .\shader\dx9\fs_labelbatch.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p ps_3_0 -O 3 --type fragment -O3
+shaderc.exe -f .\Label\fs_labeleffect.sc -o .\shader\dx9\fs_labeleffect.bin  -i .\ --varyingdef .\Label\varying_effect.def.sc --platform windows -p ps_3_0 -O 3 --type fragment -O3
 shaderc.exe -f .\Label\fs_labeloutline.sc -o .\shader\dx9\fs_labeloutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p ps_3_0 -O 3 --type fragment -O3
 shaderc.exe -f .\Label\fs_labelgradient.sc -o .\shader\dx9\fs_labelgradient.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p ps_3_0 -O 3 --type fragment -O3
 shaderc.exe -f .\Label\fs_labelgradientoutline.sc -o .\shader\dx9\fs_labelgradientoutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p ps_3_0 -O 3 --type fragment -O3
 shaderc.exe -f .\Label\fs_labeldfglow.sc -o .\shader\dx9\fs_labeldfglow.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p ps_3_0 -O 3 --type fragment -O3
 shaderc.exe -f .\Label\fs_labeldf.sc -o .\shader\dx9\fs_labeldf.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p ps_3_0 -O 3 --type fragment -O3
+shaderc.exe -f .\Label\fs_labeldfoutline.sc -o .\shader\dx9\fs_labeldfoutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p ps_3_0 -O 3 --type fragment -O3
 shaderc.exe -f .\Draw\vs_graphics.sc -o .\shader\dx9\vs_graphics.bin  -i .\ --varyingdef .\Draw\varying.def.sc --platform windows -p vs_3_0 -O 3 --type vertex -O3
 shaderc.exe -f .\Draw\fs_graphics.sc -o .\shader\dx9\fs_graphics.bin  -i .\ --varyingdef .\Draw\varying.def.sc --platform windows -p ps_3_0 -O 3 --type fragment -O3
\ No newline at end of file
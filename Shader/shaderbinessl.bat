@@ -16,10 +16,13 @@ shaderc.exe -f .\Sprite\fs_spritealphatest.sc -o .\shader\essl\fs_spritealphates
 shaderc.exe -f .\Label\vs_labelposition.sc -o .\shader\essl\vs_labelposition.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type vertex -O3
 shaderc.exe -f .\Label\vs_label.sc -o .\shader\essl\vs_label.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type vertex -O3
 shaderc.exe -f .\Label\fs_labelnormal.sc -o .\shader\essl\fs_labelnormal.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type fragment -O3
+shaderc.exe -f .\Label\fs_labelbatch.sc -o .\shader\essl\fs_labelbatch.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type fragment -O3
+shaderc.exe -f .\Label\fs_labeleffect.sc -o .\shader\essl\fs_labeleffect.bin  -i .\ --varyingdef .\Label\varying_effect.def.sc --platform ios -p 120 --type fragment -O3
 shaderc.exe -f .\Label\fs_labeloutline.sc -o .\shader\essl\fs_labeloutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type fragment -O3
 shaderc.exe -f .\Label\fs_labelgradient.sc -o .\shader\essl\fs_labelgradient.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type fragment -O3
 shaderc.exe -f .\Label\fs_labelgradientoutline.sc -o .\shader\essl\fs_labelgradientoutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type fragment -O3
 shaderc.exe -f .\Label\fs_labeldfglow.sc -o .\shader\essl\fs_labeldfglow.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type fragment -O3
 shaderc.exe -f .\Label\fs_labeldf.sc -o .\shader\essl\fs_labeldf.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type fragment -O3
+shaderc.exe -f .\Label\fs_labeldfoutline.sc -o .\shader\essl\fs_labeldfoutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type fragment -O3
 shaderc.exe -f .\Draw\vs_graphics.sc -o .\shader\essl\vs_graphics.bin  -i .\ --varyingdef .\Draw\varying.def.sc --platform ios -p 120 --type vertex -O3
 shaderc.exe -f .\Draw\fs_graphics.sc -o .\shader\essl\fs_graphics.bin  -i .\ --varyingdef .\Draw\varying.def.sc --platform ios -p 120 --type fragment -O3
\ No newline at end of file
@@ -18,11 +18,14 @@ shaderc.exe -f .\Sprite\fs_spritealphatest.sc -o .\shader\metal\fs_spritealphate
 shaderc.exe -f .\Label\vs_labelposition.sc -o .\shader\metal\vs_labelposition.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type vertex -O3
 shaderc.exe -f .\Label\vs_label.sc -o .\shader\metal\vs_label.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type vertex -O3
 shaderc.exe -f .\Label\fs_labelnormal.sc -o .\shader\metal\fs_labelnormal.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type fragment -O3
+shaderc.exe -f .\Label\fs_labelbatch.sc -o .\shader\metal\fs_labelbatch.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type fragment -O3
+shaderc.exe -f .\Label\fs_labeleffect.sc -o .\shader\metal\fs_labeleffect.bin  -i .\ --varyingdef .\Label\varying_effect.def.sc --platform ios -p metal --type fragment -O3
 shaderc.exe -f .\Label\fs_labeloutline.sc -o .\shader\metal\fs_labeloutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type fragment -O3
 shaderc.exe -f .\Label\fs_labelgradient.sc -o .\shader\metal\fs_labelgradient.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type fragment -O3
 shaderc.exe -f .\Label\fs_labelgradientoutline.sc -o .\shader\metal\fs_labelgradientoutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type fragment -O3
 shaderc.exe -f .\Label\fs_labeldfglow.sc -o .\shader\metal\fs_labeldfglow.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type fragment -O3
 shaderc.exe -f .\Label\fs_labeldf.sc -o .\shader\metal\fs_labeldf.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type fragment -O3
+shaderc.exe -f .\Label\fs_labeldfoutline.sc -o .\shader\metal\fs_labeldfoutline.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type fragment -O3
 shaderc.exe -f .\Draw\vs_graphics.sc -o .\shader\metal\vs_graphics.bin  -i .\ --varyingdef .\Draw\varying.def.sc --platform ios -p metal --type vertex -O3
 shaderc.exe -f .\Draw\fs_graphics.sc -o .\shader\metal\fs_graphics.bin  -i .\ --varyingdef .\Draw\varying.def.sc --platform ios -p metal --type fragment -O3
 shaderc.exe -f .\Simple\vs_poscolor.sc -o .\shader\metal\vs_poscolor.bin  -i .\ --varyingdef .\Simple\varying.def.sc --platform ios -p metal --type vertex -O3
@@ -48,6 +48,7 @@ enum {
  */
 class CC_DLL Action : public Ref, public Clonable
 {
+    CC_SLAB_ALLOCATED
 public:
     /** Default tag used for all the actions. */
     static const int INVALID_TAG = -1;
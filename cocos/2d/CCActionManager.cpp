@@ -433,6 +433,7 @@ ssize_t ActionManager::getNumberOfRunningActionsInTarget(const Node *target) con
 // main loop
 void ActionManager::update(float dt)
 {
+    CC_TRACE_SCOPE("ActionManager::update");
     for (tHashElement *elt = _targets; elt != nullptr; )
     {
         _currentTarget = elt;
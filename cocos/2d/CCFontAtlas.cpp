@@ -37,34 +37,363 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/JobSystem.h"
+#include <algorithm>
+#include <deque>
+#include <mutex>
 
 NS_CC_BEGIN
 
 const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
+const float FontAtlas::DistanceFieldFontSize = 50.0f;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
+const char* FontAtlas::CMD_UPDATE_FONTATLAS = "__cc_UPDATE_FONTATLAS";
+int FontAtlas::s_pageWidth = FontAtlas::CacheTextureWidth;
+int FontAtlas::s_pageHeight = FontAtlas::CacheTextureHeight;
+int FontAtlas::s_maxPages = 4;
+
+namespace
+{
+    void clearLetterQuad(FontLetterDefinition& letterDef)
+    {
+        letterDef.width = 0;
+        letterDef.height = 0;
+        letterDef.U = 0;
+        letterDef.V = 0;
+        letterDef.offsetX = 0;
+        letterDef.offsetY = 0;
+        letterDef.textureID = 0;
+    }
+
+    /** Packs rectangles on a skyline, the top edge of what is packed so far.
+     A rectangle goes where its bottom ends lowest, on the narrowest segment
+     for ties, which leaves less room wasted under it than packing in rows.
+     */
+    class SkylinePacker
+    {
+    public:
+        SkylinePacker(int width, int height)
+            :width_(width)
+            ,height_(height)
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            skyline_.clear();
+            skyline_.push_back({0, 0, width_});
+        }
+
+        bool insert(int width, int height, int& x, int& y)
+        {
+            int bestIndex = -1;
+            int bestBottom = height_ + 1;
+            int bestWidth = width_ + 1;
+            int bestY = 0;
+            for (int i = 0; i < static_cast<int>(skyline_.size()); ++i)
+            {
+                int top = 0;
+                if (fit(i, width, height, top))
+                {
+                    int bottom = top + height;
+                    if (bottom < bestBottom || (bottom == bestBottom && skyline_[i].width < bestWidth))
+                    {
+                        bestIndex = i;
+                        bestBottom = bottom;
+                        bestWidth = skyline_[i].width;
+                        bestY = top;
+                    }
+                }
+            }
+            if (bestIndex < 0)
+            {
+                return false;
+            }
+
+            x = skyline_[bestIndex].x;
+            y = bestY;
+            addLevel(bestIndex, x, y + height, width);
+            return true;
+        }
+    private:
+        struct Segment
+        {
+            int x;
+            int y;
+            int width;
+        };
+
+        // the y a rectangle starting at segment index rests at, false if it leaves the page
+        bool fit(int index, int width, int height, int& y) const
+        {
+            if (skyline_[index].x + width > width_)
+            {
+                return false;
+            }
+            y = 0;
+            int remaining = width;
+            while (remaining > 0)
+            {
+                y = std::max(y, skyline_[index].y);
+                if (y + height > height_)
+                {
+                    return false;
+                }
+                remaining -= skyline_[index].width;
+                ++index;
+            }
+            return true;
+        }
+
+        void addLevel(int index, int x, int y, int width)
+        {
+            skyline_.insert(skyline_.begin() + index, {x, y, width});
+
+            // the segments under the new one shrink or go
+            for (size_t i = index + 1; i < skyline_.size();)
+            {
+                auto& previous = skyline_[i - 1];
+                auto& segment = skyline_[i];
+                int overlap = previous.x + previous.width - segment.x;
+                if (overlap <= 0)
+                {
+                    break;
+                }
+                segment.x += overlap;
+                segment.width -= overlap;
+                if (segment.width > 0)
+                {
+                    break;
+                }
+                skyline_.erase(skyline_.begin() + i);
+            }
+
+            for (size_t i = 0; i + 1 < skyline_.size();)
+            {
+                if (skyline_[i].y == skyline_[i + 1].y)
+                {
+                    skyline_[i].width += skyline_[i + 1].width;
+                    skyline_.erase(skyline_.begin() + i + 1);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+    private:
+        int width_;
+        int height_;
+        std::vector<Segment> skyline_;
+    };
+}
+
+/** A texture of the atlas with its pixels, the rows changed since the last upload are dirty. */
+struct FontAtlas::Page
+{
+    Page(int width, int height, int bytesPerPixel)
+        :packer(width, height)
+        ,data(width * height * bytesPerPixel, 0)
+        ,dirtyTop(height)
+        ,dirtyBottom(0)
+    {
+    }
+
+    SkylinePacker packer;
+    std::vector<unsigned char> data;
+    // empty when top >= bottom
+    int dirtyTop;
+    int dirtyBottom;
+};
+
+/** Rasterizes letters on the JobSystem workers, with a FontFreeType of its own
+ per job as a FreeType face can't be used by two threads at once. A job drains
+ the queue with its face and gives the face back when the queue is empty.
+ The letters are rendered to bitmaps of their own, FontAtlas::update copies
+ them to the atlas.
+ */
+class FontAtlas::GlyphRasterizer
+{
+public:
+    struct Letter
+    {
+        char16_t utf16Char;
+        unsigned short charCode;
+        uint32_t generation;
+        Rect rect;
+        int xAdvance;
+        int width;
+        int height;
+        // empty for letters without a bitmap
+        std::vector<unsigned char> pixels;
+    };
+
+    GlyphRasterizer(FontFreeType* font, int faceCount, int letterPadding, int letterEdgeExtend)
+        :letterPadding_(letterPadding)
+        ,letterEdgeExtend_(letterEdgeExtend)
+        ,faceCount_(0)
+        ,quit_(false)
+    {
+        for (int i = 0; i < faceCount; ++i)
+        {
+            FontFreeType* face = font->createThreadFont();
+            if (!face)
+            {
+                break;
+            }
+            fonts_.push_back(face);
+            idleFonts_.push_back(face);
+        }
+        faceCount_ = static_cast<int>(fonts_.size());
+    }
+
+    ~GlyphRasterizer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            quit_ = true;
+        }
+        waitForJobs();
+        for (auto&& font : fonts_)
+        {
+            font->release();
+        }
+    }
+
+    int getFaceCount() const { return faceCount_; }
+
+    void push(char16_t utf16Char, unsigned short charCode, uint32_t generation)
+    {
+        Letter letter;
+        letter.utf16Char = utf16Char;
+        letter.charCode = charCode;
+        letter.generation = generation;
+
+        FontFreeType* font = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(letter));
+            if (idleFonts_.empty())
+            {
+                return;
+            }
+            font = idleFonts_.back();
+            idleFonts_.pop_back();
+        }
+        auto job = SharedJobSystem.run([this, font]() { drain(font); });
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.erase(std::remove_if(jobs_.begin(), jobs_.end(),
+            [](const JobHandle& done) { return done->isFinished(); }), jobs_.end());
+        jobs_.push_back(job);
+    }
+
+    /** Moves the letters done so far to letters, returns false if there are none. */
+    bool takeResults(std::vector<Letter>& letters)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        letters.swap(results_);
+        return !letters.empty();
+    }
+
+    /** Blocks until every queued letter is done. */
+    void finish()
+    {
+        waitForJobs();
+    }
+private:
+    void waitForJobs()
+    {
+        std::vector<JobHandle> jobs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs.swap(jobs_);
+        }
+        // runs other jobs in the meantime, so this holds without spare workers too
+        for (auto&& job : jobs)
+        {
+            SharedJobSystem.wait(job);
+        }
+    }
+
+    void drain(FontFreeType* font)
+    {
+        while (true)
+        {
+            Letter letter;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (quit_ || queue_.empty())
+                {
+                    idleFonts_.push_back(font);
+                    return;
+                }
+                letter = std::move(queue_.front());
+                queue_.pop_front();
+            }
+
+            rasterize(font, letter);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            results_.push_back(std::move(letter));
+        }
+    }
+
+    void rasterize(FontFreeType* font, Letter& letter) const
+    {
+        long bitmapWidth = 0;
+        long bitmapHeight = 0;
+        letter.width = 0;
+        letter.height = 0;
+        auto bitmap = font->getGlyphBitmap(letter.charCode, bitmapWidth, bitmapHeight, letter.rect, letter.xAdvance);
+        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+        {
+            // room for the bitmap as renderCharAt writes it, padding included
+            letter.width = std::max(static_cast<int>(letter.rect.size.width), static_cast<int>(bitmapWidth)) + letterPadding_ + letterEdgeExtend_;
+            letter.height = std::max(static_cast<int>(letter.rect.size.height), static_cast<int>(bitmapHeight)) + letterPadding_ + letterEdgeExtend_;
+            int bytesPerPixel = font->getOutlineSize() > 0 ? 2 : 1;
+            letter.pixels.assign(letter.width * letter.height * bytesPerPixel, 0);
+            font->renderCharAt(letter.pixels.data(), letterEdgeExtend_ / 2, letterEdgeExtend_ / 2,
+                bitmap, bitmapWidth, bitmapHeight, letter.width);
+        }
+    }
+private:
+    int letterPadding_;
+    int letterEdgeExtend_;
+    int faceCount_;
+    std::vector<FontFreeType*> fonts_;
+    // faces not used by a job
+    std::vector<FontFreeType*> idleFonts_;
+    std::vector<JobHandle> jobs_;
+    std::mutex mutex_;
+    std::deque<Letter> queue_;
+    std::vector<Letter> results_;
+    bool quit_;
+};
 
 FontAtlas::FontAtlas(Font &theFont)
 : _font(&theFont)
 , _fontFreeType(nullptr)
 , _iconv(nullptr)
-, _currentPageData(nullptr)
+, _pageWidth(s_pageWidth)
+, _pageHeight(s_pageHeight)
+, _maxPages(s_maxPages)
+, _bytesPerPixel(1)
+, _lettersMoved(false)
 , _fontAscender(0)
 , _rendererRecreatedListener(nullptr)
+, _afterDrawListener(nullptr)
+, _rasterizer(nullptr)
+, _generation(0)
 , _antialiasEnabled(true)
-, _currLineHeight(0)
 {
     _fontFreeType = CocosCast<FontFreeType>(_font.get());
     if (_fontFreeType)
     {
         _lineHeight = _font->getFontMaxHeight();
         _fontAscender = _fontFreeType->getFontAscender();
-        auto texture = new Texture2D();
-
-        _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
         _letterEdgeExtend = 2;
         _letterPadding = 0;
 
@@ -72,23 +401,20 @@ FontAtlas::FontAtlas(Font &theFont)
         {
             _letterPadding += 2 * FontFreeType::DistanceMapSpread;
         }
-        _currentPageDataSize = CacheTextureWidth * CacheTextureHeight;
         auto outlineSize = _fontFreeType->getOutlineSize();
         if(outlineSize > 0)
         {
             _lineHeight += 2 * outlineSize;
-            _currentPageDataSize *= 2;
+            _bytesPerPixel = 2;
         }
 
-        _currentPageData = new (std::nothrow) unsigned char[_currentPageDataSize];
-        memset(_currentPageData, 0, _currentPageDataSize);
+        addPage();
 
-        auto  pixelFormat = outlineSize > 0 ? bgfx::TextureFormat::RG8 : bgfx::TextureFormat::R8;
-        texture->initWithData(_currentPageData, _currentPageDataSize,
-            pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
-
-        addTexture(texture,0);
-        texture->release();
+        // new letters are uploaded once per frame, before bgfx::frame
+        _afterDrawListener = EventListenerCustom::create(Director::EVENT_AFTER_DRAW, [this](EventCustom*) {
+            update();
+        });
+        SharedDirector.getEventDispatcher()->addEventListenerWithFixedPriority(_afterDrawListener, 1);
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
         auto eventDispatcher = SharedDirector.getEventDispatcher();
@@ -109,10 +435,21 @@ FontAtlas::~FontAtlas()
         _rendererRecreatedListener = nullptr;
     }
 #endif
+    if (_afterDrawListener)
+    {
+        SharedDirector.getEventDispatcher()->removeEventListener(_afterDrawListener);
+        _afterDrawListener = nullptr;
+    }
+    delete _rasterizer;
+    _rasterizer = nullptr;
 
     releaseTextures();
 
-    delete []_currentPageData;
+    for (auto&& page : _pages)
+    {
+        delete page;
+    }
+    _pages.clear();
 
 #if CC_TARGET_PLATFORM != CC_PLATFORM_WIN32 && CC_TARGET_PLATFORM != CC_PLATFORM_WINRT && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
     if (_iconv)
@@ -127,11 +464,22 @@ void FontAtlas::reset()
 {
     releaseTextures();
 
-    _currLineHeight = 0;
-    _currentPage = 0;
-    _currentPageOrigX = 0;
-    _currentPageOrigY = 0;
+    for (auto&& page : _pages)
+    {
+        delete page;
+    }
+    _pages.clear();
     _letterDefinitions.clear();
+    _letterSlots.clear();
+    _letterUses.clear();
+    _lettersMoved = false;
+    _deferredLetters.clear();
+    _generation++;
+
+    if (_fontFreeType)
+    {
+        addPage();
+    }
 }
 
 void FontAtlas::releaseTextures()
@@ -332,17 +680,27 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16Text)
     int adjustForExtend = _letterEdgeExtend / 2;
     long bitmapWidth;
     long bitmapHeight;
-    int glyphHeight;
     Rect tempRect;
     FontLetterDefinition tempDef;
 
     auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    bgfx::TextureFormat::Enum pixelFormat = _fontFreeType->getOutlineSize() > 0 ? bgfx::TextureFormat::RG8 : bgfx::TextureFormat::R8;
-
-    float startY = _currentPageOrigY;
 
     for (auto&& it : codeMapOfNewChar)
     {
+        if (_rasterizer)
+        {
+            // the advance is enough for the layout until update adds the bitmap
+            tempDef.xAdvance = _fontFreeType->getGlyphAdvance(it.second);
+            tempDef.validDefinition = tempDef.xAdvance != 0;
+            clearLetterQuad(tempDef);
+            if (tempDef.validDefinition)
+            {
+                _rasterizer->push(it.first, it.second, _generation);
+            }
+            _letterDefinitions[it.first] = tempDef;
+            continue;
+        }
+
         auto bitmap = _fontFreeType->getGlyphBitmap(it.second, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
         if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
         {
@@ -352,60 +710,29 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16Text)
             tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
             tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
 
-            if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+            // room for the bitmap as renderCharAt writes it, padding included
+            int slotWidth = std::max(static_cast<int>(tempRect.size.width), static_cast<int>(bitmapWidth)) + _letterPadding + _letterEdgeExtend;
+            int slotHeight = std::max(static_cast<int>(tempRect.size.height), static_cast<int>(bitmapHeight)) + _letterPadding + _letterEdgeExtend;
+            LetterSlot slot;
+            if (reserveLetter(it.first, slotWidth, slotHeight, slot))
             {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
-                {
-                    unsigned char *data = nullptr;
-                    if (pixelFormat == bgfx::TextureFormat::RG8)
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-                    }
-                    else
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY;
-                    }
-                    _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
-                        CacheTextureWidth, CacheTextureHeight - startY);
-
-                    startY = 0.0f;
+                _fontFreeType->renderCharAt(_pages[slot.page]->data.data(), slot.x + adjustForExtend, slot.y + adjustForExtend,
+                    bitmap, bitmapWidth, bitmapHeight, _pageWidth);
+                setLetterSlot(tempDef, slot);
 
-                    _currentPageOrigY = 0;
-                    memset(_currentPageData, 0, _currentPageDataSize);
-                    _currentPage++;
-                    auto tex = new (std::nothrow) Texture2D;
-                    if (_antialiasEnabled)
-                    {
-                        tex->setAntiAliasTexParameters();
-                    }
-                    else
-                    {
-                        tex->setAliasTexParameters();
-                    }
-                    tex->initWithData(_currentPageData, _currentPageDataSize,
-                        pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
-                    addTexture(tex, _currentPage);
-                }
+                // take from pixels to points
+                tempDef.width = tempDef.width / scaleFactor;
+                tempDef.height = tempDef.height / scaleFactor;
             }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
+            else
             {
-                _currLineHeight = glyphHeight;
+                clearLetterQuad(tempDef);
+                if (_fontFreeType->getOutlineSize() > 0)
+                {
+                    // the outlined bitmaps are allocated by getGlyphBitmap
+                    delete [] bitmap;
+                }
             }
-            _fontFreeType->renderCharAt(_currentPageData, _currentPageOrigX + adjustForExtend, _currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
-
-            tempDef.U = _currentPageOrigX;
-            tempDef.V = _currentPageOrigY;
-            tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
-            // take from pixels to points
-            tempDef.width = tempDef.width / scaleFactor;
-            tempDef.height = tempDef.height / scaleFactor;
-            tempDef.U = tempDef.U / scaleFactor;
-            tempDef.V = tempDef.V / scaleFactor;
         }
         else{
             if (tempDef.xAdvance)
@@ -413,33 +740,405 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16Text)
             else
                 tempDef.validDefinition = false;
 
-            tempDef.width = 0;
-            tempDef.height = 0;
-            tempDef.U = 0;
-            tempDef.V = 0;
-            tempDef.offsetX = 0;
-            tempDef.offsetY = 0;
-            tempDef.textureID = 0;
-            _currentPageOrigX += 1;
+            clearLetterQuad(tempDef);
         }
 
         _letterDefinitions[it.first] = tempDef;
     }
 
-    unsigned char *data = nullptr;
-    if (pixelFormat == bgfx::TextureFormat::RG8)
+    return true;
+}
+
+void FontAtlas::setAsyncRasterization(bool async)
+{
+    if (async == isAsyncRasterization() || _fontFreeType == nullptr)
+    {
+        return;
+    }
+
+    if (async)
+    {
+        // at most two letters of a font are rasterized at once, whatever the number of fonts
+        _rasterizer = new GlyphRasterizer(_fontFreeType, 2, _letterPadding, _letterEdgeExtend);
+        if (_rasterizer->getFaceCount() == 0)
+        {
+            CCLOG("FontAtlas: no FreeType face for the worker threads, rasterizing on the main thread.");
+            delete _rasterizer;
+            _rasterizer = nullptr;
+        }
+    }
+    else
+    {
+        // the queued letters only have their advance yet, update() tells the labels
+        _rasterizer->finish();
+        addRasterizedLetters();
+        delete _rasterizer;
+        _rasterizer = nullptr;
+    }
+}
+
+void FontAtlas::update()
+{
+    addRasterizedLetters();
+
+    // the draws of this frame are submitted, the letters they use go up before any of them moves
+    uploadDirtyRows();
+
+    if (!_deferredLetters.empty())
+    {
+        // the labels lay out again with the repacked page before the next upload
+        evictLetters();
+        for (auto utf16Char : _deferredLetters)
+        {
+            _letterDefinitions.erase(utf16Char);
+        }
+        _deferredLetters.clear();
+        _lettersMoved = true;
+    }
+
+    if (_lettersMoved)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+        _lettersMoved = false;
+        SharedDirector.getEventDispatcher()->dispatchCustomEvent(CMD_UPDATE_FONTATLAS, this);
+    }
+}
+
+void FontAtlas::addRasterizedLetters()
+{
+    std::vector<GlyphRasterizer::Letter> letters;
+    if (_rasterizer && _rasterizer->takeResults(letters))
+    {
+        int adjustForDistanceMap = _letterPadding / 2;
+        int adjustForExtend = _letterEdgeExtend / 2;
+        auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
+        bool added = false;
+
+        for (auto&& letter : letters)
+        {
+            if (letter.generation != _generation)
+            {
+                continue;
+            }
+
+            FontLetterDefinition letterDef;
+            letterDef.xAdvance = letter.xAdvance;
+            LetterSlot slot;
+            if (letter.pixels.empty())
+            {
+                letterDef.validDefinition = letter.xAdvance != 0;
+                clearLetterQuad(letterDef);
+            }
+            else if (reserveLetter(letter.utf16Char, letter.width, letter.height, slot))
+            {
+                letterDef.validDefinition = true;
+                letterDef.width = letter.rect.size.width + _letterPadding + _letterEdgeExtend;
+                letterDef.height = letter.rect.size.height + _letterPadding + _letterEdgeExtend;
+                letterDef.offsetX = letter.rect.origin.x - adjustForDistanceMap - adjustForExtend;
+                letterDef.offsetY = _fontAscender + letter.rect.origin.y - adjustForDistanceMap - adjustForExtend;
+                setLetterSlot(letterDef, slot);
+
+                auto& data = _pages[slot.page]->data;
+                for (int y = 0; y < letter.height; ++y)
+                {
+                    memcpy(data.data() + ((slot.y + y) * _pageWidth + slot.x) * _bytesPerPixel,
+                        letter.pixels.data() + y * letter.width * _bytesPerPixel, letter.width * _bytesPerPixel);
+                }
+
+                // take from pixels to points
+                letterDef.width = letterDef.width / scaleFactor;
+                letterDef.height = letterDef.height / scaleFactor;
+            }
+            else
+            {
+                letterDef.validDefinition = true;
+                clearLetterQuad(letterDef);
+            }
+            _letterDefinitions[letter.utf16Char] = letterDef;
+            added = true;
+        }
+
+        if (added)
+        {
+            _lettersMoved = true;
+        }
+    }
+}
+
+void FontAtlas::retainLetters(const std::u16string& utf16Text)
+{
+    if (_fontFreeType == nullptr)
+    {
+        return;
+    }
+
+    auto frame = SharedDirector.getTotalFrames();
+    for (auto utf16Char : utf16Text)
+    {
+        auto& use = _letterUses[utf16Char];
+        use.refs++;
+        use.lastUsed = frame;
+    }
+}
+
+void FontAtlas::releaseLetters(const std::u16string& utf16Text)
+{
+    if (_fontFreeType == nullptr)
+    {
+        return;
+    }
+
+    // the uses are gone after a reset, the labels release their text all the same
+    auto frame = SharedDirector.getTotalFrames();
+    for (auto utf16Char : utf16Text)
+    {
+        auto it = _letterUses.find(utf16Char);
+        if (it != _letterUses.end() && it->second.refs > 0)
+        {
+            it->second.refs--;
+            it->second.lastUsed = frame;
+        }
+    }
+}
+
+void FontAtlas::setPageSize(int width, int height)
+{
+    CCASSERT(width > 0 && height > 0, "FontAtlas: invalid page size");
+    s_pageWidth = width;
+    s_pageHeight = height;
+}
+
+void FontAtlas::setMaxPages(int maxPages)
+{
+    CCASSERT(maxPages > 0, "FontAtlas: a font atlas needs a page");
+    s_maxPages = maxPages;
+}
+
+bool FontAtlas::reserveLetter(char16_t utf16Char, int width, int height, LetterSlot& slot)
+{
+    // a pixel between the letters keeps the linear filtering from bleeding into the neighbours
+    int paddedWidth = width + 1;
+    int paddedHeight = height + 1;
+    if (paddedWidth > _pageWidth || paddedHeight > _pageHeight)
+    {
+        CCLOG("FontAtlas: a letter of %d x %d doesn't fit in a page of %d x %d.", width, height, _pageWidth, _pageHeight);
+        return false;
+    }
+
+    auto place = [&]() {
+        for (int i = 0; i < static_cast<int>(_pages.size()); ++i)
+        {
+            if (_pages[i]->packer.insert(paddedWidth, paddedHeight, slot.x, slot.y))
+            {
+                slot.page = i;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    bool placed = place();
+    if (!placed && static_cast<int>(_pages.size()) < _maxPages)
+    {
+        addPage();
+        placed = place();
+    }
+    // labels of this frame may already use the letters a repack would move
+    if (!placed && (!_deferredLetters.empty() || findEvictablePage(SharedDirector.getTotalFrames()) >= 0))
+    {
+        _deferredLetters.push_back(utf16Char);
+        return false;
+    }
+    if (!placed)
+    {
+        CCLOG("FontAtlas: the letters of all %d pages are in use, adding a page past the limit.", static_cast<int>(_pages.size()));
+        addPage();
+        placed = place();
+    }
+    if (!placed)
+    {
+        return false;
+    }
+
+    slot.width = width;
+    slot.height = height;
+    _letterSlots[utf16Char] = slot;
+    // letters added this frame aren't held by their label yet
+    _letterUses[utf16Char].lastUsed = SharedDirector.getTotalFrames();
+    markDirty(slot.page, slot.y, slot.y + height);
+    return true;
+}
+
+void FontAtlas::setLetterSlot(FontLetterDefinition& letterDef, const LetterSlot& slot) const
+{
+    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
+    letterDef.U = slot.x / scaleFactor;
+    letterDef.V = slot.y / scaleFactor;
+    letterDef.textureID = slot.page;
+}
+
+void FontAtlas::addPage()
+{
+    int index = static_cast<int>(_pages.size());
+    auto page = new Page(_pageWidth, _pageHeight, _bytesPerPixel);
+    _pages.push_back(page);
+
+    auto tex = new (std::nothrow) Texture2D;
+    if (_antialiasEnabled)
+    {
+        tex->setAntiAliasTexParameters();
     }
     else
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY;
+        tex->setAliasTexParameters();
     }
-    _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, _currentPageOrigY - startY + _currLineHeight);
+    auto pixelFormat = _bytesPerPixel == 2 ? bgfx::TextureFormat::RG8 : bgfx::TextureFormat::R8;
+    tex->initWithData(page->data.data(), page->data.size(),
+        pixelFormat, _pageWidth, _pageHeight, Size(_pageWidth, _pageHeight));
+    addTexture(tex, index);
+    tex->release();
+    // the texture is created without pixels
+    markDirty(index, 0, _pageHeight);
+}
 
+bool FontAtlas::evictLetters()
+{
+    auto frame = SharedDirector.getTotalFrames();
+    int best = findEvictablePage(frame);
+    if (best < 0)
+    {
+        return false;
+    }
+
+    repackPage(best, frame);
     return true;
 }
 
+int FontAtlas::findEvictablePage(uint32_t frame) const
+{
+    std::vector<int> evictableArea(_pages.size(), 0);
+    std::vector<uint32_t> oldestUse(_pages.size(), frame);
+    for (auto&& it : _letterSlots)
+    {
+        if (isEvictable(it.first, frame))
+        {
+            auto& slot = it.second;
+            evictableArea[slot.page] += (slot.width + 1) * (slot.height + 1);
+            auto use = _letterUses.find(it.first);
+            if (use != _letterUses.end())
+            {
+                oldestUse[slot.page] = std::min(oldestUse[slot.page], use->second.lastUsed);
+            }
+        }
+    }
+
+    // the page freeing the most room, the one whose letters went unused the longest for ties
+    int best = -1;
+    for (int i = 0; i < static_cast<int>(_pages.size()); ++i)
+    {
+        if (evictableArea[i] > 0 && (best < 0 || evictableArea[i] > evictableArea[best]
+            || (evictableArea[i] == evictableArea[best] && oldestUse[i] < oldestUse[best])))
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void FontAtlas::repackPage(int index, uint32_t frame)
+{
+    CC_TRACE_SCOPE("FontAtlas::repackPage");
+    auto page = _pages[index];
+    std::vector<unsigned char> oldData(page->data.size(), 0);
+    oldData.swap(page->data);
+    page->packer.reset();
+
+    std::vector<std::pair<char16_t, LetterSlot>> kept;
+    for (auto it = _letterSlots.begin(); it != _letterSlots.end();)
+    {
+        if (it->second.page != index)
+        {
+            ++it;
+        }
+        else if (isEvictable(it->first, frame))
+        {
+            _letterDefinitions.erase(it->first);
+            _letterUses.erase(it->first);
+            it = _letterSlots.erase(it);
+        }
+        else
+        {
+            kept.push_back(*it);
+            ++it;
+        }
+    }
+
+    // the tallest first pack the tightest
+    std::sort(kept.begin(), kept.end(), [](const std::pair<char16_t, LetterSlot>& a, const std::pair<char16_t, LetterSlot>& b) {
+        return a.second.height > b.second.height;
+    });
+    for (auto&& it : kept)
+    {
+        auto& oldSlot = it.second;
+        LetterSlot slot = oldSlot;
+        if (!page->packer.insert(oldSlot.width + 1, oldSlot.height + 1, slot.x, slot.y))
+        {
+            // prepared again the next time a label shows it
+            _letterDefinitions.erase(it.first);
+            _letterSlots.erase(it.first);
+            continue;
+        }
+
+        for (int y = 0; y < slot.height; ++y)
+        {
+            memcpy(page->data.data() + ((slot.y + y) * _pageWidth + slot.x) * _bytesPerPixel,
+                oldData.data() + ((oldSlot.y + y) * _pageWidth + oldSlot.x) * _bytesPerPixel, slot.width * _bytesPerPixel);
+        }
+        _letterSlots[it.first] = slot;
+        auto def = _letterDefinitions.find(it.first);
+        if (def != _letterDefinitions.end())
+        {
+            setLetterSlot(def->second, slot);
+        }
+    }
+
+    markDirty(index, 0, _pageHeight);
+    _lettersMoved = true;
+}
+
+bool FontAtlas::isEvictable(char16_t utf16Char, uint32_t frame) const
+{
+    auto it = _letterUses.find(utf16Char);
+    return it == _letterUses.end() || (it->second.refs <= 0 && it->second.lastUsed != frame);
+}
+
+void FontAtlas::markDirty(int page, int top, int bottom)
+{
+    auto p = _pages[page];
+    p->dirtyTop = std::max(std::min(p->dirtyTop, top), 0);
+    p->dirtyBottom = std::min(std::max(p->dirtyBottom, bottom), _pageHeight);
+}
+
+void FontAtlas::uploadDirtyRows()
+{
+    for (int i = 0; i < static_cast<int>(_pages.size()); ++i)
+    {
+        auto page = _pages[i];
+        if (page->dirtyTop >= page->dirtyBottom)
+        {
+            continue;
+        }
+
+        auto it = _atlasTextures.find(i);
+        if (it != _atlasTextures.end())
+        {
+            it->second->updateWithData(page->data.data() + _pageWidth * page->dirtyTop * _bytesPerPixel,
+                0, page->dirtyTop, _pageWidth, page->dirtyBottom - page->dirtyTop);
+        }
+        page->dirtyTop = _pageHeight;
+        page->dirtyBottom = 0;
+    }
+}
+
 void FontAtlas::addTexture(Texture2D *texture, int slot)
 {
     _atlasTextures[slot] = texture;
@@ -55,8 +55,11 @@ class CC_DLL FontAtlas : public Ref
 public:
     static const int CacheTextureWidth;
     static const int CacheTextureHeight;
+    /** Distance field atlases are rasterized at this size and scaled to the size of each label. */
+    static const float DistanceFieldFontSize;
     static const char* CMD_PURGE_FONTATLAS;
     static const char* CMD_RESET_FONTATLAS;
+    static const char* CMD_UPDATE_FONTATLAS;
     /**
      * @js ctor
      */
@@ -72,6 +75,26 @@ public:
 
     bool prepareLetterDefinitions(const std::u16string& utf16String);
 
+    /** Rasterizes new letters on worker threads instead of in prepareLetterDefinitions.
+     Until their bitmaps are in the atlas the letters only have their advance,
+     CMD_UPDATE_FONTATLAS is dispatched after a frame added some of them.
+     */
+    void setAsyncRasterization(bool async);
+    bool isAsyncRasterization() const { return _rasterizer != nullptr; }
+
+    /** Labels hold the letters of their text, letters no label holds are evicted
+     when all the pages are full. Only FreeType atlases track them.
+     */
+    void retainLetters(const std::u16string& utf16Text);
+    void releaseLetters(const std::u16string& utf16Text);
+
+    /** The size of the pages of the FreeType atlases created afterwards, 512 x 512 by default. */
+    static void setPageSize(int width, int height);
+    /** The pages a FreeType atlas keeps before evicting letters, 4 by default.
+     Letters in use are never evicted, the atlas grows past the limit when all of them are.
+     */
+    static void setMaxPages(int maxPages);
+
     inline const std::unordered_map<ssize_t, SmartPtr<Texture2D>>& getTextures() const{ return _atlasTextures;}
     void  addTexture(Texture2D *texture, int slot);
     float getLineHeight() const { return _lineHeight; }
@@ -103,8 +126,49 @@ public:
      void setAliasTexParameters();
 
 protected:
+    class GlyphRasterizer;
+    struct Page;
+
+    // where a letter is in the pages, in pixels
+    struct LetterSlot
+    {
+        int page;
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    struct LetterUse
+    {
+        int refs;
+        uint32_t lastUsed;
+    };
+
     void reset();
 
+    /** Called between frames, adds the letters rasterized by the workers and uploads the rows changed
+     this frame. Then evicts unused letters when some didn't fit, the labels lay out their text again
+     in the next frame and the repacked page is uploaded with it.
+     */
+    void update();
+    void addRasterizedLetters();
+
+    /** Finds room for a letter in the pages, adding a page when they are full. Returns false for letters
+     larger than a page, and for letters deferred to the eviction in update() when unused letters take room.
+     */
+    bool reserveLetter(char16_t utf16Char, int width, int height, LetterSlot& slot);
+    void setLetterSlot(FontLetterDefinition& letterDef, const LetterSlot& slot) const;
+    void addPage();
+    /** Repacks the page where the unused letters take the most room without them, only between frames. */
+    bool evictLetters();
+    /** The page freeing the most room, -1 when no letter is evictable. */
+    int findEvictablePage(uint32_t frame) const;
+    void repackPage(int index, uint32_t frame);
+    bool isEvictable(char16_t utf16Char, uint32_t frame) const;
+    void markDirty(int page, int top, int bottom);
+    void uploadDirtyRows();
+
     void releaseTextures();
 
     void findNewCharacters(const std::u16string& u16Text, std::unordered_map<unsigned short, unsigned short>& charCodeMap);
@@ -126,18 +190,32 @@ protected:
     void* _iconv;
 
     // Dynamic GlyphCollection related stuff
-    int _currentPage;
-    unsigned char *_currentPageData;
-    int _currentPageDataSize;
-    float _currentPageOrigX;
-    float _currentPageOrigY;
+    std::vector<Page*> _pages;
+    std::unordered_map<char16_t, LetterSlot> _letterSlots;
+    std::unordered_map<char16_t, LetterUse> _letterUses;
+    int _pageWidth;
+    int _pageHeight;
+    int _maxPages;
+    int _bytesPerPixel;
+    // letters moved by a repack, the labels have to lay them out again
+    bool _lettersMoved;
+    // letters left without a quad until update() made room, they are prepared again afterwards
+    std::vector<char16_t> _deferredLetters;
     int _letterPadding;
     int _letterEdgeExtend;
 
     int _fontAscender;
     EventListenerCustom* _rendererRecreatedListener;
+    // retained, Director::reset frees the listeners before it purges the atlases
+    SmartPtr<EventListenerCustom> _afterDrawListener;
+    GlyphRasterizer* _rasterizer;
+    // letters queued before the last reset are dropped
+    uint32_t _generation;
     bool _antialiasEnabled;
-    int _currLineHeight;
+
+    static int s_pageWidth;
+    static int s_pageHeight;
+    static int s_maxPages;
 
     friend class Label;
 };
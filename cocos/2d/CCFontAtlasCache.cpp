@@ -50,15 +50,11 @@ void FontAtlasCache::purgeCachedData()
 FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
 {
     bool useDistanceField = config->distanceFieldEnabled;
-    if(config->outlineSize > 0)
-    {
-        useDistanceField = false;
-    }
 
     char tmp[ATLAS_MAP_KEY_BUFFER];
     if (useDistanceField) {
-        snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "df %.2f %d %s", config->fontSize, config->outlineSize,
-                 config->fontFilePath.c_str());
+        // one atlas per face, labels scale it to their size and draw outlines and glows with shaders
+        snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "df %s", config->fontFilePath.c_str());
     } else {
         snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "%.2f %d %s", config->fontSize, config->outlineSize,
                  config->fontFilePath.c_str());
@@ -69,13 +65,19 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
 
     if ( it == _atlasMap.end() )
     {
-        auto font = FontFreeType::create(config->fontFilePath, config->fontSize, config->glyphs,
-            config->customGlyphs, useDistanceField, config->outlineSize);
+        auto font = useDistanceField
+            ? FontFreeType::create(config->fontFilePath, FontAtlas::DistanceFieldFontSize, config->glyphs, config->customGlyphs, true, 0)
+            : FontFreeType::create(config->fontFilePath, config->fontSize, config->glyphs, config->customGlyphs, false, config->outlineSize);
         if (font)
         {
             auto tempAtlas = font->createFontAtlas();
             if (tempAtlas)
             {
+                if (useDistanceField)
+                {
+                    // distance maps are slow to compute
+                    tempAtlas->setAsyncRasterization(true);
+                }
                 _atlasMap[atlasName] = tempAtlas;
                 return _atlasMap[atlasName];
             }
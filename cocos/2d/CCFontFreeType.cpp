@@ -36,7 +36,7 @@ NS_CC_BEGIN
 
 FT_Library FontFreeType::_FTlibrary;
 bool       FontFreeType::_FTInitialized = false;
-const int  FontFreeType::DistanceMapSpread = 3;
+const int  FontFreeType::DistanceMapSpread = 6;
 
 const char* FontFreeType::_glyphASCII = "\"!#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~¡¢£¤¥¦§¨©ª«¬­®¯°±²³´µ¶·¸¹º»¼½¾¿ÀÁÂÃÄÅÆÇÈÉÊËÌÍÎÏÐÑÒÓÔÕÖ×ØÙÚÛÜÝÞßàáâãäåæçèéêëìíîïðñòóôõö÷øùúûüýþ ";
 const char* FontFreeType::_glyphNEHE = "!\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~ ";
@@ -93,15 +93,21 @@ void FontFreeType::shutdownFreeType()
 
 FT_Library FontFreeType::getFTLibrary()
 {
+    if (_library)
+    {
+        return _library;
+    }
     initFreeType();
     return _FTlibrary;
 }
 
-FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */,int outline /* = 0 */)
-: _fontRef(nullptr)
+FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */,int outline /* = 0 */, FT_Library library /* = nullptr */)
+: _library(library)
+, _fontRef(nullptr)
 , _stroker(nullptr)
 , _distanceFieldEnabled(distanceFieldEnabled)
 , _outlineSize(0.0f)
+, _fontSize(0.0f)
 , _lineHeight(0)
 , _fontAtlas(nullptr)
 , _encoding(FT_ENCODING_UNICODE)
@@ -124,6 +130,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
     FT_Face face;
     // save font name locally
     _fontName = fontName;
+    _fontSize = fontSize;
 
     auto it = s_cacheFontData.find(fontName);
     if (it != s_cacheFontData.end())
@@ -184,7 +191,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 
 FontFreeType::~FontFreeType()
 {
-    if (_FTInitialized)
+    if (_FTInitialized || _library)
     {
         if (_stroker)
         {
@@ -195,6 +202,10 @@ FontFreeType::~FontFreeType()
             FT_Done_Face(_fontRef);
         }
     }
+    if (_library)
+    {
+        FT_Done_FreeType(_library);
+    }
 
     s_cacheFontData[_fontName].referenceCount -= 1;
     if (s_cacheFontData[_fontName].referenceCount == 0)
@@ -203,6 +214,29 @@ FontFreeType::~FontFreeType()
     }
 }
 
+FontFreeType* FontFreeType::createThreadFont() const
+{
+    FT_Library library;
+    if (FT_Init_FreeType(&library))
+    {
+        return nullptr;
+    }
+
+    auto font = new (std::nothrow) FontFreeType(_distanceFieldEnabled, static_cast<int>(_outlineSize / CC_CONTENT_SCALE_FACTOR()), library);
+    if (!font)
+    {
+        FT_Done_FreeType(library);
+        return nullptr;
+    }
+    font->_usedGlyphs = GlyphCollection::DYNAMIC;
+    if (!font->createFontObject(_fontName, _fontSize))
+    {
+        font->release();
+        return nullptr;
+    }
+    return font;
+}
+
 FontAtlas * FontFreeType::createFontAtlas()
 {
     if (_fontAtlas == nullptr)
@@ -251,6 +285,14 @@ int * FontFreeType::getHorizontalKerningForTextUTF16(const std::u16string& text,
 
 int  FontFreeType::getHorizontalKerningForChars(unsigned short firstChar, unsigned short secondChar) const
 {
+    uint32_t pair = (static_cast<uint32_t>(firstChar) << 16) | secondChar;
+    auto it = _kerningPairs.find(pair);
+    if (it != _kerningPairs.end())
+        return it->second;
+
+    int& result = _kerningPairs[pair];
+    result = 0;
+
     // get the ID to the char we need
     int glyphIndex1 = FT_Get_Char_Index(_fontRef, firstChar);
 
@@ -268,7 +310,8 @@ int  FontFreeType::getHorizontalKerningForChars(unsigned short firstChar, unsign
     if (FT_Get_Kerning( _fontRef, glyphIndex1, glyphIndex2,  FT_KERNING_DEFAULT,  &kerning))
         return 0;
 
-    return (static_cast<int>(kerning.x >> 6));
+    result = static_cast<int>(kerning.x >> 6);
+    return result;
 }
 
 int FontFreeType::getFontAscender() const
@@ -407,6 +450,21 @@ unsigned char* FontFreeType::getGlyphBitmap(unsigned short theChar, long &outWid
     }
 }
 
+int FontFreeType::getGlyphAdvance(unsigned short theChar)
+{
+    if (_fontRef == nullptr)
+    {
+        return 0;
+    }
+
+    FT_Int32 flags = _distanceFieldEnabled ? FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT : FT_LOAD_NO_AUTOHINT;
+    if (FT_Load_Char(_fontRef, theChar, flags | FT_LOAD_NO_BITMAP))
+    {
+        return 0;
+    }
+    return static_cast<int>(_fontRef->glyph->metrics.horiAdvance >> 6);
+}
+
 unsigned char * FontFreeType::getGlyphBitmapWithOutline(unsigned short theChar, FT_BBox &bbox)
 {
     unsigned char* ret = nullptr;
@@ -440,7 +498,7 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(unsigned short theChar,
                     params.target = &bmp;
                     params.flags = FT_RASTER_FLAG_AA;
                     FT_Outline_Translate(outline,-bbox.xMin,-bbox.yMin);
-                    FT_Outline_Render(_FTlibrary, outline, &params);
+                    FT_Outline_Render(getFTLibrary(), outline, &params);
 
                     ret = bmp.buffer;
                 }
@@ -533,7 +591,7 @@ unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
     return out;
 }
 
-void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
+void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight, int destWidth)
 {
     int iX = posX;
     int iY = posY;
@@ -559,7 +617,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 dest[index + 2] = out[index2 + 2];*/
 
                 //Single channel 8-bit output
-                dest[iX + ( iY * FontAtlas::CacheTextureWidth )] = distanceMap[bitmap_y + x];
+                dest[iX + ( iY * destWidth )] = distanceMap[bitmap_y + x];
 
                 iX += 1;
             }
@@ -579,9 +637,9 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
             for (int x = 0; x < bitmapWidth; ++x)
             {
                 tempChar = bitmap[(bitmap_y + x) * 2];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2] = tempChar;
                 tempChar = bitmap[(bitmap_y + x) * 2 + 1];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2 + 1] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2 + 1] = tempChar;
 
                 iX += 1;
             }
@@ -602,7 +660,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 unsigned char cTemp = bitmap[bitmap_y + x];
 
                 // the final pixel
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) )] = cTemp;
+                dest[(iX + ( iY * destWidth ) )] = cTemp;
 
                 iX += 1;
             }
@@ -61,7 +61,8 @@ public:
 
     float getOutlineSize() const { return _outlineSize; }
 
-    void renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight);
+    /** Renders a bitmap of getGlyphBitmap to dest, a buffer of destWidth pixels per row. */
+    void renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight, int destWidth);
 
     FT_Encoding getEncoding() const { return _encoding; }
 
@@ -69,6 +70,14 @@ public:
 
     unsigned char* getGlyphBitmap(unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance);
 
+    /** The advance of a glyph without rendering it, 0 if the font can't load it. */
+    int getGlyphAdvance(unsigned short theChar);
+
+    /** Creates a copy of the font with a FreeType library and face of its own,
+     so it can rasterize glyphs on another thread. Create and release it on the main thread.
+     */
+    FontFreeType* createThreadFont() const;
+
     int getFontAscender() const;
 
     const char* getFontFamily() const;
@@ -84,7 +93,7 @@ private:
     static FT_Library _FTlibrary;
     static bool _FTInitialized;
 
-    FontFreeType(bool distanceFieldEnabled = false, int outline = 0);
+    FontFreeType(bool distanceFieldEnabled = false, int outline = 0, FT_Library library = nullptr);
     virtual ~FontFreeType();
 
     bool createFontObject(const std::string &fontName, float fontSize);
@@ -98,15 +107,20 @@ private:
     void setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs = nullptr);
     const char* getGlyphCollection() const;
 
+    // owned by thread fonts, nullptr for those using the shared library
+    FT_Library _library;
     FT_Face _fontRef;
     FT_Stroker _stroker;
     FT_Encoding _encoding;
 
     std::string _fontName;
+    float _fontSize;
     bool _distanceFieldEnabled;
     float _outlineSize;
     int _lineHeight;
     FontAtlas* _fontAtlas;
+    // kerning of the pairs looked up so far, the first char in the high 16 bits
+    mutable std::unordered_map<uint32_t, int> _kerningPairs;
 
     GlyphCollection _usedGlyphs;
     std::string _customGlyphs;
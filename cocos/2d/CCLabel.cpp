@@ -28,6 +28,8 @@
 #include "2d/CCFont.h"
 #include "2d/CCFontAtlasCache.h"
 #include "2d/CCFontAtlas.h"
+#include "2d/CCStringAtlas.h"
+#include "2d/CCFontFreeType.h"
 #include "2d/CCSprite.h"
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCDrawNode.h"
@@ -387,6 +389,7 @@ Label::Label()
 , _horizontalKernings(nullptr)
 , _purgeTextureListener(nullptr)
 , _resetTextureListener(nullptr)
+, _updateTextureListener(nullptr)
 #if CC_LABEL_DEBUG_DRAW
 , _debugDrawNode(nullptr)
 #endif
@@ -458,6 +461,7 @@ Label::Label()
 
             if (_fontAtlas)
             {
+                releaseAtlasLetters();
                 FontAtlasCache::releaseFontAtlas(_fontAtlas);
             }
         }
@@ -467,6 +471,8 @@ Label::Label()
     _resetTextureListener = EventListenerCustom::create(FontAtlas::CMD_RESET_FONTATLAS, [this](EventCustom* event){
         if (_fontAtlas && _currentLabelType == LabelType::TTF && event->getUserData() == _fontAtlas)
         {
+            // reset dropped the uses of the letters, alignText holds them again
+            _atlasLetters.clear();
             _fontAtlas = nullptr;
             this->setTTFConfig(_fontConfig);
             for (auto&& it : _letters)
@@ -476,6 +482,17 @@ Label::Label()
         }
     });
     _eventDispatcher->addEventListenerWithFixedPriority(_resetTextureListener, 2);
+
+    _updateTextureListener = EventListenerCustom::create(FontAtlas::CMD_UPDATE_FONTATLAS, [this](EventCustom* event){
+        // letters rasterized asynchronously got their bitmaps
+        if (_fontAtlas && _currentLabelType == LabelType::TTF && event->getUserData() == _fontAtlas)
+        {
+            // the letters changed size or moved, lay out the whole text again
+            clearLayoutCache();
+            _contentDirty = true;
+        }
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_updateTextureListener, 1);
 }
 
 Label::~Label()
@@ -487,6 +504,7 @@ Label::~Label()
     {
 //        Node::removeAllChildrenWithCleanup(true);
         _batchNodes.clear();
+        releaseAtlasLetters();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
         _fontAtlas = nullptr;
     }
@@ -494,6 +512,8 @@ Label::~Label()
     _purgeTextureListener = nullptr;
     _eventDispatcher->removeEventListener(_resetTextureListener);
     _resetTextureListener = nullptr;
+    _eventDispatcher->removeEventListener(_updateTextureListener);
+    _updateTextureListener = nullptr;
 }
 
 void Label::reset()
@@ -506,8 +526,10 @@ void Label::reset()
     _letters.clear();
     _batchNodes.clear();
     _lettersInfo.clear();
+    clearLayoutCache();
     if (_fontAtlas)
     {
+        releaseAtlasLetters();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
         _fontAtlas = nullptr;
     }
@@ -594,16 +616,24 @@ static Texture2D* _getTexture(Label* label)
 }
 void Label::updateShaderProgram()
 {
+    // glow turns the distance field on, so the effects below never need its programs
+    if (_useDistanceField)
+    {
+        if (_currLabelEffect.isOn(LabelEffect::GLOW))
+            program_ = SharedRenderer.getDistanceFieldGlowProgram();
+        else if (_currLabelEffect.isOn(LabelEffect::OUTLINE))
+            program_ = SharedRenderer.getDistanceFieldOutlineProgram();
+        else
+            program_ = SharedRenderer.getDistanceField();
+        return;
+    }
+
 	if (_currLabelEffect.isOn(LabelEffect::NORMAL))
 	{
-        if (_useDistanceField)
-            program_ = SharedRenderer.getDistanceField();
-        else if (_useA8Shader)
+        if (_useA8Shader)
             program_ = SharedRenderer.getNormalProgram();
-        else if (_currLabelEffect.isOn(LabelEffect::SHADOW))
-            program_ = SharedRenderer.getDefaultProgram();
         else
-            program_ = SharedRenderer.getDefaultProgramMVP();//is this could be used?
+            program_ = SharedRenderer.getDefaultProgramMVP();
 	}
 	else
 	{
@@ -619,13 +649,6 @@ void Label::updateShaderProgram()
 		{
             program_ = SharedRenderer.getGradientProgram();
 		} 
-		else
-		{
-			if (_currLabelEffect.isOn(LabelEffect::GLOW))
-			{
-                program_ = SharedRenderer.getDistanceFieldGlowProgram();
-			}
-		}
 	}
 }
 
@@ -645,11 +668,13 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
     if (_fontAtlas)
     {
         _batchNodes.clear();
+        releaseAtlasLetters();
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
         _fontAtlas = nullptr;
     }
 
     _fontAtlas = atlas;
+    clearLayoutCache();
     if (_reusedLetter == nullptr)
     {
         _reusedLetter = Sprite::create();
@@ -938,6 +963,14 @@ bool Label::alignText()
 
     bool ret = true;
     do {
+        if (_atlasLetters != _utf16Text)
+        {
+            // held before they are prepared so that making room for the new letters doesn't evict them
+            _fontAtlas->retainLetters(_utf16Text);
+            _fontAtlas->releaseLetters(_atlasLetters);
+            _atlasLetters.clear();
+            _atlasLetters.append(_utf16Text);
+        }
         _fontAtlas->prepareLetterDefinitions(_utf16Text);
         auto& textures = _fontAtlas->getTextures();
         if (textures.size() > static_cast<size_t>(_batchNodes.size()))
@@ -963,7 +996,6 @@ bool Label::alignText()
 
         _lengthOfString = 0;
         _textDesiredHeight = 0.f;
-        _linesWidth.clear();
         if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
         {
             multilineTextWrapByWord();
@@ -1165,9 +1197,8 @@ bool Label::setTTFConfigInternal(const TTFConfig& ttfConfig)
 
     _fontConfig = ttfConfig;
 
-    if (_fontConfig.outlineSize > 0)
+    if (_fontConfig.outlineSize > 0 && !_fontConfig.distanceFieldEnabled)
     {
-        _fontConfig.distanceFieldEnabled = false;
         _useDistanceField = false;
         _useA8Shader = false;
         _currLabelEffect.setOff(LabelEffect::NORMAL);
@@ -1177,6 +1208,11 @@ bool Label::setTTFConfigInternal(const TTFConfig& ttfConfig)
     else
     {
         _currLabelEffect.setValue(LabelEffect::NORMAL);
+        if (_fontConfig.outlineSize > 0)
+        {
+            // drawn from the distance field
+            _currLabelEffect.setOn(LabelEffect::OUTLINE);
+        }
         updateShaderProgram();
     }
 
@@ -1330,7 +1366,8 @@ void Label::enableShadow(const Color4B& shadowColor /* = Color4B::BLACK */,const
 
     if (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP)
     {
-        program_ = _currLabelEffect.isOn(LabelEffect::SHADOW) ? SharedRenderer.getDefaultProgramMVP() : SharedRenderer.getDefaultProgram();
+        // the text takes the label transform on the GPU, with or without the shadow
+        program_ = SharedRenderer.getDefaultProgramMVP();
     }
 }
 
@@ -1454,14 +1491,21 @@ void Label::disableEffect(LabelEffect effect)
 	}
 }
 
-void Label::createSpriteForSystemFont(const FontDefinition& fontDef)
+void Label::createSpriteForSystemFont(const FontDefinition& fontDef, StringAtlas::Entry* previous)
 {
     _currentLabelType = LabelType::STRING_TEXTURE;
 
-    auto texture = new (std::nothrow) Texture2D;
-    texture->initWithString(_utf8Text.c_str(), fontDef);
-
-    _textSprite = Sprite::createWithTexture(texture);
+    auto entry = SharedStringAtlas.add(_utf8Text, fontDef, previous);
+    if (entry)
+    {
+        _textSprite = Sprite::createWithTexture(entry->getTexture(), CC_RECT_PIXELS_TO_POINTS(entry->getRect()));
+        // the sprite holds the rect of the atlas
+        _textSprite->setUserObject(entry);
+    }
+    else
+    {
+        _textSprite = Sprite::create();
+    }
     _textSprite->setGlobalZOrder(getGlobalZOrder());
     _textSprite->setAnchorPoint(Vec2::ANCHOR_BOTTOM_LEFT);
 
@@ -1472,7 +1516,6 @@ void Label::createSpriteForSystemFont(const FontDefinition& fontDef)
         this->setContentSize(newSize);
     }
 
-    texture->release();
     if (_blendFuncDirty)
     {
         _textSprite->setBlendFunc(_blendFunc);
@@ -1482,12 +1525,19 @@ void Label::createSpriteForSystemFont(const FontDefinition& fontDef)
     _textSprite->updateDisplayedOpacity(_displayedOpacity);
 }
 
-void Label::createShadowSpriteForSystemFont(const FontDefinition& fontDef)
+void Label::createShadowSpriteForSystemFont(const FontDefinition& fontDef, StringAtlas::Entry* previous)
 {
+    auto textEntry = static_cast<StringAtlas::Entry*>(_textSprite->getUserObject());
+    if (textEntry == nullptr)
+    {
+        return;
+    }
+
     if (!fontDef._stroke._strokeEnabled && fontDef._fontFillColor == _shadowColor3B
         && (fontDef._fontAlpha == _shadowOpacity))
     {
-        _shadowNode = Sprite::createWithTexture(_textSprite->getTexture());
+        _shadowNode = Sprite::createWithTexture(textEntry->getTexture(), CC_RECT_PIXELS_TO_POINTS(textEntry->getRect()));
+        _shadowNode->setUserObject(textEntry);
     }
     else
     {
@@ -1500,10 +1550,12 @@ void Label::createShadowSpriteForSystemFont(const FontDefinition& fontDef)
         shadowFontDefinition._stroke._strokeColor = shadowFontDefinition._fontFillColor;
         shadowFontDefinition._stroke._strokeAlpha = shadowFontDefinition._fontAlpha;
 
-        auto texture = new (std::nothrow) Texture2D;
-        texture->initWithString(_utf8Text.c_str(), shadowFontDefinition);
-        _shadowNode = Sprite::createWithTexture(texture);
-        texture->release();
+        auto entry = SharedStringAtlas.add(_utf8Text, shadowFontDefinition, previous);
+        if (entry)
+        {
+            _shadowNode = Sprite::createWithTexture(entry->getTexture(), CC_RECT_PIXELS_TO_POINTS(entry->getRect()));
+            _shadowNode->setUserObject(entry);
+        }
     }
 
     if (_shadowNode)
@@ -1562,6 +1614,7 @@ void Label::updateContent()
         {
             _batchNodes.clear();
 
+            releaseAtlasLetters();
             FontAtlasCache::releaseFontAtlas(_fontAtlas);
             _fontAtlas = nullptr;
         }
@@ -1569,28 +1622,34 @@ void Label::updateContent()
         _systemFontDirty = false;
     }
 
+    // an unchanged text keeps its atlas rect, a changed one is uploaded into it when it fits
+    SmartPtr<StringAtlas::Entry> textEntry;
+    SmartPtr<StringAtlas::Entry> shadowEntry;
+    if (_textSprite)
+    {
+        textEntry = static_cast<StringAtlas::Entry*>(_textSprite->getUserObject());
+        if (_shadowNode && _shadowNode->getUserObject() != _textSprite->getUserObject())
+        {
+            shadowEntry = static_cast<StringAtlas::Entry*>(_shadowNode->getUserObject());
+        }
+    }
     _textSprite = nullptr;
     _shadowNode = nullptr;
     bool updateFinished = true;
 
     if (_fontAtlas)
     {
-        std::u16string utf16String;
-        if (StringUtils::UTF8ToUTF16(_utf8Text, utf16String))
-        {
-            _utf16Text = utf16String;
-        }
-
+        // setString keeps _utf16Text in step with _utf8Text
         computeHorizontalKernings(_utf16Text);
         updateFinished = alignText();
     }
     else
     {
         auto fontDef = _getFontDefinition();
-        createSpriteForSystemFont(fontDef);
+        createSpriteForSystemFont(fontDef, textEntry);
         if (_currLabelEffect.isOn(LabelEffect::SHADOW))
         {
-            createShadowSpriteForSystemFont(fontDef);
+            createShadowSpriteForSystemFont(fontDef, shadowEntry);
         }
     }
 
@@ -1691,7 +1750,12 @@ void Label::onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor)
     if (_currentLabelType == LabelType::TTF)
     {
         program_->set("u_textColor"_slice, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
-        if (_currLabelEffect.isOn(LabelEffect::OUTLINE) || _currLabelEffect.isOn(LabelEffect::GLOW) || _currLabelEffect.isOn(LabelEffect::GRADIENT))
+        if (_useDistanceField)
+        {
+            program_->set("u_effectColor"_slice, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
+            program_->set("u_effectParams"_slice, getDistanceFieldEffectEdge(), 0.f, 0.f, 0.f);
+        }
+        else if (_currLabelEffect.isOn(LabelEffect::OUTLINE) || _currLabelEffect.isOn(LabelEffect::GLOW) || _currLabelEffect.isOn(LabelEffect::GRADIENT))
         {
             program_->set("u_startColor"_slice, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
             program_->set("u_endColor"_slice, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
@@ -1709,32 +1773,207 @@ void Label::onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor)
             batchNode->getTextureAtlas()->drawQuads(program_, state, &_shadowTransform);
         }
     }
-    else
+}
+
+bool Label::isBatchable() const
+{
+    if (_currentLabelType != LabelType::TTF || _useDistanceField
+        || _currLabelEffect.isOn(LabelEffect::GLOW) || _currLabelEffect.isOn(LabelEffect::GRADIENT))
     {
-        Color3B oldColor = _realColor;
-        GLubyte oldOPacity = _displayedOpacity;
-        _displayedOpacity = shadowColor.a * 255;
-        setColor(Color3B(shadowColor));
+        return false;
+    }
+    if (_currLabelEffect.isOn(LabelEffect::OUTLINE))
+    {
+        // the outline is in the RG8 atlas of the outlined font
+        return _fontConfig.outlineSize > 0;
+    }
+    return _useA8Shader && _currLabelEffect.isOn(LabelEffect::NORMAL);
+}
 
-        uint64_t state = (
-            BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
-            BGFX_STATE_MSAA | _blendFunc.toValue());
-        for (auto&& it : _letters)
+void Label::batchLetterQuads(SpriteProgram* program, uint64_t state, const Mat4& transform, const Color4F& textColor)
+{
+    // letters of a color section have their color in the vertices already and only take the text alpha
+    Color4F sectionColor(1.0f, 1.0f, 1.0f, textColor.a);
+    TextureAtlas* runAtlas = nullptr;
+    const Color4F* runColor = nullptr;
+    ssize_t runStart = 0;
+    ssize_t runCount = 0;
+    for (int ctr = 0; ctr < _lengthOfString; ++ctr)
+    {
+        auto& letterInfo = _lettersInfo[ctr];
+        if (!letterInfo.valid || letterInfo.atlasIndex < 0)
         {
-            it.second->updateTransform();
+            continue;
+        }
+        auto& letterDef = _fontAtlas->_letterDefinitions[letterInfo.utf16Char];
+        TextureAtlas* textureAtlas = _batchNodes.at(letterDef.textureID)->getTextureAtlas();
+        if (letterInfo.atlasIndex >= textureAtlas->getTotalQuads())
+        {
+            continue;
+        }
+        const Color4F* color = letterInfo.colorIndex >= 0 ? &sectionColor : &textColor;
+        if (textureAtlas == runAtlas && color == runColor && letterInfo.atlasIndex == runStart + runCount)
+        {
+            ++runCount;
+            continue;
         }
+        if (runCount > 0)
+        {
+            runAtlas->batchNumberOfQuads(runCount, runStart, program, state, transform, *runColor);
+        }
+        runAtlas = textureAtlas;
+        runColor = color;
+        runStart = letterInfo.atlasIndex;
+        runCount = 1;
+    }
+    if (runCount > 0)
+    {
+        runAtlas->batchNumberOfQuads(runCount, runStart, program, state, transform, *runColor);
+    }
+}
+
+void Label::batchEffectLayer(int layer, uint64_t state, const Mat4& transform, const Color4F& color)
+{
+    static std::vector<V3F_C4B_T2F_Quad> layerQuads;
+    Color4B vertexColor(color);
+    float offset = layer * 2.0f;
+    SpriteProgram* program = SharedRenderer.getLabelEffectProgram();
+    for (auto&& batchNode : _batchNodes)
+    {
+        auto textureAtlas = batchNode->getTextureAtlas();
+        auto count = textureAtlas->getTotalQuads();
+        if (count == 0)
+        {
+            continue;
+        }
+        layerQuads.assign(textureAtlas->getQuads(), textureAtlas->getQuads() + count);
+        for (auto&& quad : layerQuads)
+        {
+            quad.tl.colors = vertexColor;
+            quad.bl.colors = vertexColor;
+            quad.tr.colors = vertexColor;
+            quad.br.colors = vertexColor;
+            quad.tl.texCoords.u += offset;
+            quad.bl.texCoords.u += offset;
+            quad.tr.texCoords.u += offset;
+            quad.br.texCoords.u += offset;
+        }
+        auto texture = textureAtlas->getTexture();
+        SharedRendererManager.setCurrent(SharedRenderer.getTarget());
+        SharedRenderer.push(layerQuads.data(), uint32_t(count), program, texture, state, texture->getFlags(), transform);
+    }
+}
+
+void Label::onDrawBatched(const Mat4& transform)
+{
+    uint64_t state = (
+        BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+        BGFX_STATE_MSAA | _blendFunc.toValue());
+    // outlined text draws its shadow, outline and glyphs as layers of the same batch
+    bool outlined = _currLabelEffect.isOn(LabelEffect::OUTLINE);
+    SpriteProgram* program = outlined ? SharedRenderer.getLabelEffectProgram() : SharedRenderer.getLabelBatchProgram();
+
+    for (auto&& it : _letters)
+    {
+        it.second->updateTransform();
+    }
+
+    if (_currLabelEffect.isOn(LabelEffect::SHADOW))
+    {
+        const Color4F& shadowColor = _currLabelEffect.isOn(LabelEffect::BOLD) ? _textColorF : _shadowColor4F;
+        if (outlined)
+        {
+            Color4F color = shadowColor;
+            color.a *= _displayedOpacity / 255.0f;
+            batchEffectLayer(2, state, _shadowTransform, color);
+        }
+        else
+        {
+            for (auto&& batchNode : _batchNodes)
+            {
+                batchNode->getTextureAtlas()->batchQuads(program, state, _shadowTransform, shadowColor);
+            }
+        }
+    }
+
+    if (outlined)
+    {
+        // updateColor keeps the label opacity in the alpha of _effectColorF
+        batchEffectLayer(1, state, transform, _effectColorF);
+    }
+
+    if (_colorIndexNum.empty())
+    {
         for (auto&& batchNode : _batchNodes)
         {
-            batchNode->getTextureAtlas()->drawQuads(program_, state, &_shadowTransform);
+            batchNode->getTextureAtlas()->batchQuads(program, state, transform, _textColorF);
         }
+    }
+    else
+    {
+        batchLetterQuads(program, state, transform, _textColorF);
+    }
+}
+
+void Label::onDrawBitmapFont(const Mat4& transform)
+{
+    uint64_t state = (
+        BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+        BGFX_STATE_MSAA | _blendFunc.toValue());
 
-        _displayedOpacity = oldOPacity;
-        setColor(oldColor);
+    // only the letters handed out by getLetter have nodes, those not moved return at once
+    for (auto&& it : _letters)
+    {
+        it.second->updateTransform();
+    }
+
+    if (_currLabelEffect.isOn(LabelEffect::SHADOW))
+    {
+        // the quads keep the text color, the shadow goes through a copy in the shadow color
+        static std::vector<V3F_C4B_T2F_Quad> shadowQuads;
+        const Color4F& shadowColor = _currLabelEffect.isOn(LabelEffect::BOLD) ? _textColorF : _shadowColor4F;
+        float alpha = shadowColor.a * _displayedOpacity / 255.0f;
+        float rgbScale = _isOpacityModifyRGB ? alpha : 1.0f;
+        Color4B color(static_cast<GLubyte>(shadowColor.r * rgbScale * 255), static_cast<GLubyte>(shadowColor.g * rgbScale * 255),
+            static_cast<GLubyte>(shadowColor.b * rgbScale * 255), static_cast<GLubyte>(alpha * 255));
+
+        for (auto&& batchNode : _batchNodes)
+        {
+            auto textureAtlas = batchNode->getTextureAtlas();
+            auto count = textureAtlas->getTotalQuads();
+            if (count == 0)
+            {
+                continue;
+            }
+            shadowQuads.assign(textureAtlas->getQuads(), textureAtlas->getQuads() + count);
+            for (auto&& quad : shadowQuads)
+            {
+                quad.tl.colors = color;
+                quad.bl.colors = color;
+                quad.tr.colors = color;
+                quad.br.colors = color;
+            }
+            auto texture = textureAtlas->getTexture();
+            SharedRendererManager.setCurrent(SharedRenderer.getTarget());
+            SharedRenderer.push(shadowQuads.data(), uint32_t(count), SharedRenderer.getDefaultProgram(), texture,
+                state, texture->getFlags(), _shadowTransform);
+        }
+    }
+
+    for (auto&& batchNode : _batchNodes)
+    {
+        batchNode->getTextureAtlas()->drawQuads(program_, state, &transform);
     }
 }
 
 void Label::onDraw(const Mat4& transform, bool transformUpdated)
 {
+    if (isBatchable())
+    {
+        onDrawBatched(transform);
+        return;
+    }
+
     if (_currLabelEffect.isOn(LabelEffect::SHADOW))
     {
         if (_currLabelEffect.isOn(LabelEffect::BOLD))
@@ -1754,7 +1993,14 @@ void Label::onDraw(const Mat4& transform, bool transformUpdated)
 
     if (_currentLabelType == LabelType::TTF)
     {
-		if (_currLabelEffect.isOn(LabelEffect::GRADIENT) && _currLabelEffect.isOn(LabelEffect::OUTLINE))
+        if (_useDistanceField)
+        {
+            // outline and glow come from the same distance field as the text, one pass for all
+            program_->set("u_textColor"_slice, _textColorF.r, _textColorF.g, _textColorF.b, _textColorF.a);
+            program_->set("u_effectColor"_slice, _effectColorF.r, _effectColorF.g, _effectColorF.b, _effectColorF.a);
+            program_->set("u_effectParams"_slice, getDistanceFieldEffectEdge(), 0.f, 0.f, 0.f);
+        }
+		else if (_currLabelEffect.isOn(LabelEffect::GRADIENT) && _currLabelEffect.isOn(LabelEffect::OUTLINE))
 		{
 			//draw text with outline
 			program_->set("u_textColor"_slice,
@@ -1812,34 +2058,13 @@ void Label::onDraw(const Mat4& transform, bool transformUpdated)
 		}
     }
 
-	if(_colorIndexNum.size() > 0)
+	if (_colorIndexNum.size() > 0 && _currentLabelType == LabelType::TTF
+		&& _currLabelEffect.isOn(LabelEffect::OUTLINE) && !_currLabelEffect.isOn(LabelEffect::GRADIENT))
 	{
-        TextureAtlas* textureAtlas = nullptr;
-        for (int ctr = 0; ctr < _lengthOfString; ++ctr)
-        {
-            auto& letterInfo = _lettersInfo[ctr];
-            if (letterInfo.valid && letterInfo.atlasIndex >= 0)
-            {
-                auto& letterDef = _fontAtlas->_letterDefinitions[letterInfo.utf16Char];
-
-                auto batchNode = _batchNodes.at(letterDef.textureID);
-                textureAtlas = batchNode->getTextureAtlas();
-                if (letterInfo.colorIndex >= 0)
-                {
-                    ssize_t count = textureAtlas->getTotalQuads();
-                    if (letterInfo.atlasIndex < count)
-                    {
-                        program_->set("u_textColor"_slice, 1.0f, 1.0f, 1.0f, _textColorF.a);
-                        textureAtlas->drawNumberOfQuads(1, letterInfo.atlasIndex, program_, state, &transform);
-                    }
-                }
-                else
-                {
-                    program_->set("u_textColor"_slice, _textColorF.r, _textColorF.g, _textColorF.b, _textColorF.a);
-                    textureAtlas->drawNumberOfQuads(1, letterInfo.atlasIndex, program_, state, &transform);
-                }
-            }
-        }
+		// the text color goes to the vertices with the section colors, flushed here as the uniforms are shared
+		program_->set("u_textColor"_slice, 1.0f, 1.0f, 1.0f, 1.0f);
+		batchLetterQuads(program_, state, transform, _textColorF);
+		SharedRenderer.render();
 	}
 	else
 	{
@@ -1857,21 +2082,9 @@ void Label::draw(IRenderer *renderer, const Mat4 &transform, uint32_t flags)
         return;
     }
 
-    if (!_currLabelEffect.isOn(LabelEffect::SHADOW) && (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP))
+    if (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP)
     {
-        for (auto&& it : _letters)
-        {
-            it.second->updateTransform();
-        }
-        // ETC1 ALPHA supports for BMFONT & CHARMAP
-        auto textureAtlas = _batchNodes.at(0)->getTextureAtlas();
-        auto texture = textureAtlas->getTexture();
-
-        /*_quadCommand.init(_globalZOrder, texture, getGLProgramState(),
-            _blendFunc, textureAtlas->getQuads(), textureAtlas->getTotalQuads(), transform, flags);
-        renderer->addCommand(&_quadCommand);*/
-        //SharedRenderer.push(textureAtlas->getQuads(), textureAtlas->getTotalQuads(), )
-        CCAssertIf(true, "bmfont or charmap no shadow");
+        onDrawBitmapFont(transform);
     }
     else
     {
@@ -2512,9 +2725,29 @@ Label::Overflow Label::getOverflow()const
     return _overflow;
 }
 
+float Label::getDistanceFieldEffectEdge() const
+{
+    // the distance map stores 128 - 16 per atlas pixel away from the glyph edge
+    float atlasPixels = static_cast<float>(FontFreeType::DistanceMapSpread);
+    if (_currLabelEffect.isOff(LabelEffect::GLOW))
+    {
+        atlasPixels = std::min(_fontConfig.outlineSize * CC_CONTENT_SCALE_FACTOR() / _bmfontScale, atlasPixels);
+    }
+    return 0.5f - atlasPixels * 16.0f / 255.0f;
+}
+
+void Label::releaseAtlasLetters()
+{
+    if (_fontAtlas)
+    {
+        _fontAtlas->releaseLetters(_atlasLetters);
+    }
+    _atlasLetters.clear();
+}
+
 void Label::updateLetterSpriteScale(Sprite* sprite)
 {
-    if (_currentLabelType == LabelType::BMFONT && _bmFontSize > 0)
+    if ((_currentLabelType == LabelType::BMFONT && _bmFontSize > 0) || (_currentLabelType == LabelType::TTF && _useDistanceField))
     {
         sprite->setScale(_bmfontScale);
     }
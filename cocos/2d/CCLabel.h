@@ -28,6 +28,7 @@
 
 #include "2d/CCNode.h"
 #include "2d/CCFontAtlas.h"
+#include "2d/CCStringAtlas.h"
 #include "base/CCProtocols.h"
 
 NS_CC_BEGIN
@@ -70,10 +71,6 @@ typedef struct _ttfConfig
         , underline(useUnderline)
         , strikethrough(useStrikethrough)
     {
-        if(outline > 0)
-        {
-            distanceFieldEnabled = false;
-        }
     }
 } TTFConfig;
 
@@ -651,6 +648,33 @@ protected:
         int colorIndex;
     };
 
+    // the state of multilineTextWrap where a line starts
+    struct LineStart
+    {
+        int index;
+        float nextTokenY;
+        float highestY;
+        float lowestY;
+        float longestLine;
+        bool nextChangeSize;
+    };
+
+    // what the layout depends on besides the text
+    struct LayoutKey
+    {
+        FontAtlas* atlas;
+        float contentScaleFactor;
+        float bmfontScale;
+        float lineHeight;
+        float lineSpacing;
+        float additionalKerning;
+        float maxLineWidth;
+        bool enableWrap;
+        bool wrapByWord;
+
+        bool operator==(const LayoutKey& other) const;
+    };
+
     enum class LabelType : char {
         TTF,
         BMFONT,
@@ -664,11 +688,27 @@ protected:
 
     void onDraw(const Mat4& transform, bool transformUpdated);
     void onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor);
+    /** Plain and outlined TTF labels carry their transform and colors in the vertices,
+    all of them drawing from the same atlas page share one draw call. */
+    bool isBatchable() const;
+    void onDrawBatched(const Mat4& transform);
+    /** Batches the letters in runs, those of color sections keep their vertex color. */
+    void batchLetterQuads(SpriteProgram* program, uint64_t state, const Mat4& transform, const Color4F& textColor);
+    /** Pushes the quads as the outline (1) or shadow (2) layer of LabelEffectProgram, all in color. */
+    void batchEffectLayer(int layer, uint64_t state, const Mat4& transform, const Color4F& color);
+    /** BMFont and CharMap labels draw their atlas quads with the label transform as a sprite batch does. */
+    void onDrawBitmapFont(const Mat4& transform);
     void drawSelf(IRenderer* renderer, uint32_t flags);
 
     bool multilineTextWrapByChar();
     bool multilineTextWrapByWord();
     bool multilineTextWrap(const std::function<int(const std::u16string&, int, int)>& lambda);
+    /** The line of the last layout to lay the text out again from, -1 for the whole text.
+     The state where a line starts depends on the text up to the start of the next one,
+     a line can be resumed when the text changes past that.
+     */
+    int findLayoutResumeLine(const LayoutKey& key) const;
+    void clearLayoutCache();
     void shrinkLabelToContentSize(const std::function<bool(void)>& lambda);
     bool isHorizontalClamp();
     bool isVerticalClamp();
@@ -686,8 +726,9 @@ protected:
 
     bool updateQuads();
 
-    void createSpriteForSystemFont(const FontDefinition& fontDef);
-    void createShadowSpriteForSystemFont(const FontDefinition& fontDef);
+    /** The sprites show rects of SharedStringAtlas, previous is the entry the text had before. */
+    void createSpriteForSystemFont(const FontDefinition& fontDef, StringAtlas::Entry* previous = nullptr);
+    void createShadowSpriteForSystemFont(const FontDefinition& fontDef, StringAtlas::Entry* previous = nullptr);
 
     virtual void updateShaderProgram();
     void updateBMFontScale();
@@ -697,6 +738,10 @@ protected:
     bool isHorizontalClamped(float letterPositionX, int lineInex);
     void restoreFontSize();
     void updateLetterSpriteScale(Sprite* sprite);
+    /** The distance value where the outline or the glow of a distance field label ends. */
+    float getDistanceFieldEffectEdge() const;
+    /** Gives back the letters held in the font atlas, before the atlas is released. */
+    void releaseAtlasLetters();
     int getFirstCharLen(const std::u16string& utf16Text, int startIndex, int textLen);
     int getFirstWordLen(const std::u16string& utf16Text, int startIndex, int textLen);
 
@@ -724,6 +769,12 @@ protected:
     std::unordered_map<int, Sprite*> _letters;
 
     std::u16string _utf16Text;
+    // the text whose letters are held in the font atlas
+    std::u16string _atlasLetters;
+    // the text, the parameters and the line starts of the last layout
+    std::u16string _layoutText;
+    LayoutKey _layoutKey;
+    std::vector<LineStart> _lineStarts;
     std::string _utf8Text;
     std::string _bmFontPath;
     std::string _systemFont;
@@ -735,6 +786,7 @@ protected:
 
     EventListenerCustom* _purgeTextureListener;
     EventListenerCustom* _resetTextureListener;
+    EventListenerCustom* _updateTextureListener;
 
 #if CC_LABEL_DEBUG_DRAW
     DrawNode* _debugDrawNode;
@@ -128,6 +128,8 @@ void Label::updateBMFontScale()
         FontFNT *bmFont = (FontFNT*)font;
         float originalFontSize = bmFont->getOriginalFontSize();
         _bmfontScale = _bmFontSize * CC_CONTENT_SCALE_FACTOR() / originalFontSize;
+    }else if (_currentLabelType == LabelType::TTF && _useDistanceField) {
+        _bmfontScale = _fontConfig.fontSize / FontAtlas::DistanceFieldFontSize;
     }else{
         _bmfontScale = 1.0f;
     }
@@ -149,10 +151,48 @@ bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int
     FontLetterDefinition letterDef;
     Vec2 letterPosition;
     bool nextChangeSize = true;
+    int index = 0;
 
     this->updateBMFontScale();
 
-    for (int index = 0; index < textLen; )
+    LayoutKey key;
+    key.atlas = _fontAtlas;
+    key.contentScaleFactor = contentScaleFactor;
+    key.bmfontScale = _bmfontScale;
+    key.lineHeight = _lineHeight;
+    key.lineSpacing = _lineSpacing;
+    key.additionalKerning = _additionalKerning;
+    key.maxLineWidth = _maxLineWidth;
+    key.enableWrap = _enableWrap;
+    key.wrapByWord = _maxLineWidth > 0.f && !_lineBreakWithoutSpaces;
+
+    int resumeLine = findLayoutResumeLine(key);
+    if (resumeLine >= 0)
+    {
+        // the letters before the line are where they were
+        auto& lineStart = _lineStarts[resumeLine];
+        index = lineStart.index;
+        lineIndex = resumeLine;
+        nextTokenY = lineStart.nextTokenY;
+        highestY = lineStart.highestY;
+        lowestY = lineStart.lowestY;
+        longestLine = lineStart.longestLine;
+        nextChangeSize = lineStart.nextChangeSize;
+        _lineStarts.resize(resumeLine);
+        _linesWidth.resize(resumeLine);
+    }
+    else
+    {
+        _lineStarts.clear();
+        _linesWidth.clear();
+    }
+
+    auto saveLineStart = [&]() {
+        _lineStarts.push_back({index, nextTokenY, highestY, lowestY, longestLine, nextChangeSize});
+    };
+    saveLineStart();
+
+    while (index < textLen)
     {
         auto character = _utf16Text[index];
         if (character == (char16_t)TextFormatter::NewLine)
@@ -164,6 +204,7 @@ bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int
             nextTokenY -= _lineHeight*_bmfontScale + lineSpacing;
             recordPlaceholderInfo(index, character);
             index++;
+            saveLineStart();
             continue;
         }
 
@@ -233,6 +274,7 @@ bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int
 
         if (newLine)
         {
+            saveLineStart();
             continue;
         }
 
@@ -250,6 +292,10 @@ bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int
 
     _linesWidth.push_back(letterRight);
 
+    _layoutKey = key;
+    _layoutText.clear();
+    _layoutText.append(_utf16Text);
+
     _numberOfLines = lineIndex + 1;
     _textDesiredHeight = (_numberOfLines * _lineHeight * _bmfontScale) / contentScaleFactor;
     if (_numberOfLines > 1)
@@ -271,6 +317,57 @@ bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int
     return true;
 }
 
+bool Label::LayoutKey::operator==(const LayoutKey& other) const
+{
+    return atlas == other.atlas
+        && contentScaleFactor == other.contentScaleFactor
+        && bmfontScale == other.bmfontScale
+        && lineHeight == other.lineHeight
+        && lineSpacing == other.lineSpacing
+        && additionalKerning == other.additionalKerning
+        && maxLineWidth == other.maxLineWidth
+        && enableWrap == other.enableWrap
+        && wrapByWord == other.wrapByWord;
+}
+
+int Label::findLayoutResumeLine(const LayoutKey& key) const
+{
+    if (_lineStarts.empty() || !(key == _layoutKey))
+    {
+        return -1;
+    }
+
+    // the first char that changed, past the end when none did
+    size_t changed = 0;
+    size_t common = std::min(_layoutText.length(), _utf16Text.length());
+    while (changed < common && _layoutText[changed] == _utf16Text[changed])
+    {
+        ++changed;
+    }
+    if (changed == common && _layoutText.length() == _utf16Text.length())
+    {
+        changed = common + 1;
+    }
+
+    int line = static_cast<int>(_lineStarts.size()) - 1;
+    while (line >= 0)
+    {
+        size_t nextStart = line + 1 < static_cast<int>(_lineStarts.size()) ? _lineStarts[line + 1].index : _layoutText.length();
+        if (nextStart < changed)
+        {
+            break;
+        }
+        --line;
+    }
+    return line;
+}
+
+void Label::clearLayoutCache()
+{
+    _layoutText.clear();
+    _lineStarts.clear();
+}
+
 bool Label::multilineTextWrapByWord()
 {
     return multilineTextWrap(CC_CALLBACK_3(Label::getFirstWordLen, this));
@@ -361,6 +458,8 @@ void Label::shrinkLabelToContentSize(const std::function<bool(void)>& lambda)
     }
     this->setLineHeight(originalLineHeight);
     std::swap(_fontAtlas->_letterDefinitions, letterDefinition);
+    // laid out with the scaled letters
+    clearLayoutCache();
 
     if (!flag) {
         if (fontSize - i >= 0) {
@@ -29,8 +29,6 @@ THE SOFTWARE.
 #include "ccHeader.h"
 #include "2d/CCNode.h"
 
-#include <regex>
-
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
 #include "base/CCEventDispatcher.h"
@@ -38,6 +36,9 @@ THE SOFTWARE.
 #include "2d/CCAction.h"
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
+#include "2d/CCTransformSystem.h"
+#include "2d/CCNodeIndex.h"
+#include "2d/CCNodeQuery.h"
 #include "2d/CCComponent.h"
 #include "2d/CCComponentContainer.h"
 #include "renderer/Renderer.h"
@@ -58,6 +59,7 @@ NS_CC_BEGIN
 
 // FIXME:: Yes, nodes might have a sort problem once every 30 days if the game runs at 60 FPS and each frame sprites are reordered.
 uint32_t Node::s_globalOrderOfArrival = 0;
+std::atomic<uint32_t> Node::s_transformVersion(0);
 
 // MARK: Constructor, Destructor, Init
 
@@ -80,6 +82,11 @@ Node::Node()
 , _contentSizeDirty(true)
 , _additionalTransform(nullptr)
 , _additionalTransformDirty(false)
+, _affineTransform(false)
+, _transformVersion(0)
+, _worldTransformCache(nullptr)
+, _modelViewStamp(0)
+, _hitTestCount(0)
 , _cullingDirty(true)
 // children (lazy allocs)
 // lazy alloc
@@ -91,6 +98,7 @@ Node::Node()
 , _tag(Node::INVALID_TAG)
 , _name("")
 , _hashOfName(0)
+, _nodeIndex(nullptr)
 // userData is always inited as nil
 , _userData(nullptr)
 , _userObject(nullptr)
@@ -173,6 +181,7 @@ Node::~Node()
     CCASSERT(flags_.isOff(Node::Running), "Node still marked as running on node destruction! Was base class onExit() called in derived class onExit() implementations?");
 
     delete[] _additionalTransform;
+    delete _worldTransformCache;
 }
 
 bool Node::init()
@@ -196,6 +205,10 @@ void Node::cleanup()
 
     // actions
     this->stopAllActions();
+    if (flags_.isOn(Tweening))
+    {
+        _director->getTweenSystem()->stopAllForNode(this);
+    }
     // timers
     this->unscheduleAllCallbacks();
     // Event listeners
@@ -591,8 +604,21 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node * parent)
 {
+    if (_hitTestCount > 0)
+    {
+        if (_parent)
+        {
+            _parent->addHitTestCount(-_hitTestCount);
+        }
+        if (parent)
+        {
+            parent->addHitTestCount(_hitTestCount);
+        }
+        invalidateHitSubtree();
+    }
     _parent = parent;
     markDirty();
+    TransformSystem::invalidate();
 }
 
 /// isRelativeAnchorPoint getter
@@ -619,7 +645,12 @@ int32_t Node::getTag() const
 /// tag setter
 void Node::setTag(int32_t tag)
 {
+    int32_t oldTag = _tag;
     _tag = tag ;
+    if (_nodeIndex && _parent)
+    {
+        _nodeIndex->retag(this, oldTag);
+    }
 }
 
 const std::string& Node::getName() const
@@ -629,9 +660,14 @@ const std::string& Node::getName() const
 
 void Node::setName(const std::string& name)
 {
+    size_t oldHash = _hashOfName;
     _name = name;
     std::hash<std::string> h;
     _hashOfName = h(name);
+    if (_nodeIndex && _parent)
+    {
+        _nodeIndex->rename(this, oldHash);
+    }
 }
 
 /// userData setter
@@ -688,6 +724,10 @@ Node* Node::getChildByTag(int32_t tag) const
 {
     CCASSERT(tag != Node::INVALID_TAG, "Invalid tag");
 
+    if (_nodeIndex)
+    {
+        return _nodeIndex->getChildByTag(this, tag);
+    }
     for (const auto child : _children)
     {
         if(child && child->_tag == tag)
@@ -704,6 +744,10 @@ Node* Node::getChildByName(const std::string& name) const
     std::hash<std::string> h;
     size_t hash = h(name);
 
+    if (_nodeIndex)
+    {
+        return _nodeIndex->getChildByName(this, name, hash);
+    }
     for (const auto& child : _children)
     {
         // Different strings may have the same hash code, but can use it to compare first for speed
@@ -718,114 +762,7 @@ void Node::enumerateChildren(const std::string &name, std::function<bool (Node *
     CCASSERT(!name.empty(), "Invalid name");
     CCASSERT(callback != nullptr, "Invalid callback function");
 
-    size_t length = name.length();
-
-    size_t subStrStartPos = 0;  // sub string start index
-    size_t subStrlength = length; // sub string length
-
-    // Starts with '//'?
-    bool searchRecursively = false;
-    if (length > 2 && name[0] == '/' && name[1] == '/')
-    {
-        searchRecursively = true;
-        subStrStartPos = 2;
-        subStrlength -= 2;
-    }
-
-    // End with '/..'?
-    bool searchFromParent = false;
-    if (length > 3 &&
-        name[length-3] == '/' &&
-        name[length-2] == '.' &&
-        name[length-1] == '.')
-    {
-        searchFromParent = true;
-        subStrlength -= 3;
-    }
-
-    // Remove '//', '/..' if exist
-    std::string newName = name.substr(subStrStartPos, subStrlength);
-
-    if (searchFromParent)
-    {
-        newName.insert(0, "[[:alnum:]]+/");
-    }
-
-
-    if (searchRecursively)
-    {
-        // name is '//xxx'
-        doEnumerateRecursive(this, newName, callback);
-    }
-    else
-    {
-        // name is xxx
-        doEnumerate(newName, callback);
-    }
-}
-
-bool Node::doEnumerateRecursive(const Node* node, const std::string &name, std::function<bool (Node *)> callback) const
-{
-    bool ret =false;
-
-    if (node->doEnumerate(name, callback))
-    {
-        // search itself
-        ret = true;
-    }
-    else
-    {
-        // search its children
-        for (const auto& child : node->getChildren())
-        {
-            if (doEnumerateRecursive(child, name, callback))
-            {
-                ret = true;
-                break;
-            }
-        }
-    }
-
-    return ret;
-}
-
-bool Node::doEnumerate(std::string name, std::function<bool (Node *)> callback) const
-{
-    // name may be xxx/yyy, should find its parent
-    size_t pos = name.find('/');
-    std::string searchName = name;
-    bool needRecursive = false;
-    if (pos != name.npos)
-    {
-        searchName = name.substr(0, pos);
-        name.erase(0, pos+1);
-        needRecursive = true;
-    }
-
-    bool ret = false;
-    for (const auto& child : getChildren())
-    {
-        if (std::regex_match(child->_name, std::regex(searchName)))
-        {
-            if (!needRecursive)
-            {
-                // terminate enumeration if callback return true
-                if (callback(child))
-                {
-                    ret = true;
-                    break;
-                }
-            }
-            else
-            {
-                ret = child->doEnumerate(name, callback);
-                if (ret)
-                    break;
-            }
-        }
-    }
-
-    return ret;
+    NodeQuery(name).enumerate(this, callback);
 }
 
 /* "add" logic MUST only be on this method
@@ -897,6 +834,10 @@ void Node::insertChildBefore(Node* child, Node* relativeChild)
     }
 
     child->setParent(this);
+    if (_nodeIndex)
+    {
+        _nodeIndex->add(child);
+    }
     postInsertChild(child);
 }
 
@@ -923,6 +864,10 @@ void Node::addChildHelper(Node* child, int32_t localZOrder, int32_t tag, const s
         child->setName(name);
 
     child->setParent(this);
+    if (_nodeIndex)
+    {
+        _nodeIndex->add(child);
+    }
     child->updateOrderOfArrival();
 
     postInsertChild(child);
@@ -1059,6 +1004,10 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
             sEngine->releaseScriptObject(this, child);
         }
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
+        if (_nodeIndex)
+        {
+            _nodeIndex->remove(child);
+        }
         // set parent nullptr at the end
         child->setParent(nullptr);
     }
@@ -1091,6 +1040,10 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
         sEngine->releaseScriptObject(this, child);
     }
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
+    if (_nodeIndex)
+    {
+        _nodeIndex->remove(child);
+    }
     // set parent nil at the end
     child->setParent(nullptr);
 
@@ -1150,23 +1103,30 @@ void Node::visit()
     visit(renderer, _modelViewTransform, true);
 }
 
+void Node::updateNormalizedPosition(bool parentContentSizeDirty)
+{
+    CCASSERT(_parent, "setNormalizedPosition() doesn't work with orphan nodes");
+    if (parentContentSizeDirty || _normalizedPositionDirty)
+    {
+        auto& s = _parent->getContentSize();
+        _position.x = _normalizedPosition.x * s.width;
+        _position.y = _normalizedPosition.y * s.height;
+        markDirty();
+        _normalizedPositionDirty = false;
+    }
+}
+
 uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
 {
     if(_usingNormalizedPosition)
     {
-        CCASSERT(_parent, "setNormalizedPosition() doesn't work with orphan nodes");
-        if ((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) || _normalizedPositionDirty)
-        {
-            auto& s = _parent->getContentSize();
-            _position.x = _normalizedPosition.x * s.width;
-            _position.y = _normalizedPosition.y * s.height;
-            markDirty();
-            _normalizedPositionDirty = false;
-        }
+        updateNormalizedPosition((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) != 0);
     }
 
+    // changed since the last TransformSystem update, e.g. by a layout or by updateContent in a visit before ours
+    bool stale = flags_.isOn(Node::TransformDirty | Node::WorldDirty);
     uint32_t flags = parentFlags;
-    flags |= (flags_.isOn(Node::WorldDirty) ? FLAGS_TRANSFORM_DIRTY : 0);
+    flags |= (flags_.isOn(Node::WorldDirty | Node::WorldComputed) ? FLAGS_TRANSFORM_DIRTY : 0);
     flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
     flags |= (_cullingDirty ? FLAGS_CULLING_DIRTY : 0);
 
@@ -1177,13 +1137,26 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
         {
             flags_.setOn(Node::WorldDirty);
             //_modelViewTransform = this->transform(transformTarget_->getNodeToParentTransform());
-            _modelViewTransform = this->transform(parentTransform);
         }
-        else
-            _modelViewTransform = this->transform(parentTransform);
+        // a TransformSystem has already computed it this frame if our parent visits us with its own transform from the same update
+        bool computed = !stale && _modelViewStamp != 0 && _modelViewStamp == TransformSystem::getStamp()
+            && _parent && _parent->_modelViewStamp == _modelViewStamp && &parentTransform == &_parent->_modelViewTransform;
+        if (!computed)
+        {
+            Mat4 modelView = this->transform(parentTransform);
+            if (_modelViewStamp != 0 && memcmp(modelView.m, _modelViewTransform.m, sizeof(modelView.m)) != 0)
+            {
+                _modelViewStamp = 0;
+            }
+            _modelViewTransform = modelView;
+        }
+        if (flags_.isOn(Node::HitTestIndexed))
+        {
+            _eventDispatcher->invalidateHitBounds(this);
+        }
     }
 
-    flags_.setOff(Node::WorldDirty);
+    flags_.setOff(Node::WorldDirty | Node::WorldComputed);
     _contentSizeDirty = false;
     _cullingDirty = false;
 
@@ -1203,6 +1176,8 @@ void Node::visit(IRenderer* renderer, const Mat4 &parentTransform, uint32_t pare
         return;
     }
 
+    CC_TRACE_SCOPE("Node::visit");
+
     if (_beforeVisitCallback && *_beforeVisitCallback) {
         //(*_beforeVisitCallback)(renderer);
     }
@@ -1259,7 +1234,13 @@ void Node::visit(IRenderer* renderer, const Mat4 &parentTransform, uint32_t pare
 
 Mat4 Node::transform(const Mat4& parentTransform)
 {
-    return parentTransform * this->getNodeToParentTransform();
+    const Mat4& local = this->getNodeToParentTransform();
+    Mat4 ret;
+    if (_affineTransform)
+        Mat4::multiplyAffine(parentTransform, local, &ret);
+    else
+        Mat4::multiply(parentTransform, local, &ret);
+    return ret;
 }
 
 // MARK: events
@@ -1634,7 +1615,8 @@ AffineTransform Node::getNodeToParentAffineTransform(Node* ancestor) const
 }
 const Mat4& Node::getNodeToParentTransform() const
 {
-    if (flags_.isOn(Node::TransformDirty))
+    bool changed = flags_.isOn(Node::TransformDirty);
+    if (changed)
     {
         // Translate values
         float x = _position.x;
@@ -1659,75 +1641,120 @@ const Mat4& Node::getNodeToParentTransform() const
             y += -anchorPoint.y;
         }
 
-        // Build Transform Matrix = translation * rotation * scale
-        Mat4 translation;
-        //move to anchor point first, then rotate
-        Mat4::createTranslation(x + anchorPoint.x, y + anchorPoint.y, z, &translation);
-
-        Mat4::createRotation(_rotationQuat, &_transform);
-
-        if (_rotationZ_X != _rotationZ_Y)
+        _affineTransform = (_rotationX == 0.f && _rotationY == 0.f);
+        if (_affineTransform)
         {
-            // Rotation values
-            // Change rotation code to handle X and Y
-            // If we skew with the exact same value for both x and y then we're simply just rotating
-            float radiansX = -CC_DEGREES_TO_RADIANS(_rotationZ_X);
-            float radiansY = -CC_DEGREES_TO_RADIANS(_rotationZ_Y);
-            float cx = cosf(radiansX);
-            float sx = sinf(radiansX);
-            float cy = cosf(radiansY);
-            float sy = sinf(radiansY);
-
-            float m0 = _transform.m[0], m1 = _transform.m[1], m4 = _transform.m[4], m5 = _transform.m[5], m8 = _transform.m[8], m9 = _transform.m[9];
-            _transform.m[0] = cy * m0 - sx * m1, _transform.m[4] = cy * m4 - sx * m5, _transform.m[8] = cy * m8 - sx * m9;
-            _transform.m[1] = sy * m0 + cx * m1, _transform.m[5] = sy * m4 + cx * m5, _transform.m[9] = sy * m8 + cx * m9;
-        }
-        _transform = translation * _transform;
-        //move by (-anchorPoint.x, -anchorPoint.y, 0) after rotation
-        _transform.translate(-anchorPoint.x, -anchorPoint.y, 0);
+            // flat node, fill the 2D terms directly instead of going through the quaternion
+            float cx = 1.f, sx = 0.f, cy = 1.f, sy = 0.f;
+            if (_rotationZ_X || _rotationZ_Y)
+            {
+                float radiansX = -CC_DEGREES_TO_RADIANS(_rotationZ_X);
+                float radiansY = -CC_DEGREES_TO_RADIANS(_rotationZ_Y);
+                cx = cosf(radiansX);
+                sx = sinf(radiansX);
+                cy = cosf(radiansY);
+                sy = sinf(radiansY);
+            }
 
+            // translation * rotation * translation(-anchorPoint) * scale
+            float a = cy * _scaleX, b = sy * _scaleX;
+            float c = -sx * _scaleY, d = cx * _scaleY;
+            float tx = x + anchorPoint.x - cy * anchorPoint.x + sx * anchorPoint.y;
+            float ty = y + anchorPoint.y - sy * anchorPoint.x - cx * anchorPoint.y;
 
-        if (_scaleX != 1.f)
-        {
-            _transform.m[0] *= _scaleX, _transform.m[1] *= _scaleX, _transform.m[2] *= _scaleX;
-        }
-        if (_scaleY != 1.f)
-        {
-            _transform.m[4] *= _scaleY, _transform.m[5] *= _scaleY, _transform.m[6] *= _scaleY;
+            if (needsSkewMatrix)
+            {
+                float skewX = tanf(CC_DEGREES_TO_RADIANS(_skewX));
+                float skewY = tanf(CC_DEGREES_TO_RADIANS(_skewY));
+                float a0 = a, b0 = b;
+                a += c * skewY, b += d * skewY;
+                c += a0 * skewX, d += b0 * skewX;
+
+                // adjust anchor point
+                tx -= a * _anchorPointInPoints.x + c * _anchorPointInPoints.y;
+                ty -= b * _anchorPointInPoints.x + d * _anchorPointInPoints.y;
+            }
+
+            float* m = _transform.m;
+            m[0] = a,   m[1] = b,   m[2] = 0.f,  m[3] = 0.f;
+            m[4] = c,   m[5] = d,   m[6] = 0.f,  m[7] = 0.f;
+            m[8] = 0.f, m[9] = 0.f, m[10] = _scaleZ, m[11] = 0.f;
+            m[12] = tx, m[13] = ty, m[14] = z,   m[15] = 1.f;
         }
-        if (_scaleZ != 1.f)
+        else
         {
-            _transform.m[8] *= _scaleZ, _transform.m[9] *= _scaleZ, _transform.m[10] *= _scaleZ;
-        }
+            // Build Transform Matrix = translation * rotation * scale
+            Mat4 translation;
+            //move to anchor point first, then rotate
+            Mat4::createTranslation(x + anchorPoint.x, y + anchorPoint.y, z, &translation);
 
-        // FIXME:: Try to inline skew
-        // If skew is needed, apply skew and then anchor point
-        if (needsSkewMatrix)
-        {
-            float skewMatArray[16] =
+            Mat4::createRotation(_rotationQuat, &_transform);
+
+            if (_rotationZ_X != _rotationZ_Y)
             {
-                1, (float)tanf(CC_DEGREES_TO_RADIANS(_skewY)), 0, 0,
-                (float)tanf(CC_DEGREES_TO_RADIANS(_skewX)), 1, 0, 0,
-                0,  0,  1, 0,
-                0,  0,  0, 1
-            };
-            Mat4 skewMatrix(skewMatArray);
+                // Rotation values
+                // Change rotation code to handle X and Y
+                // If we skew with the exact same value for both x and y then we're simply just rotating
+                float radiansX = -CC_DEGREES_TO_RADIANS(_rotationZ_X);
+                float radiansY = -CC_DEGREES_TO_RADIANS(_rotationZ_Y);
+                float cx = cosf(radiansX);
+                float sx = sinf(radiansX);
+                float cy = cosf(radiansY);
+                float sy = sinf(radiansY);
+
+                float m0 = _transform.m[0], m1 = _transform.m[1], m4 = _transform.m[4], m5 = _transform.m[5], m8 = _transform.m[8], m9 = _transform.m[9];
+                _transform.m[0] = cy * m0 - sx * m1, _transform.m[4] = cy * m4 - sx * m5, _transform.m[8] = cy * m8 - sx * m9;
+                _transform.m[1] = sy * m0 + cx * m1, _transform.m[5] = sy * m4 + cx * m5, _transform.m[9] = sy * m8 + cx * m9;
+            }
+            _transform = translation * _transform;
+            //move by (-anchorPoint.x, -anchorPoint.y, 0) after rotation
+            _transform.translate(-anchorPoint.x, -anchorPoint.y, 0);
 
-            _transform = _transform * skewMatrix;
 
-            // adjust anchor point
-            if (!_anchorPointInPoints.isZero())
+            if (_scaleX != 1.f)
             {
-                // FIXME:: Argh, Mat4 needs a "translate" method.
-                // FIXME:: Although this is faster than multiplying a vec4 * mat4
-                _transform.m[12] += _transform.m[0] * -_anchorPointInPoints.x + _transform.m[4] * -_anchorPointInPoints.y;
-                _transform.m[13] += _transform.m[1] * -_anchorPointInPoints.x + _transform.m[5] * -_anchorPointInPoints.y;
+                _transform.m[0] *= _scaleX, _transform.m[1] *= _scaleX, _transform.m[2] *= _scaleX;
+            }
+            if (_scaleY != 1.f)
+            {
+                _transform.m[4] *= _scaleY, _transform.m[5] *= _scaleY, _transform.m[6] *= _scaleY;
+            }
+            if (_scaleZ != 1.f)
+            {
+                _transform.m[8] *= _scaleZ, _transform.m[9] *= _scaleZ, _transform.m[10] *= _scaleZ;
+            }
+
+            // FIXME:: Try to inline skew
+            // If skew is needed, apply skew and then anchor point
+            if (needsSkewMatrix)
+            {
+                float skewMatArray[16] =
+                {
+                    1, (float)tanf(CC_DEGREES_TO_RADIANS(_skewY)), 0, 0,
+                    (float)tanf(CC_DEGREES_TO_RADIANS(_skewX)), 1, 0, 0,
+                    0,  0,  1, 0,
+                    0,  0,  0, 1
+                };
+                Mat4 skewMatrix(skewMatArray);
+
+                _transform = _transform * skewMatrix;
+
+                // adjust anchor point
+                if (!_anchorPointInPoints.isZero())
+                {
+                    // FIXME:: Argh, Mat4 needs a "translate" method.
+                    // FIXME:: Although this is faster than multiplying a vec4 * mat4
+                    _transform.m[12] += _transform.m[0] * -_anchorPointInPoints.x + _transform.m[4] * -_anchorPointInPoints.y;
+                    _transform.m[13] += _transform.m[1] * -_anchorPointInPoints.x + _transform.m[5] * -_anchorPointInPoints.y;
+                }
             }
         }
     }
 
     if (_additionalTransform)
     {
+        _affineTransform = false;
+
         // This is needed to support both Node::setNodeToParentTransform() and Node::setAdditionalTransform()
         // at the same time. The scenario is this:
         // at some point setNodeToParentTransform() is called.
@@ -1738,9 +1765,16 @@ const Mat4& Node::getNodeToParentTransform() const
             _additionalTransform[1] = _transform;
 
         if (flags_.isOn(Node::WorldDirty))
+        {
             _transform = _additionalTransform[1] * _additionalTransform[0];
+            changed = true;
+        }
     }
 
+    if (changed)
+    {
+        _transformVersion = nextTransformVersion();
+    }
     flags_.setOff(Node::TransformDirty);
     _additionalTransformDirty = false;
 
@@ -1750,8 +1784,14 @@ const Mat4& Node::getNodeToParentTransform() const
 void Node::setNodeToParentTransform(const Mat4& transform)
 {
     _transform = transform;
+    _affineTransform = false;
+    _transformVersion = nextTransformVersion();
     flags_.setOff(Node::TransformDirty);
     flags_.setOn(Node::WorldDirty);
+    if (_hitTestCount > 0)
+    {
+        invalidateHitSubtree();
+    }
 
     if (_additionalTransform)
         // _additionalTransform[1] has a copy of lastest transform
@@ -1819,7 +1859,58 @@ AffineTransform Node::getNodeToWorldAffineTransform() const
 
 Mat4 Node::getNodeToWorldTransform() const
 {
-    return this->getNodeToParentTransform(nullptr);
+    return updateWorldTransformCache()->world;
+}
+
+Node::WorldTransformCache* Node::updateWorldTransformCache() const
+{
+    const Mat4& local = getNodeToParentTransform();
+    WorldTransformCache* parentCache = _parent ? _parent->updateWorldTransformCache() : nullptr;
+    uint32_t parentVersion = parentCache ? parentCache->version : 0;
+
+    if (!_worldTransformCache)
+    {
+        _worldTransformCache = new WorldTransformCache();
+        _worldTransformCache->version = 0;
+    }
+    WorldTransformCache* cache = _worldTransformCache;
+    if (cache->version == 0 || cache->localVersion != _transformVersion || cache->parentVersion != parentVersion)
+    {
+        if (!parentCache)
+        {
+            cache->world = local;
+        }
+        else if (_affineTransform)
+        {
+            Mat4::multiplyAffine(parentCache->world, local, &cache->world);
+        }
+        else
+        {
+            Mat4::multiply(parentCache->world, local, &cache->world);
+        }
+        cache->affine = _affineTransform && (!parentCache || parentCache->affine);
+        cache->inverseValid = false;
+        cache->localVersion = _transformVersion;
+        cache->parentVersion = parentVersion;
+        cache->version = nextTransformVersion();
+    }
+    return cache;
+}
+
+const Mat4& Node::getCachedWorldToNodeTransform() const
+{
+    WorldTransformCache* cache = updateWorldTransformCache();
+    if (!cache->inverseValid)
+    {
+        cache->inverse = cache->world;
+        // a singular matrix is kept as it is, as getInversed does
+        if (!(cache->affine && cache->inverse.inverseAffine()))
+        {
+            cache->inverse = cache->world.getInversed();
+        }
+        cache->inverseValid = true;
+    }
+    return cache->inverse;
 }
 
 AffineTransform Node::getWorldToNodeAffineTransform() const
@@ -1829,13 +1920,13 @@ AffineTransform Node::getWorldToNodeAffineTransform() const
 
 Mat4 Node::getWorldToNodeTransform() const
 {
-    return getNodeToWorldTransform().getInversed();
+    return getCachedWorldToNodeTransform();
 }
 
 
 Vec2 Node::convertToNodeSpace(const Vec2& worldPoint) const
 {
-    Mat4 tmp = getWorldToNodeTransform();
+    const Mat4& tmp = getCachedWorldToNodeTransform();
     Vec3 vec3(worldPoint.x, worldPoint.y, 0);
     Vec3 ret;
     tmp.transformPoint(vec3,&ret);
@@ -1844,7 +1935,7 @@ Vec2 Node::convertToNodeSpace(const Vec2& worldPoint) const
 
 Vec2 Node::convertToWorldSpace(const Vec2& nodePoint) const
 {
-    Mat4 tmp = getNodeToWorldTransform();
+    const Mat4& tmp = updateWorldTransformCache()->world;
     Vec3 vec3(nodePoint.x, nodePoint.y, 0);
     Vec3 ret;
     tmp.transformPoint(vec3,&ret);
@@ -2108,8 +2199,36 @@ void Node::markCullingDirty()
 
 void Node::markDirty()
 {
+    // once until the transform is computed again, computing a world transform clears it on every ancestor
+    if (_hitTestCount > 0 && flags_.isOff(Node::TransformDirty))
+    {
+        invalidateHitSubtree();
+    }
     flags_.setOn(Node::TransformDirty | Node::WorldDirty);
 }
 
+void Node::addHitTestCount(int32_t delta)
+{
+    for (Node* node = this; node; node = node->_parent)
+    {
+        node->_hitTestCount += delta;
+    }
+}
+
+void Node::invalidateHitSubtree()
+{
+    if (flags_.isOn(Node::HitTestIndexed))
+    {
+        _eventDispatcher->invalidateHitBounds(this);
+    }
+    for (Node* child : _children)
+    {
+        if (child->_hitTestCount > 0)
+        {
+            child->invalidateHitSubtree();
+        }
+    }
+}
+
 NS_CC_END
 
@@ -30,6 +30,7 @@
 
 #include "base/CCVector.h"
 #include "math/CCAffineTransform.h"
+#include <atomic>
 
 NS_CC_BEGIN
 
@@ -46,6 +47,7 @@ class Scene;
 class IRenderer;
 class Director;
 class Material;
+class NodeIndex;
 
 /**
  * @addtogroup _2d
@@ -93,6 +95,7 @@ class EventListener;
 
 class CC_DLL Node : public Ref
 {
+    CC_SLAB_ALLOCATED
 public:
     /** Default tag used for all the nodes */
     static const int INVALID_TAG = -1;
@@ -705,6 +708,7 @@ public:
     /** Search the children of the receiving node to perform processing for nodes which share a name.
      *
      * @param name The name to search for, supports c++11 regular expression.
+     * Plain names and simple expressions are matched without std::regex, see NodeQuery.
      * Search syntax options:
      * `//`: Can only be placed at the begin of the search string. This indicates that it will search recursively.
      * `..`: The search should move up to the node's parent. Can only be placed at the end of string.
@@ -1748,6 +1752,11 @@ protected:
 
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
+    void updateNormalizedPosition(bool parentContentSizeDirty);
+    /// Adds delta to the hit test count of this node and its ancestors.
+    void addHitTestCount(int32_t delta);
+    /// The hit bounds of the nodes in the HitTestGrid under this node are out of date.
+    void invalidateHitSubtree();
 
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
@@ -1755,9 +1764,6 @@ protected:
     virtual void disableCascadeColor();
     virtual void updateColor() {}
 
-    bool doEnumerate(std::string name, std::function<bool (Node *)> callback) const;
-    bool doEnumerateRecursive(const Node* node, const std::string &name, std::function<bool (Node *)> callback) const;
-
     //check whether this camera mask is visible by the current visiting camera
     bool isVisitableByVisitingCamera() const;
 
@@ -1767,12 +1773,43 @@ protected:
     void updateRotation3D();
 
 private:
+    friend class TransformSystem;
+    friend class NodeIndex;
+    friend class NodeQuery;
+    friend class TweenSystem;
+    friend class HitTestGrid;
     void addChildHelper(Node* child, int32_t localZOrder, int32_t tag, const std::string &name, bool setTag);
     void postInsertChild(Node* child);
 
+    // world transform of the last query, recomputed when the node or an ancestor changed since
+    struct WorldTransformCache
+    {
+        Mat4 world;
+        Mat4 inverse;
+        uint32_t version;       ///< changes whenever world changes, unique among all nodes
+        uint32_t parentVersion; ///< version of the parent's world used, 0 without parent
+        uint32_t localVersion;  ///< _transformVersion used
+        bool affine;            ///< whether all the transforms up to the root are 2D affine
+        bool inverseValid;
+    };
+    WorldTransformCache* updateWorldTransformCache() const;
+    const Mat4& getCachedWorldToNodeTransform() const;
+    /** Never 0, safe to call from any thread. */
+    static inline uint32_t nextTransformVersion()
+    {
+        uint32_t version = s_transformVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (version == 0)
+        {
+            // 0 means no version, take the next one on wrap around
+            version = s_transformVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+        return version;
+    }
+
 protected:
     mutable Flag flags_;
     static uint32_t s_globalOrderOfArrival;
+    static std::atomic<uint32_t> s_transformVersion;
 
     std::function<void(IRenderer*)>* _beforeVisitCallback;
     std::function<void(IRenderer*)>* _afterVisitCallback;
@@ -1785,6 +1822,7 @@ protected:
     Director* _director;            //cached director pointer to improve rendering performance
     std::string _name;              ///<a string label, an user defined string to identify this node
     size_t _hashOfName;             ///<hash value of _name, used for speed in getChildByName
+    NodeIndex* _nodeIndex;          ///< index of the scene this node is part of, nullptr when the scene has none
 
     void* _userData;                ///< A user assigned void pointer, Can be point to any cpp object
     SmartPtr<Ref> _userObject;               ///< A user assigned Object
@@ -1856,6 +1894,14 @@ protected:
 
     mutable bool _additionalTransformDirty; ///< transform dirty ?
 
+    mutable bool _affineTransform;  ///< whether _transform only rotates, skews and scales in the XY plane
+
+    mutable uint32_t _transformVersion; ///< changes whenever _transform changes
+    mutable WorldTransformCache* _worldTransformCache; ///< allocated by the first world transform query
+
+    uint32_t _modelViewStamp;       ///< TransformSystem update that last computed or checked _modelViewTransform, 0 if none
+    int32_t _hitTestCount;          ///< nodes of this subtree in the HitTestGrid, this one included
+
     bool _cullingDirty;  ///< Whether culling is dirty
     enum
     {
@@ -1877,7 +1923,10 @@ protected:
         KeyboardEnabled = 1 << 15,
         TraverseEnabled = 1 << 16,
         RenderGrouped = 1 << 17,
-        UserFlag = 1 << 18
+        Tweening = 1 << 18, // has tweens in the director's TweenSystem
+        HitTestIndexed = 1 << 19, // in the HitTestGrid of its event dispatcher
+        WorldComputed = 1 << 20, // _modelViewTransform changed by a TransformSystem and not visited since
+        UserFlag = 1 << 21
     };
     COCOS_TYPE_OVERRIDE(Node);
 private:
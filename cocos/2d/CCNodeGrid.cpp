@@ -106,10 +106,10 @@ void NodeGrid::visit(IRenderer *renderer, const Mat4 &parentTransform, uint32_t
         return;
     }
 
-    bool dirty = (parentFlags & FLAGS_TRANSFORM_DIRTY) || flags_.isOn(Node::WorldDirty);
+    bool dirty = (parentFlags & FLAGS_TRANSFORM_DIRTY) || flags_.isOn(Node::WorldDirty | Node::WorldComputed);
     if(dirty)
         _modelViewTransform = this->transform(parentTransform);
-    flags_.setOff(Node::WorldDirty);
+    flags_.setOff(Node::WorldDirty | Node::WorldComputed);
 
     /*_groupCommand.init(_globalZOrder);
     renderer->addCommand(&_groupCommand);
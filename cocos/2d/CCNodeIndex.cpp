@@ -0,0 +1,179 @@
+#include "ccHeader.h"
+#include "2d/CCNodeIndex.h"
+
+NS_CC_BEGIN
+
+NodeIndex::NodeIndex(Node* root)
+    :root_(root)
+    ,nodeCount_(0)
+{
+    root_->_nodeIndex = this;
+    for (Node* child : root_->_children)
+    {
+        NodeIndex::add(child);
+    }
+}
+
+NodeIndex::~NodeIndex()
+{
+    for (Node* child : root_->_children)
+    {
+        NodeIndex::remove(child);
+    }
+    root_->_nodeIndex = nullptr;
+}
+
+void NodeIndex::add(Node* child)
+{
+    child->_nodeIndex = this;
+    nodeCount_++;
+    insertName(child);
+    insertTag(child);
+    for (Node* grandChild : child->_children)
+    {
+        add(grandChild);
+    }
+}
+
+void NodeIndex::remove(Node* child)
+{
+    for (Node* grandChild : child->_children)
+    {
+        remove(grandChild);
+    }
+    eraseName(child, child->_hashOfName);
+    eraseTag(child, child->_tag);
+    nodeCount_--;
+    child->_nodeIndex = nullptr;
+}
+
+void NodeIndex::rename(Node* node, size_t oldHash)
+{
+    eraseName(node, oldHash);
+    insertName(node);
+}
+
+void NodeIndex::retag(Node* node, int32_t oldTag)
+{
+    eraseTag(node, oldTag);
+    insertTag(node);
+}
+
+Node* NodeIndex::getChildByName(const Node* parent, const std::string& name, size_t hash) const
+{
+    int count = 0;
+    Node* child = findChildByHash(parent, hash, &count);
+    if (count == 1)
+    {
+        return child->_name == name ? child : nullptr;
+    }
+    if (count > 1)
+    {
+        // several children share the hash, the first one in the children wins
+        for (Node* node : parent->_children)
+        {
+            if (node->_hashOfName == hash && node->_name == name)
+            {
+                return node;
+            }
+        }
+    }
+    return nullptr;
+}
+
+Node* NodeIndex::getChildByTag(const Node* parent, int32_t tag) const
+{
+    auto range = tags_.equal_range({parent, static_cast<size_t>(tag)});
+    if (range.first == range.second)
+    {
+        return nullptr;
+    }
+    if (std::next(range.first) == range.second)
+    {
+        return range.first->second;
+    }
+    for (Node* node : parent->_children)
+    {
+        if (node->_tag == tag)
+        {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+Node* NodeIndex::findChildByHash(const Node* parent, size_t hash, int* count) const
+{
+    auto range = names_.equal_range({parent, hash});
+    *count = static_cast<int>(std::distance(range.first, range.second));
+    return range.first == range.second ? nullptr : range.first->second;
+}
+
+bool NodeIndex::containsName(size_t hash) const
+{
+    return nameCounts_.find(hash) != nameCounts_.end();
+}
+
+void NodeIndex::insertName(Node* node)
+{
+    if (!node->_name.empty())
+    {
+        names_.insert({{node->_parent, node->_hashOfName}, node});
+        nameCounts_[node->_hashOfName]++;
+    }
+}
+
+void NodeIndex::eraseName(Node* node, size_t hash)
+{
+    // unnamed nodes were never inserted, see insertName
+    auto it = nameCounts_.find(hash);
+    if (it == nameCounts_.end())
+    {
+        return;
+    }
+    Key key = {node->_parent, hash};
+    auto range = names_.equal_range(key);
+    for (auto entry = range.first; entry != range.second; ++entry)
+    {
+        if (entry->second == node)
+        {
+            names_.erase(entry);
+            if (--it->second == 0)
+            {
+                nameCounts_.erase(it);
+            }
+            return;
+        }
+    }
+}
+
+void NodeIndex::insertTag(Node* node)
+{
+    if (node->_tag != Node::INVALID_TAG)
+    {
+        tags_.insert({{node->_parent, static_cast<size_t>(node->_tag)}, node});
+    }
+}
+
+void NodeIndex::eraseTag(Node* node, int32_t tag)
+{
+    if (tag != Node::INVALID_TAG)
+    {
+        erase(tags_, {node->_parent, static_cast<size_t>(tag)}, node);
+    }
+}
+
+void NodeIndex::erase(Map& map, const Key& key, Node* node)
+{
+    auto range = map.equal_range(key);
+    for (auto entry = range.first; entry != range.second; ++entry)
+    {
+        if (entry->second == node)
+        {
+            map.erase(entry);
+            return;
+        }
+    }
+}
+
+NS_CC_END
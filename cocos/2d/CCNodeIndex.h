@@ -0,0 +1,76 @@
+#pragma once
+
+#include "2d/CCNode.h"
+#include <unordered_map>
+
+NS_CC_BEGIN
+
+/** @brief Name and tag lookup tables for a node hierarchy.
+ Every node reachable from the root through its children is keyed by its
+ parent and name hash, and by its parent and tag, so getChildByName,
+ getChildByTag and enumerateChildren don't scan the children. Nodes join
+ when they are added under an indexed node and leave when they are
+ removed, setName and setTag keep the keys up to date.
+ @example Enable it for a scene.
+ scene->setNodeIndexEnabled(true);
+ */
+
+class CC_DLL NodeIndex
+{
+public:
+    explicit NodeIndex(Node* root);
+    virtual ~NodeIndex();
+
+    /** Adds child and everything below it, child must already be in its parent's children. */
+    void add(Node* child);
+    /** Removes child and everything below it. */
+    void remove(Node* child);
+
+    void rename(Node* node, size_t oldHash);
+    void retag(Node* node, int32_t oldTag);
+
+    /** Same result as scanning parent's children. */
+    Node* getChildByName(const Node* parent, const std::string& name, size_t hash) const;
+    Node* getChildByTag(const Node* parent, int32_t tag) const;
+
+    /** Returns a child of parent whose name hashes to hash, count tells how many children do.
+     The child is only meaningful when count is one. */
+    Node* findChildByHash(const Node* parent, size_t hash, int* count) const;
+
+    /** Whether any indexed node has a name that hashes to hash. */
+    bool containsName(size_t hash) const;
+
+    inline int getNodeCount() const { return nodeCount_; }
+private:
+    struct Key
+    {
+        const Node* parent;
+        size_t value;
+        inline bool operator==(const Key& other) const
+        {
+            return parent == other.parent && value == other.value;
+        }
+    };
+    struct KeyHash
+    {
+        inline size_t operator()(const Key& key) const
+        {
+            return std::hash<const void*>()(key.parent) ^ (key.value * 0x9E3779B97F4A7C15ull);
+        }
+    };
+    typedef std::unordered_multimap<Key, Node*, KeyHash> Map;
+
+    void insertName(Node* node);
+    void eraseName(Node* node, size_t hash);
+    void insertTag(Node* node);
+    void eraseTag(Node* node, int32_t tag);
+    static void erase(Map& map, const Key& key, Node* node);
+private:
+    Node* root_;
+    int nodeCount_;
+    Map names_;
+    Map tags_;
+    std::unordered_map<size_t, int> nameCounts_;
+};
+
+NS_CC_END
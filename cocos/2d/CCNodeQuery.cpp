@@ -0,0 +1,510 @@
+#include "ccHeader.h"
+#include "2d/CCNodeQuery.h"
+#include "2d/CCNodeIndex.h"
+#include <cctype>
+#include <regex>
+
+NS_CC_BEGIN
+
+struct NodeQuery::Fallback
+{
+    std::regex regex;
+};
+
+NodeQuery::NodeQuery(const std::string& path)
+    :recursive_(false)
+{
+    size_t length = path.length();
+    size_t start = 0;
+    size_t count = length;
+
+    // starts with '//', search recursively
+    if (length > 2 && path[0] == '/' && path[1] == '/')
+    {
+        recursive_ = true;
+        start = 2;
+        count -= 2;
+    }
+
+    // ends with '/..', search from the parent
+    bool searchFromParent = length > 3 && path[length - 3] == '/' && path[length - 2] == '.' && path[length - 1] == '.';
+    if (searchFromParent)
+    {
+        count -= 3;
+    }
+
+    std::string name = path.substr(start, count);
+    if (searchFromParent)
+    {
+        name.insert(0, "[[:alnum:]]+/");
+    }
+
+    size_t begin = 0;
+    while (true)
+    {
+        size_t pos = name.find('/', begin);
+        Part part;
+        part.pattern = name.substr(begin, pos == std::string::npos ? std::string::npos : pos - begin);
+        part.hash = std::hash<std::string>()(part.pattern);
+        part.compiled = compile(part);
+        part.literal = part.compiled && std::all_of(part.atoms.begin(), part.atoms.end(), [](const Atom& atom)
+        {
+            return atom.min == 1 && atom.max == 1 && atom.chars.count() == 1;
+        });
+        if (part.literal)
+        {
+            // escapes are gone, compare against the plain name
+            part.pattern.clear();
+            for (const Atom& atom : part.atoms)
+            {
+                for (int c = 0; c < 256; c++)
+                {
+                    if (atom.chars.test(c))
+                    {
+                        part.pattern += static_cast<char>(c);
+                        break;
+                    }
+                }
+            }
+            part.hash = std::hash<std::string>()(part.pattern);
+            part.atoms.clear();
+        }
+        parts_.push_back(std::move(part));
+        if (pos == std::string::npos)
+        {
+            break;
+        }
+        begin = pos + 1;
+    }
+}
+
+bool NodeQuery::enumerate(const Node* node, const std::function<bool(Node*)>& callback) const
+{
+    if (!recursive_)
+    {
+        return enumerateFrom(node, 0, callback);
+    }
+    if (node->_nodeIndex)
+    {
+        // every node below is indexed, a name nobody has can't match
+        for (const Part& part : parts_)
+        {
+            if (part.literal && !part.pattern.empty() && !node->_nodeIndex->containsName(part.hash))
+            {
+                return false;
+            }
+        }
+    }
+    return enumerateRecursive(node, callback);
+}
+
+bool NodeQuery::match(int index, const std::string& name) const
+{
+    const Part& part = parts_[index];
+    if (part.literal)
+    {
+        return name == part.pattern;
+    }
+    if (part.compiled)
+    {
+        return matchAtoms(part.atoms, name);
+    }
+    if (!part.fallbackRegex)
+    {
+        part.fallbackRegex = std::make_shared<Fallback>(Fallback{std::regex(part.pattern)});
+    }
+    return std::regex_match(name, part.fallbackRegex->regex);
+}
+
+bool NodeQuery::matchChild(int index, const Node* child) const
+{
+    const Part& part = parts_[index];
+    if (part.literal && !part.pattern.empty())
+    {
+        // Different strings may have the same hash code, but can use it to compare first for speed
+        return child->_hashOfName == part.hash && child->_name == part.pattern;
+    }
+    return match(index, child->_name);
+}
+
+bool NodeQuery::enumerateFrom(const Node* node, int index, const std::function<bool(Node*)>& callback) const
+{
+    const Part& part = parts_[index];
+    bool last = index + 1 == getPartCount();
+    if (part.literal && !part.pattern.empty() && node->_nodeIndex)
+    {
+        int count = 0;
+        Node* child = node->_nodeIndex->findChildByHash(node, part.hash, &count);
+        if (count == 0)
+        {
+            return false;
+        }
+        if (count == 1)
+        {
+            if (child->_name != part.pattern)
+            {
+                return false;
+            }
+            return last ? callback(child) : enumerateFrom(child, index + 1, callback);
+        }
+    }
+
+    for (const auto& child : node->getChildren())
+    {
+        if (matchChild(index, child))
+        {
+            if (last)
+            {
+                // terminate enumeration if callback return true
+                if (callback(child))
+                {
+                    return true;
+                }
+            }
+            else if (enumerateFrom(child, index + 1, callback))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool NodeQuery::enumerateRecursive(const Node* node, const std::function<bool(Node*)>& callback) const
+{
+    if (enumerateFrom(node, 0, callback))
+    {
+        return true;
+    }
+    for (const auto& child : node->getChildren())
+    {
+        if (enumerateRecursive(child, callback))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NodeQuery::compile(Part& part)
+{
+    const std::string& pattern = part.pattern;
+    size_t length = pattern.length();
+    size_t pos = 0;
+    // anchors are implied, regex_match matches the whole name
+    if (pos < length && pattern[pos] == '^')
+    {
+        pos++;
+    }
+    if (length > pos && pattern[length - 1] == '$' && (length < 2 || pattern[length - 2] != '\\'))
+    {
+        length--;
+    }
+    while (pos < length)
+    {
+        char c = pattern[pos++];
+        Atom atom;
+        atom.min = 1;
+        atom.max = 1;
+        switch (c)
+        {
+        case '.':
+            atom.chars.set();
+            atom.chars.reset('\n');
+            atom.chars.reset('\r');
+            break;
+        case '[':
+            if (!parseBracket(pattern, pos, atom.chars))
+            {
+                return false;
+            }
+            break;
+        case '\\':
+            if (pos >= length || !parseEscape(pattern[pos++], atom.chars))
+            {
+                return false;
+            }
+            break;
+        case '*': case '+': case '?': case '{': case '}':
+        case '(': case ')': case '|': case ']': case '^': case '$':
+            return false;
+        default:
+            atom.chars.set(static_cast<unsigned char>(c));
+            break;
+        }
+
+        // quantifier
+        if (pos < length)
+        {
+            char q = pattern[pos];
+            if (q == '*' || q == '+' || q == '?')
+            {
+                atom.min = q == '+' ? 1 : 0;
+                atom.max = q == '?' ? 1 : -1;
+                pos++;
+            }
+            else if (q == '{')
+            {
+                size_t end = pattern.find('}', pos);
+                if (end == std::string::npos || end >= length)
+                {
+                    return false;
+                }
+                std::string bounds = pattern.substr(pos + 1, end - pos - 1);
+                size_t comma = bounds.find(',');
+                std::string low = bounds.substr(0, comma);
+                std::string high = comma == std::string::npos ? low : bounds.substr(comma + 1);
+                auto isNumber = [](const std::string& s)
+                {
+                    return !s.empty() && s.size() < 6 && std::all_of(s.begin(), s.end(), [](char d) { return d >= '0' && d <= '9'; });
+                };
+                if (!isNumber(low) || (!high.empty() && !isNumber(high)))
+                {
+                    return false;
+                }
+                atom.min = atoi(low.c_str());
+                atom.max = high.empty() ? -1 : atoi(high.c_str());
+                if (atom.max >= 0 && atom.max < atom.min)
+                {
+                    return false;
+                }
+                pos = end + 1;
+            }
+            else
+            {
+                part.atoms.push_back(atom);
+                continue;
+            }
+            // lazy quantifiers match the same names
+            if (pos < length && pattern[pos] == '?')
+            {
+                pos++;
+            }
+            if (pos < length && (pattern[pos] == '*' || pattern[pos] == '+' || pattern[pos] == '?' || pattern[pos] == '{'))
+            {
+                return false;
+            }
+        }
+        part.atoms.push_back(atom);
+    }
+    return true;
+}
+
+bool NodeQuery::parseBracket(const std::string& pattern, size_t& pos, std::bitset<256>& chars)
+{
+    static const struct
+    {
+        const char* name;
+        int (*isClass)(int);
+    } classes[] =
+    {
+        {"alnum", isalnum}, {"alpha", isalpha}, {"blank", isblank}, {"cntrl", iscntrl},
+        {"digit", isdigit}, {"graph", isgraph}, {"lower", islower}, {"print", isprint},
+        {"punct", ispunct}, {"space", isspace}, {"upper", isupper}, {"xdigit", isxdigit},
+    };
+
+    size_t length = pattern.length();
+    bool negate = pos < length && pattern[pos] == '^';
+    if (negate)
+    {
+        pos++;
+    }
+    // ']' first is an empty class in ECMAScript, leave it to std::regex
+    if (pos >= length || pattern[pos] == ']')
+    {
+        return false;
+    }
+    while (pos < length && pattern[pos] != ']')
+    {
+        char c = pattern[pos++];
+        if (c == '[')
+        {
+            if (pos >= length || pattern[pos] != ':')
+            {
+                return false;
+            }
+            size_t end = pattern.find(":]", pos + 1);
+            if (end == std::string::npos)
+            {
+                return false;
+            }
+            std::string name = pattern.substr(pos + 1, end - pos - 1);
+            auto found = std::find_if(std::begin(classes), std::end(classes), [&name](decltype(classes[0])& entry)
+            {
+                return name == entry.name;
+            });
+            if (found == std::end(classes))
+            {
+                return false;
+            }
+            addClass(found->isClass, false, chars);
+            pos = end + 2;
+            continue;
+        }
+        if (c == '\\')
+        {
+            if (pos >= length)
+            {
+                return false;
+            }
+            char e = pattern[pos++];
+            std::bitset<256> escaped;
+            if (!parseEscape(e, escaped))
+            {
+                return false;
+            }
+            if (escaped.count() != 1)
+            {
+                // a class can't start a range
+                if (pos + 1 < length && pattern[pos] == '-' && pattern[pos + 1] != ']')
+                {
+                    return false;
+                }
+                chars |= escaped;
+                continue;
+            }
+            for (int i = 0; i < 256; i++)
+            {
+                if (escaped.test(i))
+                {
+                    c = static_cast<char>(i);
+                    break;
+                }
+            }
+        }
+        // range, unless '-' is the last character
+        if (pos + 1 < length && pattern[pos] == '-' && pattern[pos + 1] != ']')
+        {
+            char last = pattern[pos + 1];
+            if (last == '\\' || last == '[')
+            {
+                return false;
+            }
+            unsigned char first = static_cast<unsigned char>(c);
+            unsigned char end = static_cast<unsigned char>(last);
+            if (end < first)
+            {
+                return false;
+            }
+            for (int i = first; i <= end; i++)
+            {
+                chars.set(i);
+            }
+            pos += 2;
+            continue;
+        }
+        chars.set(static_cast<unsigned char>(c));
+    }
+    if (pos >= length)
+    {
+        return false;
+    }
+    // skip ']'
+    pos++;
+    if (negate)
+    {
+        chars.flip();
+    }
+    return true;
+}
+
+bool NodeQuery::parseEscape(char c, std::bitset<256>& chars)
+{
+    switch (c)
+    {
+    case 'd': addClass(isdigit, false, chars); return true;
+    case 'D': addClass(isdigit, true, chars); return true;
+    case 's': addClass(isspace, false, chars); return true;
+    case 'S': addClass(isspace, true, chars); return true;
+    case 'w':
+    case 'W':
+    {
+        std::bitset<256> word;
+        addClass(isalnum, false, word);
+        word.set('_');
+        chars |= c == 'w' ? word : ~word;
+        return true;
+    }
+    case 'n': chars.set('\n'); return true;
+    case 'r': chars.set('\r'); return true;
+    case 't': chars.set('\t'); return true;
+    case 'f': chars.set('\f'); return true;
+    case 'v': chars.set('\v'); return true;
+    default:
+        // escaped punctuation stands for itself, anything else (\b, \1, \x41...) goes to std::regex
+        if (ispunct(static_cast<unsigned char>(c)))
+        {
+            chars.set(static_cast<unsigned char>(c));
+            return true;
+        }
+        return false;
+    }
+}
+
+void NodeQuery::addClass(int (*isClass)(int), bool negate, std::bitset<256>& chars)
+{
+    for (int i = 0; i < 256; i++)
+    {
+        if ((isClass(i) != 0) != negate)
+        {
+            chars.set(i);
+        }
+    }
+}
+
+bool NodeQuery::matchAtoms(const std::vector<Atom>& atoms, const std::string& name)
+{
+    // positions of name reachable after each atom, names are short enough to keep this on the stack
+    size_t length = name.length();
+    char buffer[2][64];
+    std::vector<char> large;
+    char* current = buffer[0];
+    char* next = buffer[1];
+    if (length + 1 > sizeof(buffer[0]))
+    {
+        large.resize((length + 1) * 2);
+        current = large.data();
+        next = current + length + 1;
+    }
+    memset(current, 0, length + 1);
+    current[0] = 1;
+    for (const Atom& atom : atoms)
+    {
+        memset(next, 0, length + 1);
+        bool any = false;
+        for (size_t start = 0; start <= length; start++)
+        {
+            if (!current[start])
+            {
+                continue;
+            }
+            if (atom.min == 0)
+            {
+                next[start] = 1;
+                any = true;
+            }
+            int count = 0;
+            for (size_t pos = start; pos < length && (atom.max < 0 || count < atom.max); pos++)
+            {
+                if (!atom.chars.test(static_cast<unsigned char>(name[pos])))
+                {
+                    break;
+                }
+                count++;
+                if (count >= atom.min)
+                {
+                    next[pos + 1] = 1;
+                    any = true;
+                }
+            }
+        }
+        if (!any)
+        {
+            return false;
+        }
+        std::swap(current, next);
+    }
+    return current[length] != 0;
+}
+
+NS_CC_END
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "2d/CCNode.h"
+#include <bitset>
+
+NS_CC_BEGIN
+
+/** @brief Compiled search path of Node::enumerateChildren.
+ The path is split on '/' and every part is compiled once. Plain names are
+ compared by hash, parts using characters, `.`, bracket expressions,
+ `[[:alnum:]]` style classes, `\d` `\w` `\s` and the `*` `+` `?` `{n,m}`
+ quantifiers are matched without std::regex. Anything else, like groups or
+ alternatives, still goes through std::regex, compiled once per query
+ instead of once per child. The results are those of matching every part
+ as a regular expression against the names.
+ */
+
+class CC_DLL NodeQuery
+{
+public:
+    /** path uses the syntax of Node::enumerateChildren. */
+    explicit NodeQuery(const std::string& path);
+
+    /** Runs the query from node, stops and returns true when callback returns true. */
+    bool enumerate(const Node* node, const std::function<bool(Node*)>& callback) const;
+
+    /** Whether part index of the path matches name. */
+    bool match(int index, const std::string& name) const;
+
+    inline int getPartCount() const { return static_cast<int>(parts_.size()); }
+    inline bool isRecursive() const { return recursive_; }
+private:
+    struct Fallback;
+    struct Atom
+    {
+        std::bitset<256> chars;
+        int min;
+        int max; // -1 for unbounded
+    };
+    struct Part
+    {
+        std::string pattern;
+        bool literal;
+        bool compiled;
+        size_t hash;
+        std::vector<Atom> atoms;
+        mutable std::shared_ptr<Fallback> fallbackRegex;
+    };
+
+    static bool compile(Part& part);
+    static bool parseBracket(const std::string& pattern, size_t& pos, std::bitset<256>& chars);
+    static bool parseEscape(char c, std::bitset<256>& chars);
+    static void addClass(int (*isClass)(int), bool negate, std::bitset<256>& chars);
+    static bool matchAtoms(const std::vector<Atom>& atoms, const std::string& name);
+    bool matchChild(int index, const Node* child) const;
+    bool enumerateFrom(const Node* node, int index, const std::function<bool(Node*)>& callback) const;
+    bool enumerateRecursive(const Node* node, const std::function<bool(Node*)>& callback) const;
+private:
+    std::vector<Part> parts_;
+    bool recursive_;
+};
+
+NS_CC_END
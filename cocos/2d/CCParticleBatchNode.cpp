@@ -30,6 +30,7 @@
 #include "ccHeader.h"
 #include "2d/CCParticleBatchNode.h"
 #include "2d/CCGrid.h"
+#include "2d/CCNodeIndex.h"
 #include "2d/CCParticleSystem.h"
 #include "renderer/CCTextureCache.h"
 #include "renderer/Renderer.h"
@@ -212,6 +213,10 @@ int ParticleBatchNode::addChildHelper(ParticleSystem* child, int z, int aTag, co
     child->setLocalZOrder(z);
 
     child->setParent(this);
+    if (_nodeIndex)
+    {
+        _nodeIndex->add(child);
+    }
 
     if(flags_.isOn(Node::Running))
     {
@@ -26,6 +26,8 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "ccHeader.h"
 #include "2d/CCScene.h"
+#include "2d/CCTransformSystem.h"
+#include "2d/CCNodeIndex.h"
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 
@@ -92,6 +94,11 @@ std::string Scene::getDescription() const
 void Scene::render(IRenderer* renderer, const Mat4& eyeTransform, const Mat4* eyeProjection)
 {
     const auto& transform = getNodeToParentTransform();
+
+    if (transformSystem_)
+    {
+        transformSystem_->update(transform);
+    }
     
     //visit the scene
     visit(renderer, transform, 0);
@@ -106,5 +113,48 @@ void Scene::removeAllChildren()
     Node::removeAllChildren();
 }
 
-NS_CC_END
+void Scene::setTransformSystemEnabled(bool enabled)
+{
+    if (enabled && !transformSystem_)
+    {
+        transformSystem_ = New<TransformSystem>(this);
+    }
+    else if (!enabled)
+    {
+        transformSystem_ = nullptr;
+    }
+}
+
+bool Scene::isTransformSystemEnabled() const
+{
+    return transformSystem_ != nullptr;
+}
+
+TransformSystem* Scene::getTransformSystem() const
+{
+    return transformSystem_;
+}
+
+void Scene::setNodeIndexEnabled(bool enabled)
+{
+    if (enabled && !nodeIndex_)
+    {
+        nodeIndex_ = New<NodeIndex>(this);
+    }
+    else if (!enabled)
+    {
+        nodeIndex_ = nullptr;
+    }
+}
 
+bool Scene::isNodeIndexEnabled() const
+{
+    return nodeIndex_ != nullptr;
+}
+
+NodeIndex* Scene::getNodeIndex() const
+{
+    return nodeIndex_;
+}
+
+NS_CC_END
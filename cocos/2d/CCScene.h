@@ -32,6 +32,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class TransformSystem;
+class NodeIndex;
 
 /**
  * @addtogroup _2d
@@ -78,6 +80,22 @@ public:
 
     /** override function */
     virtual void removeAllChildren() override;
+
+    /** Updates the world transforms of the whole scene in one batch before it is visited.
+     * Worth it for large, mostly static hierarchies, see TransformSystem.
+     */
+    void setTransformSystemEnabled(bool enabled);
+    bool isTransformSystemEnabled() const;
+    /** The scene's TransformSystem, nullptr when it is disabled. */
+    TransformSystem* getTransformSystem() const;
+
+    /** Keeps name and tag lookup tables of the whole scene, so getChildByName, getChildByTag
+     * and enumerateChildren don't scan children. Worth it for large UI trees queried often, see NodeIndex.
+     */
+    void setNodeIndexEnabled(bool enabled);
+    bool isNodeIndexEnabled() const;
+    /** The scene's NodeIndex, nullptr when it is disabled. */
+    NodeIndex* getNodeIndex() const;
     
 CC_CONSTRUCTOR_ACCESS:
     Scene();
@@ -91,6 +109,9 @@ protected:
     friend class ProtectedNode;
     friend class SpriteBatchNode;
 
+    Own<TransformSystem> transformSystem_;
+    Own<NodeIndex> nodeIndex_;
+
     COCOS_TYPE_OVERRIDE(Scene);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Scene);
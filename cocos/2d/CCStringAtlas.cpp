@@ -0,0 +1,319 @@
+#include "ccHeader.h"
+#include "2d/CCStringAtlas.h"
+#include "renderer/CCTexture2D.h"
+#include "base/ccUTF8.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // shelves are made in steps of this height, so texts of a similar size share them
+    const int ShelfStep = 8;
+    const int BytesPerPixel = 4;
+}
+
+int StringAtlas::s_pageSize = 1024;
+int StringAtlas::s_maxPages = 4;
+
+StringAtlas::Entry::Entry()
+    :page_(-1)
+    ,shelf_(0)
+    ,slotX_(0)
+    ,slotWidth_(0)
+    ,slotHeight_(0)
+    ,premultiplied_(false)
+{
+}
+
+StringAtlas::Entry::~Entry()
+{
+    if (page_ >= 0 && !Singleton<StringAtlas>::isDisposed())
+    {
+        SharedStringAtlas.free(this);
+    }
+}
+
+StringAtlas::StringAtlas()
+{
+}
+
+StringAtlas::~StringAtlas()
+{
+}
+
+void StringAtlas::setPageSize(int size)
+{
+    CCASSERT(size > 0, "StringAtlas: invalid page size");
+    s_pageSize = size;
+}
+
+void StringAtlas::setMaxPages(int maxPages)
+{
+    s_maxPages = maxPages;
+}
+
+int StringAtlas::getPageCount() const
+{
+    int count = 0;
+    for (auto&& page : pages_)
+    {
+        if (page.texture)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+std::string StringAtlas::makeKey(const std::string& text, const FontDefinition& definition)
+{
+    const auto& stroke = definition._stroke;
+    return StringUtils::format("%s|%d|%d|%g|%g|%02x%02x%02x%02x|%d|%g|%02x%02x%02x%02x|%d|%d|%d|%d|%g|",
+        definition._fontName.c_str(), definition._fontSize, definition._overflow,
+        definition._dimensions.width, definition._dimensions.height,
+        definition._fontFillColor.r, definition._fontFillColor.g, definition._fontFillColor.b, definition._fontAlpha,
+        stroke._strokeEnabled ? 1 : 0, stroke._strokeSize,
+        stroke._strokeColor.r, stroke._strokeColor.g, stroke._strokeColor.b, stroke._strokeAlpha,
+        static_cast<int>(definition._alignment), static_cast<int>(definition._vertAlignment),
+        definition._enableWrap ? 1 : 0, definition._enableBold ? 1 : 0,
+        CC_CONTENT_SCALE_FACTOR()) + text;
+}
+
+StringAtlas::Entry* StringAtlas::add(const std::string& text, const FontDefinition& definition, Entry* previous)
+{
+    CC_TRACE_SCOPE("StringAtlas::add");
+    auto key = makeKey(text, definition);
+    if (previous && previous->key_ == key)
+    {
+        return previous;
+    }
+
+    int width = 0;
+    int height = 0;
+    bool premultiplied = false;
+    Data data = Texture2D::getStringData(text, definition, width, height, premultiplied);
+    if (data.isNull() || width <= 0 || height <= 0)
+    {
+        return nullptr;
+    }
+
+    // the rect keeps a transparent texel on its right and bottom, neighbours are one texel away
+    if (previous && previous->page_ >= 0 && previous->premultiplied_ == premultiplied
+        && width < previous->slotWidth_ && height < previous->slotHeight_)
+    {
+        previous->key_ = key;
+        upload(previous, data, width, height);
+        return previous;
+    }
+
+    auto entry = new (std::nothrow) Entry();
+    entry->key_ = key;
+    entry->premultiplied_ = premultiplied;
+    if (allocate(entry, width + 1, height + 1, premultiplied))
+    {
+        upload(entry, data, width, height);
+    }
+    else
+    {
+        auto texture = new (std::nothrow) Texture2D();
+        texture->initWithDataCopy(data.getBytes(), width * height * BytesPerPixel,
+            bgfx::TextureFormat::RGBA8, width, height, Size(width, height));
+        texture->_hasPremultipliedAlpha = premultiplied;
+        entry->texture_ = texture;
+        entry->rect_ = Rect(0, 0, width, height);
+        texture->release();
+    }
+    entry->autorelease();
+    return entry;
+}
+
+bool StringAtlas::allocate(Entry* entry, int width, int height, bool premultiplied)
+{
+    if (width > s_pageSize || height > s_pageSize)
+    {
+        return false;
+    }
+    for (int i = 0; i < static_cast<int>(pages_.size()); ++i)
+    {
+        if (pages_[i].texture && pages_[i].premultiplied == premultiplied && allocateOnPage(i, entry, width, height))
+        {
+            return true;
+        }
+    }
+    if (getPageCount() >= s_maxPages)
+    {
+        CCLOG("StringAtlas: all %d pages are used, the text gets a texture of its own", s_maxPages);
+        return false;
+    }
+    return allocateOnPage(addPage(premultiplied), entry, width, height);
+}
+
+bool StringAtlas::allocateOnPage(int index, Entry* entry, int width, int height)
+{
+    auto& page = pages_[index];
+    if (width > page.size || height > page.size)
+    {
+        return false;
+    }
+    int shelfHeight = (height + ShelfStep - 1) / ShelfStep * ShelfStep;
+
+    // the lowest shelf that takes the text and isn't more than twice its height
+    int bestShelf = -1;
+    int bestSpan = -1;
+    for (int i = 0; i < static_cast<int>(page.shelves.size()); ++i)
+    {
+        auto& shelf = page.shelves[i];
+        if (shelf.height < height || shelf.height > shelfHeight * 2
+            || (bestShelf >= 0 && shelf.height >= page.shelves[bestShelf].height))
+        {
+            continue;
+        }
+        for (int j = 0; j < static_cast<int>(shelf.free.size()); ++j)
+        {
+            if (shelf.free[j].width >= width)
+            {
+                bestShelf = i;
+                bestSpan = j;
+                break;
+            }
+        }
+    }
+
+    if (bestShelf < 0)
+    {
+        if (page.top + shelfHeight > page.size)
+        {
+            if (page.top + height > page.size)
+            {
+                return false;
+            }
+            // the last shelf takes whatever height is left
+            shelfHeight = page.size - page.top;
+        }
+        Shelf shelf;
+        shelf.y = page.top;
+        shelf.height = shelfHeight;
+        shelf.free.push_back({0, page.size});
+        page.shelves.push_back(shelf);
+        page.top += shelfHeight;
+        bestShelf = static_cast<int>(page.shelves.size()) - 1;
+        bestSpan = 0;
+    }
+
+    auto& shelf = page.shelves[bestShelf];
+    auto& span = shelf.free[bestSpan];
+    entry->texture_ = page.texture;
+    entry->page_ = index;
+    entry->shelf_ = bestShelf;
+    entry->slotX_ = span.x;
+    entry->slotWidth_ = width;
+    entry->slotHeight_ = shelf.height;
+    span.x += width;
+    span.width -= width;
+    if (span.width == 0)
+    {
+        shelf.free.erase(shelf.free.begin() + bestSpan);
+    }
+    page.entries++;
+    return true;
+}
+
+int StringAtlas::addPage(bool premultiplied)
+{
+    int index = 0;
+    while (index < static_cast<int>(pages_.size()) && pages_[index].texture)
+    {
+        index++;
+    }
+    if (index == static_cast<int>(pages_.size()))
+    {
+        pages_.emplace_back();
+    }
+
+    auto& page = pages_[index];
+    page.size = s_pageSize;
+    page.top = 0;
+    page.entries = 0;
+    page.premultiplied = premultiplied;
+    page.shelves.clear();
+
+    // the page starts transparent, rects only upload the texels their text covers
+    std::vector<uint8_t> clear(page.size * page.size * BytesPerPixel, 0);
+    auto texture = new (std::nothrow) Texture2D();
+    texture->initWithDataCopy(clear.data(), clear.size(),
+        bgfx::TextureFormat::RGBA8, page.size, page.size, Size(page.size, page.size));
+    texture->_hasPremultipliedAlpha = premultiplied;
+    page.texture = texture;
+    texture->release();
+    return index;
+}
+
+void StringAtlas::free(Entry* entry)
+{
+    auto& page = pages_[entry->page_];
+    auto& shelf = page.shelves[entry->shelf_];
+    if (page.entries > 1 || &page == &pages_.front())
+    {
+        // cleared, the texels left there would bleed into the edges of the next texts around
+        pixels_.assign(entry->slotWidth_ * entry->slotHeight_ * BytesPerPixel, 0);
+        page.texture->updateWithData(pixels_.data(), entry->slotX_, shelf.y, entry->slotWidth_, entry->slotHeight_);
+    }
+    Span freed = {entry->slotX_, entry->slotWidth_};
+    auto it = std::lower_bound(shelf.free.begin(), shelf.free.end(), freed,
+        [](const Span& a, const Span& b) { return a.x < b.x; });
+    it = shelf.free.insert(it, freed);
+    auto next = it + 1;
+    if (next != shelf.free.end() && it->x + it->width == next->x)
+    {
+        it->width += next->width;
+        shelf.free.erase(next);
+    }
+    if (it != shelf.free.begin())
+    {
+        auto prev = it - 1;
+        if (prev->x + prev->width == it->x)
+        {
+            prev->width += it->width;
+            shelf.free.erase(it);
+        }
+    }
+    entry->page_ = -1;
+
+    // empty shelves at the top of the page go back to the page
+    while (!page.shelves.empty())
+    {
+        auto& last = page.shelves.back();
+        if (last.free.size() != 1 || last.free[0].width != page.size)
+        {
+            break;
+        }
+        page.top = last.y;
+        page.shelves.pop_back();
+    }
+
+    if (--page.entries == 0 && &page != &pages_.front())
+    {
+        page.texture = nullptr;
+        page.shelves.clear();
+    }
+}
+
+void StringAtlas::upload(Entry* entry, const Data& data, int width, int height)
+{
+    auto& page = pages_[entry->page_];
+    int x = entry->slotX_;
+    int y = page.shelves[entry->shelf_].y;
+
+    // the whole slot, the text on transparent texels, clearing what a longer text left there before
+    int rowBytes = width * BytesPerPixel;
+    int uploadBytes = entry->slotWidth_ * BytesPerPixel;
+    pixels_.assign(uploadBytes * entry->slotHeight_, 0);
+    for (int row = 0; row < height; ++row)
+    {
+        memcpy(pixels_.data() + row * uploadBytes, data.getBytes() + row * rowBytes, rowBytes);
+    }
+    page.texture->updateWithData(pixels_.data(), x, y, entry->slotWidth_, entry->slotHeight_);
+    entry->rect_ = Rect(x, y, width, height);
+}
+
+NS_CC_END
@@ -0,0 +1,101 @@
+#pragma once
+
+NS_CC_BEGIN
+
+class Texture2D;
+
+/** @brief Shared texture pages for the bitmaps of system font labels.
+ Text rendered by the platform text renderer gets a rect on a page instead of
+ a texture of its own, so system font labels drawn from the same page batch
+ into one draw call. Rects are allocated on shelves of similar heights, the
+ space of a freed rect goes to the free list of its shelf and is reused by
+ the next text that fits. An entry passed back with the same text and font
+ definition is returned as is, a changed text is uploaded to the rect it
+ already has when it fits. Bitmaps larger than a page, or made once the page
+ budget is used up, get a texture of their own.
+ */
+
+class CC_DLL StringAtlas
+{
+public:
+    /** A rect on a page, given back to the atlas when the last reference is released. */
+    class CC_DLL Entry : public Ref
+    {
+    public:
+        virtual ~Entry();
+        inline Texture2D* getTexture() const { return texture_; }
+        /** The bitmap in the texture, in pixels. */
+        inline const Rect& getRect() const { return rect_; }
+    private:
+        Entry();
+        friend class StringAtlas;
+        SmartPtr<Texture2D> texture_;
+        Rect rect_;
+        std::string key_;
+        // -1 for a texture of its own
+        int page_;
+        int shelf_;
+        int slotX_;
+        int slotWidth_;
+        int slotHeight_;
+        bool premultiplied_;
+    };
+
+    ~StringAtlas();
+
+    /** Renders the text into the atlas, nullptr when it renders to nothing.
+     previous, the entry the text had before, is returned again when neither the text nor
+     the definition changed, and otherwise updated in place when the new bitmap fits its rect,
+     it must not be shown by another sprite then.
+     */
+    Entry* add(const std::string& text, const FontDefinition& definition, Entry* previous = nullptr);
+
+    /** Size in pixels of the square pages made from now on. */
+    static void setPageSize(int size);
+    /** Beyond this many pages the bitmaps get textures of their own. */
+    static void setMaxPages(int maxPages);
+
+    int getPageCount() const;
+protected:
+    StringAtlas();
+private:
+    struct Span
+    {
+        int x;
+        int width;
+    };
+    struct Shelf
+    {
+        int y;
+        int height;
+        // sorted by x, adjacent spans are merged
+        std::vector<Span> free;
+    };
+    struct Page
+    {
+        SmartPtr<Texture2D> texture;
+        std::vector<Shelf> shelves;
+        int size;
+        int top;
+        int entries;
+        bool premultiplied;
+    };
+
+    static std::string makeKey(const std::string& text, const FontDefinition& definition);
+    bool allocate(Entry* entry, int width, int height, bool premultiplied);
+    bool allocateOnPage(int index, Entry* entry, int width, int height);
+    int addPage(bool premultiplied);
+    void free(Entry* entry);
+    void upload(Entry* entry, const Data& data, int width, int height);
+private:
+    std::vector<Page> pages_;
+    std::vector<uint8_t> pixels_;
+    static int s_pageSize;
+    static int s_maxPages;
+    SINGLETON_REF(StringAtlas, BGFXCocos);
+};
+
+#define SharedStringAtlas \
+    cocos2d::Singleton<cocos2d::StringAtlas>::shared()
+
+NS_CC_END
@@ -0,0 +1,157 @@
+#include "ccHeader.h"
+#include "2d/CCTransformSystem.h"
+#include "base/JobSystem.h"
+
+NS_CC_BEGIN
+
+uint32_t TransformSystem::s_hierarchyVersion = 0;
+uint32_t TransformSystem::s_stamp = 0;
+
+TransformSystem::TransformSystem(Node* root)
+    :root_(root)
+    ,version_(s_hierarchyVersion)
+    ,stamp_(0)
+    ,lastStamp_(0)
+    ,parallelThreshold_(0)
+    ,rootChanged_(true)
+    ,refresh_(false)
+{
+    TransformSystem::rebuild();
+}
+
+TransformSystem::~TransformSystem()
+{
+}
+
+void TransformSystem::setParallelThreshold(int count)
+{
+    parallelThreshold_ = std::max(0, count);
+}
+
+void TransformSystem::rebuild()
+{
+    CC_TRACE_SCOPE("TransformSystem::rebuild");
+    version_ = s_hierarchyVersion;
+    nodes_.clear();
+    parents_.clear();
+    levels_.clear();
+    nodes_.push_back(root_);
+    parents_.push_back(-1);
+    levels_.push_back(0);
+    for (int begin = 0, end = 1; begin < end; begin = end, end = static_cast<int>(nodes_.size()))
+    {
+        levels_.push_back(end);
+        for (int i = begin; i < end; i++)
+        {
+            for (Node* child : nodes_[i]->_children)
+            {
+                nodes_.push_back(child);
+                parents_.push_back(i);
+            }
+        }
+    }
+    locals_.resize(nodes_.size());
+    worlds_.resize(nodes_.size());
+    dirty_.resize(nodes_.size());
+    // clean nodes copy their model view back in, it is still valid
+    refresh_ = true;
+}
+
+void TransformSystem::update(const Mat4& rootTransform)
+{
+    CC_TRACE_SCOPE("TransformSystem::update");
+    if (version_ != s_hierarchyVersion)
+    {
+        rebuild();
+    }
+    rootChanged_ = rootChanged_ || memcmp(rootTransform_.m, rootTransform.m, sizeof(rootTransform_.m)) != 0;
+    rootTransform_ = rootTransform;
+    // zero marks nodes that no update has checked
+    if (++s_stamp == 0)
+    {
+        ++s_stamp;
+    }
+    lastStamp_ = stamp_;
+    stamp_ = s_stamp;
+
+    int levelCount = getLevelCount();
+    for (int level = 0; level < levelCount; level++)
+    {
+        int begin = levels_[level];
+        int count = levels_[level + 1] - begin;
+        // the nodes are only called on this thread, getNodeToParentTransform can be overridden
+        // and normalized positions mark the node dirty, the workers only multiply
+        prepareRange(begin, begin + count);
+        if (parallelThreshold_ > 0 && count >= parallelThreshold_)
+        {
+            SharedJobSystem.parallelFor(count, 256, [this, begin](int first, int last)
+            {
+                multiplyRange(begin + first, begin + last);
+            });
+        }
+        else
+        {
+            multiplyRange(begin, begin + count);
+        }
+    }
+    rootChanged_ = false;
+    refresh_ = false;
+}
+
+void TransformSystem::prepareRange(int begin, int end)
+{
+    for (int i = begin; i < end; i++)
+    {
+        Node* node = nodes_[i];
+        int parent = parents_[i];
+        if (parent >= 0 && node->_usingNormalizedPosition)
+        {
+            node->updateNormalizedPosition(node->_parent->_contentSizeDirty);
+        }
+
+        // a model view checked by our previous update and not replaced by visit since is still valid
+        bool dirty = node->flags_.isOn(Node::TransformDirty | Node::WorldDirty) || node->_modelViewStamp != lastStamp_
+            || (parent < 0 ? rootChanged_ : dirty_[parent] != 0);
+        dirty_[i] = dirty;
+        node->_modelViewStamp = stamp_;
+        if (!dirty)
+        {
+            if (refresh_)
+            {
+                worlds_[i] = node->_modelViewTransform;
+            }
+            continue;
+        }
+
+        locals_[i] = node->getNodeToParentTransform();
+        // visit still tells draw and the children about the change, but only a dirty flag set after now makes it recompute
+        node->flags_.setOff(Node::WorldDirty);
+        node->flags_.setOn(Node::WorldComputed);
+    }
+}
+
+void TransformSystem::multiplyRange(int begin, int end)
+{
+    for (int i = begin; i < end; i++)
+    {
+        if (!dirty_[i])
+        {
+            continue;
+        }
+        Node* node = nodes_[i];
+        int parent = parents_[i];
+        const Mat4& parentWorld = parent < 0 ? rootTransform_ : worlds_[parent];
+        // same path as Node::transform, so the fallback in visit can compare the results
+        if (node->_affineTransform)
+        {
+            Mat4::multiplyAffine(parentWorld, locals_[i], &worlds_[i]);
+        }
+        else
+        {
+            Mat4::multiply(parentWorld, locals_[i], &worlds_[i]);
+        }
+        node->_modelViewTransform = worlds_[i];
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+/** @brief Flat storage for the world transforms of a node hierarchy.
+ The hierarchy under the root is flattened breadth first, so parents come
+ before their children and every depth level is a contiguous range of the
+ local, world and dirty arrays. update() walks them in one loop before the
+ root is visited, and splits the matrix products of large levels over the
+ JobSystem, the nodes themselves are only called on the calling thread.
+ Node::visit then reuses the results instead of computing them node by node,
+ unless the node was made dirty after the update.
+ Nodes are only reused when visited by their parent with the parent's
+ model view transform, as Node::visit does, anything else falls back to
+ the regular path.
+ @example Enable it for a scene.
+ scene->setTransformSystemEnabled(true);
+ scene->getTransformSystem()->setParallelThreshold(4096);
+ */
+
+class CC_DLL TransformSystem
+{
+public:
+    explicit TransformSystem(Node* root);
+    virtual ~TransformSystem();
+
+    /** Updates the world transforms under the root.
+     rootTransform is the parent transform the root is going to be visited with. */
+    void update(const Mat4& rootTransform);
+
+    /** Levels with at least count nodes multiply in parallel, zero keeps all the work on the calling thread. */
+    void setParallelThreshold(int count);
+    inline int getParallelThreshold() const { return parallelThreshold_; }
+
+    inline int getNodeCount() const { return static_cast<int>(nodes_.size()); }
+    inline int getLevelCount() const { return static_cast<int>(levels_.size()) - 1; }
+
+    /** Called whenever a node changes parent, systems rebuild their arrays on the next update. */
+    static inline void invalidate() { s_hierarchyVersion++; }
+
+    /** Identifies the latest update of any TransformSystem. */
+    static inline uint32_t getStamp() { return s_stamp; }
+#if BX_PLATFORM_WINDOWS
+    inline void* operator new(size_t i)
+    {
+        return _mm_malloc(i, 16);
+    }
+    inline void operator delete(void* p)
+    {
+        _mm_free(p);
+    }
+#endif // BX_PLATFORM_WINDOWS
+private:
+    void rebuild();
+    void prepareRange(int begin, int end);
+    void multiplyRange(int begin, int end);
+private:
+    Node* root_;
+    uint32_t version_;
+    uint32_t stamp_;
+    uint32_t lastStamp_;
+    int parallelThreshold_;
+    bool rootChanged_;
+    bool refresh_;
+    Mat4 rootTransform_;
+    std::vector<Node*> nodes_;
+    std::vector<int> parents_;
+    std::vector<int> levels_;
+    std::vector<Mat4> locals_;
+    std::vector<Mat4> worlds_;
+    std::vector<uint8_t> dirty_;
+    static uint32_t s_hierarchyVersion;
+    static uint32_t s_stamp;
+};
+
+NS_CC_END
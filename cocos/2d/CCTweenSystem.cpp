@@ -0,0 +1,472 @@
+#include "ccHeader.h"
+#include "2d/CCTweenSystem.h"
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace
+{
+    const int EasingCount = tweenfunc::Bounce_EaseInOut + 1;
+}
+
+TweenSystem::TweenSystem()
+    :nextId_(1)
+    ,updating_(false)
+    ,groupLookup_(static_cast<int>(Property::Count) * EasingCount, -1)
+{
+}
+
+TweenSystem::~TweenSystem()
+{
+    for (Group& group : groups_)
+    {
+        for (Node* node : group.nodes)
+        {
+            node->flags_.setOff(Node::Tweening);
+            node->release();
+        }
+    }
+}
+
+uint32_t TweenSystem::moveTo(Node* node, float duration, const Vec2& position, tweenfunc::TweenType easing)
+{
+    const Vec2& current = node->getPosition();
+    Tween tween = {0, node, Property::Position, easing, duration, {current.x, current.y}, {position.x, position.y}};
+    return start(tween);
+}
+
+uint32_t TweenSystem::scaleTo(Node* node, float duration, float scaleX, float scaleY, tweenfunc::TweenType easing)
+{
+    Tween tween = {0, node, Property::Scale, easing, duration, {node->getScaleX(), node->getScaleY()}, {scaleX, scaleY}};
+    return start(tween);
+}
+
+uint32_t TweenSystem::rotateTo(Node* node, float duration, float rotation, tweenfunc::TweenType easing)
+{
+    float from = node->getRotation();
+    from = fmodf(from, from > 0 ? 360.0f : -360.0f);
+    float diff = rotation - from;
+    if (diff > 180)
+    {
+        diff -= 360;
+    }
+    if (diff < -180)
+    {
+        diff += 360;
+    }
+    Tween tween = {0, node, Property::Rotation, easing, duration, {from, 0.0f}, {from + diff, 0.0f}};
+    return start(tween);
+}
+
+uint32_t TweenSystem::fadeTo(Node* node, float duration, GLubyte opacity, tweenfunc::TweenType easing)
+{
+    Tween tween = {0, node, Property::Opacity, easing, duration, {static_cast<float>(node->getOpacity()), 0.0f}, {static_cast<float>(opacity), 0.0f}};
+    return start(tween);
+}
+
+uint32_t TweenSystem::start(Tween& tween)
+{
+    CCASSERT(tween.node, "node must not be nullptr");
+    CCASSERT(tween.easing >= tweenfunc::Linear && tween.easing < EasingCount, "unsupported easing");
+    tween.id = nextId_++;
+    if (nextId_ == 0)
+    {
+        nextId_ = 1;
+    }
+    if (updating_)
+    {
+        pendingTweens_.push_back(tween);
+    }
+    else
+    {
+        insert(tween);
+    }
+    return tween.id;
+}
+
+void TweenSystem::insert(const Tween& tween)
+{
+    // one tween per property and node, the new one wins
+    auto range = nodeTweens_.equal_range(tween.node);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        const Location& location = locations_[it->second];
+        if (groups_[location.group].property == tween.property)
+        {
+            removeAt(location.group, location.index);
+            break;
+        }
+    }
+
+    int& groupIndex = groupLookup_[static_cast<int>(tween.property) * EasingCount + tween.easing];
+    if (groupIndex < 0)
+    {
+        groupIndex = static_cast<int>(groups_.size());
+        groups_.emplace_back();
+        groups_.back().property = tween.property;
+        groups_.back().easing = tween.easing;
+    }
+    Group& group = groups_[groupIndex];
+    locations_[tween.id] = {groupIndex, static_cast<int>(group.ids.size())};
+    group.ids.push_back(tween.id);
+    group.nodes.push_back(tween.node);
+    group.elapsed.push_back(0.0f);
+    group.invDuration.push_back(tween.duration > 0.0f ? 1.0f / tween.duration : FLT_MAX);
+    group.fromX.push_back(tween.from[0]);
+    group.fromY.push_back(tween.from[1]);
+    group.deltaX.push_back(tween.to[0] - tween.from[0]);
+    group.deltaY.push_back(tween.to[1] - tween.from[1]);
+
+    nodeTweens_.emplace(tween.node, tween.id);
+    tween.node->flags_.setOn(Node::Tweening);
+    tween.node->retain();
+}
+
+void TweenSystem::removeAt(int groupIndex, int index)
+{
+    Group& group = groups_[groupIndex];
+    uint32_t id = group.ids[index];
+    Node* node = group.nodes[index];
+    int last = static_cast<int>(group.ids.size()) - 1;
+    if (index != last)
+    {
+        group.ids[index] = group.ids[last];
+        group.nodes[index] = group.nodes[last];
+        group.elapsed[index] = group.elapsed[last];
+        group.invDuration[index] = group.invDuration[last];
+        group.fromX[index] = group.fromX[last];
+        group.fromY[index] = group.fromY[last];
+        group.deltaX[index] = group.deltaX[last];
+        group.deltaY[index] = group.deltaY[last];
+        locations_[group.ids[index]].index = index;
+    }
+    group.ids.pop_back();
+    group.nodes.pop_back();
+    group.elapsed.pop_back();
+    group.invDuration.pop_back();
+    group.fromX.pop_back();
+    group.fromY.pop_back();
+    group.deltaX.pop_back();
+    group.deltaY.pop_back();
+
+    locations_.erase(id);
+    callbacks_.erase(id);
+    auto range = nodeTweens_.equal_range(node);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == id)
+        {
+            nodeTweens_.erase(it);
+            break;
+        }
+    }
+    if (nodeTweens_.find(node) == nodeTweens_.end())
+    {
+        node->flags_.setOff(Node::Tweening);
+    }
+    node->release();
+}
+
+void TweenSystem::setCallback(uint32_t id, const std::function<void()>& callback)
+{
+    if (isRunning(id))
+    {
+        callbacks_[id] = callback;
+    }
+}
+
+bool TweenSystem::stop(uint32_t id)
+{
+    for (size_t i = 0; i < pendingTweens_.size(); i++)
+    {
+        if (pendingTweens_[i].id == id)
+        {
+            pendingTweens_.erase(pendingTweens_.begin() + i);
+            callbacks_.erase(id);
+            return true;
+        }
+    }
+    auto it = locations_.find(id);
+    if (it == locations_.end())
+    {
+        return false;
+    }
+    if (updating_)
+    {
+        pendingStops_.push_back(id);
+    }
+    else
+    {
+        removeAt(it->second.group, it->second.index);
+    }
+    return true;
+}
+
+void TweenSystem::stopAllForNode(Node* node)
+{
+    std::vector<uint32_t> ids;
+    auto range = nodeTweens_.equal_range(node);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        ids.push_back(it->second);
+    }
+    for (const Tween& tween : pendingTweens_)
+    {
+        if (tween.node == node)
+        {
+            ids.push_back(tween.id);
+        }
+    }
+    for (uint32_t id : ids)
+    {
+        stop(id);
+    }
+}
+
+void TweenSystem::stopAll()
+{
+    std::vector<uint32_t> ids;
+    for (const auto& item : locations_)
+    {
+        ids.push_back(item.first);
+    }
+    for (const Tween& tween : pendingTweens_)
+    {
+        ids.push_back(tween.id);
+    }
+    for (uint32_t id : ids)
+    {
+        stop(id);
+    }
+}
+
+bool TweenSystem::isRunning(uint32_t id) const
+{
+    if (locations_.find(id) != locations_.end())
+    {
+        return true;
+    }
+    for (const Tween& tween : pendingTweens_)
+    {
+        if (tween.id == id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int TweenSystem::getTweenCount() const
+{
+    return static_cast<int>(locations_.size() + pendingTweens_.size());
+}
+
+void TweenSystem::update(float dt)
+{
+    CC_TRACE_SCOPE("TweenSystem::update");
+    // the node setters are virtual, tweens started or stopped from them wait for the end of the update
+    updating_ = true;
+    finished_.clear();
+    for (Group& group : groups_)
+    {
+        if (!group.ids.empty())
+        {
+            updateGroup(group, dt);
+        }
+    }
+    updating_ = false;
+
+    for (uint32_t id : pendingStops_)
+    {
+        stop(id);
+    }
+    pendingStops_.clear();
+
+    std::vector<std::function<void()>> callbacks;
+    for (uint32_t id : finished_)
+    {
+        auto it = locations_.find(id);
+        if (it == locations_.end())
+        {
+            continue;
+        }
+        auto callback = callbacks_.find(id);
+        if (callback != callbacks_.end())
+        {
+            callbacks.push_back(std::move(callback->second));
+        }
+        removeAt(it->second.group, it->second.index);
+    }
+
+    std::vector<Tween> tweens;
+    tweens.swap(pendingTweens_);
+    for (const Tween& tween : tweens)
+    {
+        insert(tween);
+    }
+
+    for (const auto& callback : callbacks)
+    {
+        callback();
+    }
+}
+
+void TweenSystem::updateGroup(Group& group, float dt)
+{
+    int count = static_cast<int>(group.ids.size());
+    active_.resize(count);
+    progress_.resize(count);
+    eased_.resize(count);
+    valuesX_.resize(count);
+    valuesY_.resize(count);
+
+    // tweens of nodes that aren't running are paused, as their actions would be
+    for (int i = 0; i < count; i++)
+    {
+        active_[i] = group.nodes[i]->flags_.isOn(Node::Running) ? 1 : 0;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        group.elapsed[i] += active_[i] ? dt : 0.0f;
+        progress_[i] = std::min(group.elapsed[i] * group.invDuration[i], 1.0f);
+    }
+
+    ease(group.easing, progress_.data(), eased_.data(), count);
+    lerp(group.fromX.data(), group.deltaX.data(), eased_.data(), valuesX_.data(), count);
+    if (group.property == Property::Position || group.property == Property::Scale)
+    {
+        lerp(group.fromY.data(), group.deltaY.data(), eased_.data(), valuesY_.data(), count);
+    }
+
+    Node** nodes = group.nodes.data();
+    switch (group.property)
+    {
+    case Property::Position:
+        for (int i = 0; i < count; i++)
+        {
+            if (active_[i])
+            {
+                nodes[i]->setPosition(valuesX_[i], valuesY_[i]);
+            }
+        }
+        break;
+    case Property::Scale:
+        for (int i = 0; i < count; i++)
+        {
+            if (active_[i])
+            {
+                nodes[i]->setScale(valuesX_[i], valuesY_[i]);
+            }
+        }
+        break;
+    case Property::Rotation:
+        for (int i = 0; i < count; i++)
+        {
+            if (active_[i])
+            {
+                nodes[i]->setRotation(valuesX_[i]);
+            }
+        }
+        break;
+    case Property::Opacity:
+        for (int i = 0; i < count; i++)
+        {
+            if (active_[i])
+            {
+                nodes[i]->setOpacity(static_cast<GLubyte>(valuesX_[i]));
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (active_[i] && progress_[i] >= 1.0f)
+        {
+            finished_.push_back(group.ids[i]);
+        }
+    }
+}
+
+void TweenSystem::ease(tweenfunc::TweenType easing, const float* progress, float* eased, int count)
+{
+    // the common polynomial curves are written out so the loops vectorize, they match tweenfunc
+    switch (easing)
+    {
+    case tweenfunc::Linear:
+        memcpy(eased, progress, count * sizeof(float));
+        break;
+    case tweenfunc::Quad_EaseIn:
+        for (int i = 0; i < count; i++)
+        {
+            float t = progress[i];
+            eased[i] = t * t;
+        }
+        break;
+    case tweenfunc::Quad_EaseOut:
+        for (int i = 0; i < count; i++)
+        {
+            float t = progress[i];
+            eased[i] = -t * (t - 2);
+        }
+        break;
+    case tweenfunc::Quad_EaseInOut:
+        for (int i = 0; i < count; i++)
+        {
+            float t = progress[i] * 2;
+            float u = t - 1;
+            eased[i] = t < 1 ? 0.5f * t * t : -0.5f * (u * (u - 2) - 1);
+        }
+        break;
+    case tweenfunc::Cubic_EaseIn:
+        for (int i = 0; i < count; i++)
+        {
+            float t = progress[i];
+            eased[i] = t * t * t;
+        }
+        break;
+    case tweenfunc::Cubic_EaseOut:
+        for (int i = 0; i < count; i++)
+        {
+            float t = progress[i] - 1;
+            eased[i] = t * t * t + 1;
+        }
+        break;
+    case tweenfunc::Cubic_EaseInOut:
+        for (int i = 0; i < count; i++)
+        {
+            float t = progress[i] * 2;
+            float u = t - 2;
+            eased[i] = t < 1 ? 0.5f * t * t * t : 0.5f * (u * u * u + 2);
+        }
+        break;
+    default:
+        for (int i = 0; i < count; i++)
+        {
+            eased[i] = tweenfunc::tweenTo(progress[i], easing, nullptr);
+        }
+        break;
+    }
+}
+
+void TweenSystem::lerp(const float* from, const float* delta, const float* eased, float* values, int count)
+{
+    int i = 0;
+#ifdef __SSE__
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 value = _mm_add_ps(_mm_loadu_ps(from + i), _mm_mul_ps(_mm_loadu_ps(delta + i), _mm_loadu_ps(eased + i)));
+        _mm_storeu_ps(values + i, value);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        values[i] = from[i] + delta[i] * eased[i];
+    }
+}
+
+NS_CC_END
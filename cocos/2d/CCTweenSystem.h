@@ -0,0 +1,115 @@
+#pragma once
+
+#include "2d/CCNode.h"
+#include "2d/CCTweenFunction.h"
+
+NS_CC_BEGIN
+
+/** @brief Batched tweens of common node properties.
+ A lighter alternative to MoveTo, ScaleTo, RotateTo and FadeTo wrapped in
+ an ease action. Tweens are stored as arrays grouped by property and
+ easing, update() advances a whole group at once with the curves of
+ tweenfunc and writes the results to the nodes in one pass, without an
+ Action object or a virtual step per tween.
+ Like actions, tweens of a node that isn't running wait, and a new tween
+ of a property replaces the one running on the same node. The nodes are
+ retained until their tweens are done or stopped, Node::cleanup stops them.
+ @example Move a node in half a second.
+ auto tweens = Director::getInstance()->getTweenSystem();
+ auto id = tweens->moveTo(node, 0.5f, Vec2(100, 100), tweenfunc::Quad_EaseOut);
+ tweens->setCallback(id, [](){ CCLOG("arrived"); });
+ */
+
+class CC_DLL TweenSystem : public Ref
+{
+public:
+    enum class Property
+    {
+        Position,
+        Scale,
+        Rotation,
+        Opacity,
+        Count
+    };
+
+    TweenSystem();
+    virtual ~TweenSystem();
+
+    /** Starts tweens from the current value of the property, they return an id that is never 0.
+     easing can be any tweenfunc::TweenType but CUSTOM_EASING. */
+    uint32_t moveTo(Node* node, float duration, const Vec2& position, tweenfunc::TweenType easing = tweenfunc::Linear);
+    uint32_t scaleTo(Node* node, float duration, float scaleX, float scaleY, tweenfunc::TweenType easing = tweenfunc::Linear);
+    /** Turns the shortest way, as RotateTo does. */
+    uint32_t rotateTo(Node* node, float duration, float rotation, tweenfunc::TweenType easing = tweenfunc::Linear);
+    uint32_t fadeTo(Node* node, float duration, GLubyte opacity, tweenfunc::TweenType easing = tweenfunc::Linear);
+
+    /** callback is called once the tween has reached its end value, not when it is stopped. */
+    void setCallback(uint32_t id, const std::function<void()>& callback);
+
+    /** Stops a tween where it is, returns false if it isn't running. */
+    bool stop(uint32_t id);
+    void stopAllForNode(Node* node);
+    void stopAll();
+
+    bool isRunning(uint32_t id) const;
+    int getTweenCount() const;
+
+    /** Called by the Scheduler, advances all the tweens by dt seconds. */
+    void update(float dt);
+private:
+    struct Tween
+    {
+        uint32_t id;
+        Node* node;
+        Property property;
+        tweenfunc::TweenType easing;
+        float duration;
+        float from[2];
+        float to[2];
+    };
+    struct Group
+    {
+        Property property;
+        tweenfunc::TweenType easing;
+        std::vector<uint32_t> ids;
+        std::vector<Node*> nodes;
+        std::vector<float> elapsed;
+        std::vector<float> invDuration;
+        std::vector<float> fromX;
+        std::vector<float> fromY;
+        std::vector<float> deltaX;
+        std::vector<float> deltaY;
+    };
+    struct Location
+    {
+        int group;
+        int index;
+    };
+
+    uint32_t start(Tween& tween);
+    void insert(const Tween& tween);
+    void removeAt(int group, int index);
+    void updateGroup(Group& group, float dt);
+    static void ease(tweenfunc::TweenType easing, const float* progress, float* eased, int count);
+    static void lerp(const float* from, const float* delta, const float* eased, float* values, int count);
+private:
+    uint32_t nextId_;
+    bool updating_;
+    std::vector<Group> groups_;
+    std::vector<int> groupLookup_;
+    std::unordered_map<uint32_t, Location> locations_;
+    std::unordered_multimap<Node*, uint32_t> nodeTweens_;
+    std::unordered_map<uint32_t, std::function<void()>> callbacks_;
+    // changes requested while the groups are being updated
+    std::vector<Tween> pendingTweens_;
+    std::vector<uint32_t> pendingStops_;
+    // scratch arrays of updateGroup
+    std::vector<uint8_t> active_;
+    std::vector<float> progress_;
+    std::vector<float> eased_;
+    std::vector<float> valuesX_;
+    std::vector<float> valuesY_;
+    std::vector<uint32_t> finished_;
+};
+
+NS_CC_END
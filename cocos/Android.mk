@@ -70,6 +70,11 @@ cocos2d.cpp \
 2d/CCProtectedNode.cpp \
 2d/CCRenderTexture.cpp \
 2d/CCScene.cpp \
+2d/CCTransformSystem.cpp \
+2d/CCTweenSystem.cpp \
+2d/CCStringAtlas.cpp \
+2d/CCNodeQuery.cpp \
+2d/CCNodeIndex.cpp \
 2d/CCSprite.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSpriteFrame.cpp \
@@ -90,6 +95,7 @@ platform/CCGLView.cpp \
 platform/CCImage.cpp \
 platform/CCSAXParser.cpp \
 platform/CCThread.cpp \
+platform/CCFramePacer.cpp \
 $(MATHNEONFILE) \
 math/CCAffineTransform.cpp \
 math/CCGeometry.cpp \
@@ -117,6 +123,7 @@ base/softfloat.cpp \
 base/CCNinePatchImageParser.cpp \
 base/CCStencilStateManager.cpp \
 base/CCAsyncTaskPool.cpp \
+base/JobSystem.cpp \
 base/CCAutoreleasePool.cpp \
 base/CCConfiguration.cpp \
 base/CCConsole.cpp \
@@ -140,7 +147,10 @@ base/CCEventTouch.cpp \
 base/CCIMEDispatcher.cpp \
 base/CCNS.cpp \
 base/CCProfiling.cpp \
+base/CCHitTestGrid.cpp \
+base/CCTrace.cpp \
 base/CCRef.cpp \
+base/SlabAllocator.cpp \
 base/CCScheduler.cpp \
 base/CCScriptSupport.cpp \
 base/CCThreadPool.cpp \
@@ -80,6 +80,7 @@ int Async::work(bx::Thread* thread, void* userData)
             event != nullptr;
             event = worker->workerEvent_.poll())
         {
+            CC_TRACE_SCOPE("Async::work");
             switch (Switch::hash(event->getName()))
             {
             case "Work"_hash:
@@ -195,11 +196,4 @@ void Async::cancel()
     workers_.clear();
 }
 
-void AsyncThread::stop()
-{
-    FileIO.stop();
-    Process.stop();
-    Loader.stop();
-}
-
 NS_CC_END
\ No newline at end of file
@@ -29,30 +29,6 @@ private:
     EventQueue finisherEvent_;
 };
 
-class AsyncThread
-{
-public:
-    Async FileIO;
-    Async Process;
-    Async Loader;
-
-    void stop();
-#if BX_PLATFORM_WINDOWS
-    inline void* operator new(size_t i)
-    {
-        return _mm_malloc(i, 16);
-    }
-    inline void operator delete(void* p)
-    {
-        _mm_free(p);
-    }
-#endif // BX_PLATFORM_WINDOWS
-    SINGLETON_REF(AsyncThread);
-};
-
-#define SharedAsyncThread \
-    cocos2d::Singleton<cocos2d::AsyncThread>::shared()
-
 class AsyncLogThread : public Async
 {
 public:
@@ -298,6 +298,7 @@ Console::Console()
     createCommandSceneGraph();
     createCommandTexture();
     createCommandTouch();
+    createCommandTrace();
     createCommandUpload();
     createCommandVersion();
 }
@@ -883,6 +884,20 @@ void Console::createCommandTouch()
         CC_CALLBACK_2(Console::commandTouchSubCommandSwipe, this)});
 }
 
+void Console::createCommandTrace()
+{
+    addCommand({"trace", "Record frame traces and export Chrome trace JSON. Args: [-h | help | start | stop | clear | dump | ]",
+        CC_CALLBACK_2(Console::commandTrace, this)});
+    addSubCommand("trace", {"start", "Start recording trace events.",
+        CC_CALLBACK_2(Console::commandTraceSubCommandStartStop, this)});
+    addSubCommand("trace", {"stop", "Stop recording trace events.",
+        CC_CALLBACK_2(Console::commandTraceSubCommandStartStop, this)});
+    addSubCommand("trace", {"clear", "Drop all recorded trace events.",
+        CC_CALLBACK_2(Console::commandTraceSubCommandClear, this)});
+    addSubCommand("trace", {"dump", "trace dump [filename]: write recorded events to the writable path, trace.json by default.",
+        CC_CALLBACK_2(Console::commandTraceSubCommandDump, this)});
+}
+
 void Console::createCommandUpload()
 {
     addCommand({"upload", "upload file. Args: [filename base64_encoded_data]", CC_CALLBACK_1(Console::commandUpload, this)});
@@ -899,6 +914,11 @@ void Console::createCommandVersion()
 
 void Console::commandAllocator(int fd, const std::string& args)
 {
+#if CC_ENABLE_SLAB_ALLOCATOR
+    Console::Utility::mydprintf(fd, "%s", SlabAllocator::getDescription().c_str());
+#else
+    Console::Utility::mydprintf(fd, "SlabAllocator is not compiled in, rebuild with CC_ENABLE_SLAB_ALLOCATOR=1\n");
+#endif
 }
 
 void Console::commandConfig(int fd, const std::string& args)
@@ -1295,6 +1315,39 @@ void Console::commandUpload(int fd)
     fclose(fp);
 }
 
+void Console::commandTrace(int fd, const std::string& args)
+{
+#if CC_ENABLE_TRACING
+    Console::Utility::mydprintf(fd, "Trace is: %s\n", Trace::isEnabled() ? "on" : "off");
+#else
+    Console::Utility::mydprintf(fd, "Trace is not compiled in, rebuild with CC_ENABLE_TRACING=1\n");
+#endif
+}
+
+void Console::commandTraceSubCommandStartStop(int fd, const std::string& args)
+{
+    Trace::setEnabled(args.compare("start") == 0);
+}
+
+void Console::commandTraceSubCommandClear(int fd, const std::string& args)
+{
+    Trace::clear();
+}
+
+void Console::commandTraceSubCommandDump(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    std::string path = FileUtils::getInstance()->getWritablePath() + (argv.size() > 1 ? argv[1] : "trace.json");
+    if (Trace::exportToFile(path))
+    {
+        Console::Utility::mydprintf(fd, "trace written to %s\n", path.c_str());
+    }
+    else
+    {
+        Console::Utility::mydprintf(fd, "failed to write trace to %s\n", path.c_str());
+    }
+}
+
 void Console::commandVersion(int fd, const std::string& args)
 {
     Console::Utility::mydprintf(fd, "%s\n", cocos2dVersion());
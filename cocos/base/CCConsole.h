@@ -195,6 +195,7 @@ protected:
     void createCommandSceneGraph();
     void createCommandTexture();
     void createCommandTouch();
+    void createCommandTrace();
     void createCommandUpload();
     void createCommandVersion();
 
@@ -224,6 +225,10 @@ protected:
     void commandTexturesSubCommandFlush(int fd, const std::string& args);
     void commandTouchSubCommandTap(int fd, const std::string& args);
     void commandTouchSubCommandSwipe(int fd, const std::string& args);
+    void commandTrace(int fd, const std::string& args);
+    void commandTraceSubCommandStartStop(int fd, const std::string& args);
+    void commandTraceSubCommandClear(int fd, const std::string& args);
+    void commandTraceSubCommandDump(int fd, const std::string& args);
     void commandUpload(int fd);
     void commandVersion(int fd, const std::string& args);
     // file descriptor: socket, console, etc.
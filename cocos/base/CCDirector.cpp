@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 
 #include "2d/CCActionManager.h"
+#include "2d/CCTweenSystem.h"
 #include "2d/CCFontFNT.h"
 #include "2d/CCFontAtlasCache.h"
 #include "2d/CCAnimationCache.h"
@@ -55,7 +56,7 @@ THE SOFTWARE.
 
 #include "base/Camera.h"
 #include "base/View.h"
-#include "base/Async.h"
+#include "base/JobSystem.h"
 
 #if CC_ENABLE_SCRIPT_BINDING
 #include "base/CCScriptSupport.h"
@@ -260,6 +261,7 @@ void Director::setGLDefaultValues()
 // Draw the Scene
 void Director::drawScene()
 {
+    CC_TRACE_SCOPE("Director::drawScene");
     if (!_paused)
     {
         _eventDispatcher->dispatchEvent(_eventBeforeUpdate);
@@ -821,6 +823,12 @@ void Director::reset()
     getScheduler()->unscheduleAll();
     getScheduler()->removeAllFunctionsToBePerformedInCocosThread();
 
+    // stop all tweens, they retain their nodes
+    if (_tweenSystem)
+    {
+        _tweenSystem->stopAll();
+    }
+
     // Remove all events
     if (_eventDispatcher)
     {
@@ -872,7 +880,7 @@ void Director::reset()
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
     spine::SkeletonBatch::destroyInstance();
-    SharedAsyncThread.stop();
+    SharedJobSystem.stop();
     
     // cocos2d-x specific data structures
     UserDefault::destroyInstance();
@@ -906,6 +914,10 @@ void Director::restartDirector()
 
     // Reschedule for action manager
     getScheduler()->scheduleUpdate(getActionManager(), Scheduler::PRIORITY_SYSTEM, false);
+    if (_tweenSystem)
+    {
+        getScheduler()->scheduleUpdate(_tweenSystem.get(), Scheduler::PRIORITY_SYSTEM, false);
+    }
 
     // release the objects
     PoolManager::getInstance()->getCurrentPool()->clear();
@@ -1033,6 +1045,9 @@ void Director::showStats()
     }
     bgfx::dbgTextPrintf(dbgViewId, ++row, 0x0f, "\x1b[33;mDelta time: \x1b[63;m%.1f ms", lastDeltaTime);
     bgfx::dbgTextPrintf(dbgViewId, ++row, 0x0f, "\x1b[33;mFPS: \x1b[63;m%d",static_cast<int32_t>(1000.0f / lastDeltaTime));
+    const FramePacer::Stats& pacing = SharedApplication.getFramePacer()->getStats();
+    bgfx::dbgTextPrintf(dbgViewId, ++row, 0x0f, "\x1b[33;mPacing error: \x1b[63;m%.2f ms (max %.2f ms, late %u/%u, vsync %u)",
+        1000.0 * pacing.meanError, 1000.0 * pacing.maxError, pacing.lateFrames, pacing.frames, pacing.vsyncFrames);
     if (frames == SharedApplication.getMaxFPS())
     {
         lastCpuTime = 1000.0 * cpuTime / frames;
@@ -1040,6 +1055,7 @@ void Director::showStats()
         lastDeltaTime = 1000.0 * deltaTime / frames;
         frames = 0;
         cpuTime = gpuTime = deltaTime = 0.0;
+        SharedApplication.getFramePacer()->resetStats();
     }
 }
 
@@ -1106,6 +1122,17 @@ void Director::setActionManager(ActionManager* actionManager)
     }
 }
 
+TweenSystem* Director::getTweenSystem()
+{
+    if (!_tweenSystem)
+    {
+        _tweenSystem = new (std::nothrow) TweenSystem();
+        _tweenSystem->release();
+        _scheduler->scheduleUpdate(_tweenSystem.get(), Scheduler::PRIORITY_SYSTEM, false);
+    }
+    return _tweenSystem;
+}
+
 void Director::setEventDispatcher(EventDispatcher* dispatcher)
 {
     if (_eventDispatcher != dispatcher)
@@ -54,6 +54,7 @@ class DirectorDelegate;
 class Node;
 class Scheduler;
 class ActionManager;
+class TweenSystem;
 class EffectManager;
 class EventDispatcher;
 class EventCustom;
@@ -406,6 +407,11 @@ public:
      */
     void setActionManager(ActionManager* actionManager);
 
+    /** Gets the TweenSystem associated with this director.
+     * It is created and scheduled with the ActionManager's priority on first use.
+     */
+    TweenSystem* getTweenSystem();
+
     /** Gets the EventDispatcher associated with this director.
      * @since v3.0
      * @js NA
@@ -502,6 +508,9 @@ protected:
      */
     SmartPtr<ActionManager> _actionManager;
 
+    /** TweenSystem associated with this director, nullptr until it is used */
+    SmartPtr<TweenSystem> _tweenSystem;
+
     /** EventDispatcher associated with this director
      @since v3.0
      */
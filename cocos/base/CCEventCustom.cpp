@@ -32,6 +32,7 @@ EventCustom::EventCustom(const std::string& eventName)
 : Event(Type::CUSTOM)
 , _userData(nullptr)
 , _eventName(eventName)
+, _listenerHandle(EventListener::INVALID_HANDLE)
 {
 }
 
@@ -26,6 +26,7 @@
 #define __cocos2d_libs__CCCustomEvent__
 
 #include "base/CCEvent.h"
+#include "base/CCEventListener.h"
 
 /**
  * @addtogroup base
@@ -69,6 +70,9 @@ protected:
 
     void* _userData;       ///< User data
     std::string _eventName;
+    EventListener::ListenerHandle _listenerHandle; ///< Interned _eventName, set by the first dispatch
+
+    friend class EventDispatcher;
     COCOS_TYPE_OVERRIDE(EventCustom);
 };
 
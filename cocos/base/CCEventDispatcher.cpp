@@ -64,28 +64,40 @@ private:
 
 NS_CC_BEGIN
 
-static EventListener::ListenerID __getListenerID(Event* event)
+template <typename Listener>
+static EventListener::ListenerHandle __getListenerHandle()
 {
-    EventListener::ListenerID ret;
+    static const EventListener::ListenerHandle handle = EventListener::internListenerID(Listener::LISTENER_ID);
+    return handle;
+}
+
+static EventListener::ListenerHandle __getListenerHandle(Event* event)
+{
+    EventListener::ListenerHandle ret = EventListener::INVALID_HANDLE;
     switch (event->getType())
     {
         case Event::Type::ACCELERATION:
-            ret = EventListenerAcceleration::LISTENER_ID;
+            ret = __getListenerHandle<EventListenerAcceleration>();
             break;
         case Event::Type::CUSTOM:
             {
+                // cached once a listener interned the name, events nobody listens to stay invalid
                 auto customEvent = static_cast<EventCustom*>(event);
-                ret = customEvent->getEventName();
+                if (customEvent->_listenerHandle == EventListener::INVALID_HANDLE)
+                {
+                    customEvent->_listenerHandle = EventListener::findListenerHandle(customEvent->getEventName());
+                }
+                ret = customEvent->_listenerHandle;
             }
             break;
         case Event::Type::KEYBOARD:
-            ret = EventListenerKeyboard::LISTENER_ID;
+            ret = __getListenerHandle<EventListenerKeyboard>();
             break;
         case Event::Type::MOUSE:
-            ret = EventListenerMouse::LISTENER_ID;
+            ret = __getListenerHandle<EventListenerMouse>();
             break;
         case Event::Type::FOCUS:
-            ret = EventListenerFocus::LISTENER_ID;
+            ret = __getListenerHandle<EventListenerFocus>();
             break;
         case Event::Type::TOUCH:
             // Touch listener is very special, it contains two kinds of listeners, EventListenerTouchOneByOne and EventListenerTouchAllAtOnce.
@@ -204,17 +216,22 @@ EventDispatcher::EventDispatcher()
 
     // fixed #4129: Mark the following listener IDs for internal use.
     // Therefore, internal listeners would not be cleaned when removeAllEventListeners is invoked.
-    _internalCustomListenerIDs.insert(EVENT_COME_TO_FOREGROUND);
-    _internalCustomListenerIDs.insert(EVENT_COME_TO_BACKGROUND);
-    _internalCustomListenerIDs.insert(EVENT_RENDERER_RECREATED);
+    _internalCustomListenerHandles.insert(EventListener::internListenerID(EVENT_COME_TO_FOREGROUND));
+    _internalCustomListenerHandles.insert(EventListener::internListenerID(EVENT_COME_TO_BACKGROUND));
+    _internalCustomListenerHandles.insert(EventListener::internListenerID(EVENT_RENDERER_RECREATED));
 }
 
 EventDispatcher::~EventDispatcher()
 {
     // Clear internal custom listener IDs from set,
     // so removeAllEventListeners would clean internal custom listeners.
-    _internalCustomListenerIDs.clear();
+    _internalCustomListenerHandles.clear();
     removeAllEventListeners();
+
+    for (auto event : _customEventPool)
+    {
+        event->release();
+    }
 }
 
 void EventDispatcher::visitTarget(Node* node, bool isRootNode)
@@ -413,6 +430,12 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     }
 
     listeners->push_back(listener);
+
+    if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE
+        && static_cast<EventListenerTouchOneByOne*>(listener)->_hitTestEnabled)
+    {
+        _hitTestGrid.add(node);
+    }
 }
 
 void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener* listener)
@@ -426,6 +449,11 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         if (iter != listeners->end())
         {
             listeners->erase(iter);
+            if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE
+                && static_cast<EventListenerTouchOneByOne*>(listener)->_hitTestEnabled)
+            {
+                _hitTestGrid.remove(node);
+            }
         }
 
         if (listeners->empty())
@@ -438,6 +466,11 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
 
 void EventDispatcher::addEventListener(EventListener* listener)
 {
+    if (listener->_listenerHandle == EventListener::INVALID_HANDLE)
+    {
+        listener->_listenerHandle = EventListener::internListenerID(listener->getListenerID());
+    }
+
     if (_inDispatch == 0)
     {
         forceAddEventListener(listener);
@@ -458,24 +491,25 @@ void EventDispatcher::addEventListener(EventListener* listener)
 
 void EventDispatcher::forceAddEventListener(EventListener* listener)
 {
-    EventListenerVector* listeners = nullptr;
-    EventListener::ListenerID listenerID = listener->getListenerID();
-    auto itr = _listenerMap.find(listenerID);
-    if (itr == _listenerMap.end())
+    EventListener::ListenerHandle listenerHandle = listener->getListenerHandle();
+    if (listenerHandle >= _listeners.size())
     {
-        listeners = new (std::nothrow) EventListenerVector();
-        _listenerMap.insert(std::make_pair(listenerID, listeners));
+        _listeners.resize(listenerHandle + 1, nullptr);
+        _priorityDirtyFlags.resize(listenerHandle + 1, DirtyFlag::NONE);
     }
-    else
+
+    EventListenerVector* listeners = _listeners[listenerHandle];
+    if (listeners == nullptr)
     {
-        listeners = itr->second;
+        listeners = new (std::nothrow) EventListenerVector();
+        _listeners[listenerHandle] = listeners;
     }
 
     listeners->push_back(listener);
 
     if (listener->getFixedPriority() == 0)
     {
-        setDirty(listenerID, DirtyFlag::SCENE_GRAPH_PRIORITY);
+        setDirty(listenerHandle, DirtyFlag::SCENE_GRAPH_PRIORITY);
 
         auto node = listener->getAssociatedNode();
         CCASSERT(node != nullptr, "Invalid scene graph priority!");
@@ -489,7 +523,7 @@ void EventDispatcher::forceAddEventListener(EventListener* listener)
     }
     else
     {
-        setDirty(listenerID, DirtyFlag::FIXED_PRIORITY);
+        setDirty(listenerHandle, DirtyFlag::FIXED_PRIORITY);
     }
 }
 
@@ -518,9 +552,8 @@ void EventDispatcher::addEventListenerWithSceneGraphPriority(EventListener* list
 void EventDispatcher::debugCheckNodeHasNoEventListenersOnDestruction(Node* node)
 {
     // Check the listeners map
-    for (const auto & keyValuePair : _listenerMap)
+    for (const EventListenerVector * eventListenerVector : _listeners)
     {
-        const EventListenerVector * eventListenerVector = keyValuePair.second;
 
         if (eventListenerVector)
         {
@@ -644,9 +677,15 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         }
     };
 
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
+    // the listener may have been freed already, e.g. after removeAllEventListeners,
+    // so it is found by pointer before anything of it is read
+    for (size_t handle = 0; handle < _listeners.size() && !isFound; ++handle)
     {
-        auto listeners = iter->second;
+        auto listeners = _listeners[handle];
+        if (listeners == nullptr)
+            continue;
+
+        auto listenerHandle = static_cast<EventListener::ListenerHandle>(handle);
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
@@ -654,14 +693,14 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         if (isFound)
         {
             // fixed #4160: Dirty flag need to be updated after listeners were removed.
-            setDirty(listener->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+            setDirty(listenerHandle, DirtyFlag::SCENE_GRAPH_PRIORITY);
         }
         else
         {
             removeListenerInVector(fixedPriorityListeners);
             if (isFound)
             {
-                setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
+                setDirty(listenerHandle, DirtyFlag::FIXED_PRIORITY);
             }
         }
 
@@ -677,20 +716,10 @@ void EventDispatcher::removeEventListener(EventListener* listener)
                  "Listener should be in no lists after this is done if we're not currently in dispatch mode.");
 #endif
 
-        if (iter->second->empty())
-        {
-            _priorityDirtyFlagMap.erase(listener->getListenerID());
-            auto list = iter->second;
-            iter = _listenerMap.erase(iter);
-            CC_SAFE_DELETE(list);
-        }
-        else
+        if (isFound)
         {
-            ++iter;
+            releaseListenersIfEmpty(listenerHandle);
         }
-
-        if (isFound)
-            break;
     }
 
     if (isFound)
@@ -720,28 +749,26 @@ void EventDispatcher::setPriority(EventListener* listener, int fixedPriority)
     if (listener == nullptr)
         return;
 
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end(); ++iter)
+    auto listeners = getListeners(listener->getListenerHandle());
+    auto fixedPriorityListeners = listeners ? listeners->getFixedPriorityListeners() : nullptr;
+    if (fixedPriorityListeners)
     {
-        auto fixedPriorityListeners = iter->second->getFixedPriorityListeners();
-        if (fixedPriorityListeners)
+        auto found = std::find(fixedPriorityListeners->begin(), fixedPriorityListeners->end(), listener);
+        if (found != fixedPriorityListeners->end())
         {
-            auto found = std::find(fixedPriorityListeners->begin(), fixedPriorityListeners->end(), listener);
-            if (found != fixedPriorityListeners->end())
-            {
-                CCASSERT(listener->getAssociatedNode() == nullptr, "Can't set fixed priority with scene graph based listener.");
+            CCASSERT(listener->getAssociatedNode() == nullptr, "Can't set fixed priority with scene graph based listener.");
 
-                if (listener->getFixedPriority() != fixedPriority)
-                {
-                    listener->setFixedPriority(fixedPriority);
-                    setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
-                }
-                return;
+            if (listener->getFixedPriority() != fixedPriority)
+            {
+                listener->setFixedPriority(fixedPriority);
+                setDirty(listener->getListenerHandle(), DirtyFlag::FIXED_PRIORITY);
             }
         }
     }
 }
 
-void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent)
+template <typename Callback>
+void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, const Callback& onEvent)
 {
     bool shouldStopPropagation = false;
     auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
@@ -830,16 +857,14 @@ void EventDispatcher::dispatchEvent(Event* event)
         return;
     }
     
-    auto listenerID = __getListenerID(event);
+    auto listenerHandle = __getListenerHandle(event);
     
-    auto iter = _listenerMap.find(listenerID);
-    if (iter != _listenerMap.end())
+    auto listeners = getListeners(listenerHandle);
+    if (listeners)
     {
-        sortEventListeners(listenerID);
+        sortEventListeners(listenerHandle);
 
-        auto listeners = iter->second;
-
-        auto onEvent = [&event](EventListener* listener) -> bool{
+        auto onEvent = [event](EventListener* listener) -> bool{
             event->setCurrentTarget(listener->getAssociatedNode());
             listener->_onEvent(event);
             return event->isStopped();
@@ -858,15 +883,49 @@ void EventDispatcher::dispatchEvent(Event* event)
 
 void EventDispatcher::dispatchCustomEvent(const std::string &eventName, void *optionalUserData)
 {
-    EventCustom* ev = new EventCustom(eventName);
-    ev->setUserData(optionalUserData);
+    dispatchPooledCustomEvent(eventName, EventListener::findListenerHandle(eventName), optionalUserData);
+}
+
+void EventDispatcher::dispatchCustomEvent(EventListener::ListenerHandle eventHandle, void *optionalUserData)
+{
+    dispatchPooledCustomEvent(EventListener::getListenerIDOfHandle(eventHandle), eventHandle, optionalUserData);
+}
+
+void EventDispatcher::dispatchPooledCustomEvent(const std::string& eventName, EventListener::ListenerHandle eventHandle, void* userData)
+{
+    EventCustom* ev = nullptr;
+    if (_customEventPool.empty())
+    {
+        ev = new EventCustom(eventName);
+    }
+    else
+    {
+        ev = _customEventPool.back();
+        _customEventPool.pop_back();
+        ev->_eventName = eventName;
+        ev->_isStopped = false;
+        ev->_currentTarget = nullptr;
+    }
+    ev->_listenerHandle = eventHandle;
+    ev->setUserData(userData);
+
     dispatchEvent(ev);
-    ev->release();
+
+    // listeners may keep the event, then it can't be reused
+    if (ev->getReferenceCount() == 1)
+    {
+        ev->setUserData(nullptr);
+        _customEventPool.push_back(ev);
+    }
+    else
+    {
+        ev->release();
+    }
 }
 
 bool EventDispatcher::hasEventListener(const EventListener::ListenerID& listenerID) const
 {
-    auto listeners = getListeners(listenerID);
+    auto listeners = getListeners(EventListener::findListenerHandle(listenerID));
     if (listeners == nullptr)
         return false;
 
@@ -907,11 +966,13 @@ void EventDispatcher::setAfterDispatchEventHook(Event::Type type, const Dispatch
 
 void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 {
-    sortEventListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    sortEventListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    auto oneByOneHandle = __getListenerHandle<EventListenerTouchOneByOne>();
+    auto allAtOnceHandle = __getListenerHandle<EventListenerTouchAllAtOnce>();
+    sortEventListeners(oneByOneHandle);
+    sortEventListeners(allAtOnceHandle);
     
-    auto oneByOneListeners = getListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    auto allAtOnceListeners = getListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    auto oneByOneListeners = getListeners(oneByOneHandle);
+    auto allAtOnceListeners = getListeners(allAtOnceHandle);
     
     // If there aren't any touch listeners, return directly.
     if (nullptr == oneByOneListeners && nullptr == allAtOnceListeners)
@@ -935,6 +996,11 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
         {
             bool isSwallowed = false;
 
+            if (event->getEventCode() == EventTouch::EventCode::BEGAN && _hitTestGrid.getNodeCount() > 0)
+            {
+                _hitTestGrid.query((*touchesIter)->getLocation());
+            }
+
             auto onTouchEvent = [&](EventListener* l) -> bool { // Return true to break
                 EventListenerTouchOneByOne* listener = static_cast<EventListenerTouchOneByOne*>(l);
 
@@ -942,13 +1008,18 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 if (!listener->_isRegistered)
                     return false;
 
+                EventTouch::EventCode eventCode = event->getEventCode();
+
+                // Skip if the touch is outside the bounds of the listener's node.
+                if (eventCode == EventTouch::EventCode::BEGAN && listener->_hitTestEnabled
+                    && listener->_node && !_hitTestGrid.isCandidate(listener->_node))
+                    return false;
+
                 event->setCurrentTarget(listener->_node);
 
                 bool isClaimed = false;
                 std::vector<Touch*>::iterator removedIter;
 
-                EventTouch::EventCode eventCode = event->getEventCode();
-
                 if (eventCode == EventTouch::EventCode::BEGAN)
                 {
                     if (listener->onTouchBegan)
@@ -1101,14 +1172,12 @@ void EventDispatcher::updateListeners(Event* event)
     if (_inDispatch > 1)
         return;
 
-    auto onUpdateListeners = [this](const EventListener::ListenerID& listenerID)
+    auto onUpdateListeners = [this](EventListener::ListenerHandle listenerHandle)
     {
-        auto listenersIter = _listenerMap.find(listenerID);
-        if (listenersIter == _listenerMap.end())
+        auto listeners = getListeners(listenerHandle);
+        if (listeners == nullptr)
             return;
 
-        auto listeners = listenersIter->second;
-
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
@@ -1167,28 +1236,19 @@ void EventDispatcher::updateListeners(Event* event)
 
     if (event->getType() == Event::Type::TOUCH)
     {
-        onUpdateListeners(EventListenerTouchOneByOne::LISTENER_ID);
-        onUpdateListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+        onUpdateListeners(__getListenerHandle<EventListenerTouchOneByOne>());
+        onUpdateListeners(__getListenerHandle<EventListenerTouchAllAtOnce>());
     }
     else
     {
-        onUpdateListeners(__getListenerID(event));
+        onUpdateListeners(__getListenerHandle(event));
     }
 
     CCASSERT(_inDispatch == 1, "_inDispatch should be 1 here.");
 
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
+    for (EventListener::ListenerHandle handle = 0; handle < _listeners.size(); ++handle)
     {
-        if (iter->second->empty())
-        {
-            _priorityDirtyFlagMap.erase(iter->first);
-            delete iter->second;
-            iter = _listenerMap.erase(iter);
-        }
-        else
-        {
-            ++iter;
-        }
+        releaseListenersIfEmpty(handle);
     }
 
     if (!_toAddedListeners.empty())
@@ -1217,7 +1277,7 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
             {
                 for (auto& l : *iter->second)
                 {
-                    setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+                    setDirty(l->getListenerHandle(), DirtyFlag::SCENE_GRAPH_PRIORITY);
                 }
             }
         }
@@ -1226,24 +1286,23 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
     }
 }
 
-void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListeners(EventListener::ListenerHandle listenerHandle)
 {
     DirtyFlag dirtyFlag = DirtyFlag::NONE;
 
-    auto dirtyIter = _priorityDirtyFlagMap.find(listenerID);
-    if (dirtyIter != _priorityDirtyFlagMap.end())
+    if (listenerHandle < _priorityDirtyFlags.size())
     {
-        dirtyFlag = dirtyIter->second;
+        dirtyFlag = _priorityDirtyFlags[listenerHandle];
     }
 
     if (dirtyFlag != DirtyFlag::NONE)
     {
         // Clear the dirty flag first, if `rootNode` is nullptr, then set its dirty flag of scene graph priority
-        dirtyIter->second = DirtyFlag::NONE;
+        _priorityDirtyFlags[listenerHandle] = DirtyFlag::NONE;
 
         if ((int)dirtyFlag & (int)DirtyFlag::FIXED_PRIORITY)
         {
-            sortEventListenersOfFixedPriority(listenerID);
+            sortEventListenersOfFixedPriority(listenerHandle);
         }
 
         if ((int)dirtyFlag & (int)DirtyFlag::SCENE_GRAPH_PRIORITY)
@@ -1251,19 +1310,19 @@ void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listen
             auto rootNode = SharedDirector.getRunningScene();
             if (rootNode)
             {
-                sortEventListenersOfSceneGraphPriority(listenerID, rootNode);
+                sortEventListenersOfSceneGraphPriority(listenerHandle, rootNode);
             }
             else
             {
-                dirtyIter->second = DirtyFlag::SCENE_GRAPH_PRIORITY;
+                _priorityDirtyFlags[listenerHandle] = DirtyFlag::SCENE_GRAPH_PRIORITY;
             }
         }
     }
 }
 
-void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode)
+void EventDispatcher::sortEventListenersOfSceneGraphPriority(EventListener::ListenerHandle listenerHandle, Node* rootNode)
 {
-    auto listeners = getListeners(listenerID);
+    auto listeners = getListeners(listenerHandle);
 
     if (listeners == nullptr)
         return;
@@ -1292,9 +1351,9 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
 #endif
 }
 
-void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListenersOfFixedPriority(EventListener::ListenerHandle listenerHandle)
 {
-    auto listeners = getListeners(listenerID);
+    auto listeners = getListeners(listenerHandle);
 
     if (listeners == nullptr)
         return;
@@ -1329,23 +1388,25 @@ void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::Lis
 
 }
 
-EventDispatcher::EventListenerVector* EventDispatcher::getListeners(const EventListener::ListenerID& listenerID) const
+void EventDispatcher::releaseListenersIfEmpty(EventListener::ListenerHandle listenerHandle)
 {
-    auto iter = _listenerMap.find(listenerID);
-    if (iter != _listenerMap.end())
+    auto listeners = getListeners(listenerHandle);
+    if (listeners && listeners->empty())
     {
-        return iter->second;
+        _priorityDirtyFlags[listenerHandle] = DirtyFlag::NONE;
+        _listeners[listenerHandle] = nullptr;
+        delete listeners;
     }
-
-    return nullptr;
 }
 
-void EventDispatcher::removeEventListenersForListenerID(const EventListener::ListenerID& listenerID)
+void EventDispatcher::removeEventListenersForListenerID(EventListener::ListenerHandle listenerHandle)
 {
-    auto listenerItemIter = _listenerMap.find(listenerID);
-    if (listenerItemIter != _listenerMap.end())
+    if (listenerHandle == EventListener::INVALID_HANDLE)
+        return;
+
+    auto listeners = getListeners(listenerHandle);
+    if (listeners)
     {
-        auto listeners = listenerItemIter->second;
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
@@ -1380,21 +1441,19 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
 
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
-        if (_priorityDirtyFlagMap.find(listenerID) != _priorityDirtyFlagMap.end()) {
-            _priorityDirtyFlagMap.erase(listenerID);
-        }
+        _priorityDirtyFlags[listenerHandle] = DirtyFlag::NONE;
 
         if (!_inDispatch)
         {
             listeners->clear();
             delete listeners;
-            _listenerMap.erase(listenerItemIter);
+            _listeners[listenerHandle] = nullptr;
         }
     }
 
     for (auto iter = _toAddedListeners.begin(); iter != _toAddedListeners.end();)
     {
-        if ((*iter)->getListenerID() == listenerID)
+        if ((*iter)->getListenerHandle() == listenerHandle)
         {
             (*iter)->setRegistered(false);
             releaseListener(*iter);
@@ -1411,23 +1470,23 @@ void EventDispatcher::removeEventListenersForType(EventListener::Type listenerTy
 {
     if (listenerType == EventListener::Type::TOUCH_ONE_BY_ONE)
     {
-        removeEventListenersForListenerID(EventListenerTouchOneByOne::LISTENER_ID);
+        removeEventListenersForListenerID(__getListenerHandle<EventListenerTouchOneByOne>());
     }
     else if (listenerType == EventListener::Type::TOUCH_ALL_AT_ONCE)
     {
-        removeEventListenersForListenerID(EventListenerTouchAllAtOnce::LISTENER_ID);
+        removeEventListenersForListenerID(__getListenerHandle<EventListenerTouchAllAtOnce>());
     }
     else if (listenerType == EventListener::Type::MOUSE)
     {
-        removeEventListenersForListenerID(EventListenerMouse::LISTENER_ID);
+        removeEventListenersForListenerID(__getListenerHandle<EventListenerMouse>());
     }
     else if (listenerType == EventListener::Type::ACCELERATION)
     {
-        removeEventListenersForListenerID(EventListenerAcceleration::LISTENER_ID);
+        removeEventListenersForListenerID(__getListenerHandle<EventListenerAcceleration>());
     }
     else if (listenerType == EventListener::Type::KEYBOARD)
     {
-        removeEventListenersForListenerID(EventListenerKeyboard::LISTENER_ID);
+        removeEventListenersForListenerID(__getListenerHandle<EventListenerKeyboard>());
     }
     else
     {
@@ -1437,35 +1496,32 @@ void EventDispatcher::removeEventListenersForType(EventListener::Type listenerTy
 
 void EventDispatcher::removeCustomEventListeners(const std::string& customEventName)
 {
-    removeEventListenersForListenerID(customEventName);
+    removeEventListenersForListenerID(EventListener::findListenerHandle(customEventName));
 }
 
 void EventDispatcher::removeAllEventListeners()
 {
     bool cleanMap = true;
-    std::vector<EventListener::ListenerID> types;
-    types.reserve(_listenerMap.size());
-    
-    for (const auto& e : _listenerMap)
+
+    for (EventListener::ListenerHandle handle = 0; handle < _listeners.size(); ++handle)
     {
-        if (_internalCustomListenerIDs.find(e.first) != _internalCustomListenerIDs.end())
+        if (_listeners[handle] == nullptr)
+            continue;
+
+        if (_internalCustomListenerHandles.find(handle) != _internalCustomListenerHandles.end())
         {
             cleanMap = false;
         }
         else
         {
-            types.push_back(e.first);
+            removeEventListenersForListenerID(handle);
         }
     }
 
-    for (const auto& type : types)
-    {
-        removeEventListenersForListenerID(type);
-    }
-
     if (!_inDispatch && cleanMap)
     {
-        _listenerMap.clear();
+        _listeners.clear();
+        _priorityDirtyFlags.clear();
     }
 }
 
@@ -1495,33 +1551,25 @@ void EventDispatcher::setDirtyForNode(Node* node)
     }
 }
 
-void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag)
-{    
-    auto iter = _priorityDirtyFlagMap.find(listenerID);
-    if (iter == _priorityDirtyFlagMap.end())
-    {
-        _priorityDirtyFlagMap.insert(std::make_pair(listenerID, flag));
-    }
-    else
-    {
-        int ret = (int)flag | (int)iter->second;
-        iter->second = (DirtyFlag) ret;
-    }
+void EventDispatcher::setDirty(EventListener::ListenerHandle listenerHandle, DirtyFlag flag)
+{
+    CCASSERT(listenerHandle < _priorityDirtyFlags.size(), "The listener ID has never been added.");
+    int ret = (int)flag | (int)_priorityDirtyFlags[listenerHandle];
+    _priorityDirtyFlags[listenerHandle] = (DirtyFlag) ret;
 }
 
 void EventDispatcher::cleanToRemovedListeners()
 {
     for (auto& l : _toRemovedListeners)
     {
-        auto listenersIter = _listenerMap.find(l->getListenerID());
-        if (listenersIter == _listenerMap.end())
+        auto listeners = getListeners(l->getListenerHandle());
+        if (listeners == nullptr)
         {
             releaseListener(l);
             continue;
         }
 
         bool find = false;
-        auto listeners = listenersIter->second;
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
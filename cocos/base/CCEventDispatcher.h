@@ -28,6 +28,7 @@
 
 #include "base/CCEventListener.h"
 #include "base/CCEvent.h"
+#include "base/CCHitTestGrid.h"
 
 /**
  * @addtogroup base
@@ -170,6 +171,15 @@ public:
      */
     void dispatchCustomEvent(const std::string &eventName, void *optionalUserData = nullptr);
 
+    /** Dispatches a Custom Event by the handle of its name.
+     *  Events sent every frame can keep the handle of EventListener::internListenerID(eventName)
+     *  and skip hashing the name, the event itself is reused between calls.
+     *
+     * @param eventHandle The interned name of the event which needs to be dispatched.
+     * @param optionalUserData The optional user data, it's a void*, the default value is nullptr.
+     */
+    void dispatchCustomEvent(EventListener::ListenerHandle eventHandle, void *optionalUserData = nullptr);
+
     /** Query whether the specified event listener id has been added.
      *
      * @param listenerID The listenerID of the event listener id.
@@ -206,6 +216,9 @@ protected:
 
     /** Sets the dirty flag for a node. */
     void setDirtyForNode(Node* node);
+
+    /** The world bounds of a node in the hit test grid changed. */
+    inline void invalidateHitBounds(Node* node) { _hitTestGrid.invalidate(node); }
     COCOS_TYPE_OVERRIDE(EventDispatcher);
 
     /**
@@ -247,22 +260,28 @@ protected:
     void forceAddEventListener(EventListener* listener);
 
     /** Gets event the listener list for the event listener type. */
-    EventListenerVector* getListeners(const EventListener::ListenerID& listenerID) const;
+    inline EventListenerVector* getListeners(EventListener::ListenerHandle listenerHandle) const
+    {
+        return listenerHandle < _listeners.size() ? _listeners[listenerHandle] : nullptr;
+    }
 
     /** Update dirty flag */
     void updateDirtyFlagForSceneGraph();
 
     /** Removes all listeners with the same event listener ID */
-    void removeEventListenersForListenerID(const EventListener::ListenerID& listenerID);
+    void removeEventListenersForListenerID(EventListener::ListenerHandle listenerHandle);
+
+    /** Deletes the listener list of a listener ID once it is empty */
+    void releaseListenersIfEmpty(EventListener::ListenerHandle listenerHandle);
 
     /** Sort event listener */
-    void sortEventListeners(const EventListener::ListenerID& listenerID);
+    void sortEventListeners(EventListener::ListenerHandle listenerHandle);
 
     /** Sorts the listeners of specified type by scene graph priority */
-    void sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode);
+    void sortEventListenersOfSceneGraphPriority(EventListener::ListenerHandle listenerHandle, Node* rootNode);
 
     /** Sorts the listeners of specified type by fixed priority */
-    void sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID);
+    void sortEventListenersOfFixedPriority(EventListener::ListenerHandle listenerHandle);
 
     /** Updates all listeners
      *  1) Removes all listener items that have been marked as 'removed' when dispatching event.
@@ -279,8 +298,14 @@ protected:
     /** Dissociates node with event listener */
     void dissociateNodeAndEventListener(Node* node, EventListener* listener);
 
-    /** Dispatches event to listeners with a specified listener type */
-    void dispatchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent);
+    /** Dispatches event to listeners with a specified listener type
+     *  onEvent is called as bool(EventListener*), returning true stops the propagation.
+     */
+    template <typename Callback>
+    void dispatchEventToListeners(EventListenerVector* listeners, const Callback& onEvent);
+
+    /** Dispatches a custom event taken from _customEventPool */
+    void dispatchPooledCustomEvent(const std::string& eventName, EventListener::ListenerHandle eventHandle, void* userData);
 
     void releaseListener(EventListener* listener);
 
@@ -294,7 +319,7 @@ protected:
     };
 
     /** Sets the dirty flag for a specified listener ID */
-    void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
+    void setDirty(EventListener::ListenerHandle listenerHandle, DirtyFlag flag);
 
     /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
     void visitTarget(Node* node, bool isRootNode);
@@ -302,11 +327,11 @@ protected:
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
 
-    /** Listeners map */
-    std::unordered_map<EventListener::ListenerID, EventListenerVector*> _listenerMap;
+    /** Listeners indexed by listener handle, nullptr for the IDs without listeners */
+    std::vector<EventListenerVector*> _listeners;
 
-    /** The map of dirty flag */
-    std::unordered_map<EventListener::ListenerID, DirtyFlag> _priorityDirtyFlagMap;
+    /** Dirty flags indexed by listener handle */
+    std::vector<DirtyFlag> _priorityDirtyFlags;
 
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
@@ -326,7 +351,13 @@ protected:
     /** The nodes were associated with scene graph based priority listeners */
     std::set<Node*> _dirtyNodes;
 
-    std::set<std::string> _internalCustomListenerIDs;
+    /** The nodes of the touch listeners that hit test their node's content rect */
+    HitTestGrid _hitTestGrid;
+
+    std::set<EventListener::ListenerHandle> _internalCustomListenerHandles;
+
+    /** Custom events reused by dispatchCustomEvent, unless a listener kept them */
+    std::vector<EventCustom*> _customEventPool;
 
     static const int MAX_EVENT_TYPE = (int)Event::Type::CUSTOM + 1;
     DispatchEventHook _beforeDispatchEventHooks[MAX_EVENT_TYPE];
@@ -28,7 +28,53 @@
 
 NS_CC_BEGIN
 
+namespace
+{
+
+struct ListenerIDTable
+{
+    std::unordered_map<EventListener::ListenerID, EventListener::ListenerHandle> handles;
+    // keys of handles, the nodes of an unordered_map don't move
+    std::vector<const EventListener::ListenerID*> listenerIDs;
+};
+
+ListenerIDTable& getListenerIDTable()
+{
+    static ListenerIDTable table;
+    return table;
+}
+
+}
+
+const EventListener::ListenerHandle EventListener::INVALID_HANDLE;
+
+EventListener::ListenerHandle EventListener::internListenerID(const ListenerID& listenerID)
+{
+    ListenerIDTable& table = getListenerIDTable();
+    auto result = table.handles.insert(std::make_pair(listenerID, static_cast<ListenerHandle>(table.listenerIDs.size())));
+    if (result.second)
+    {
+        table.listenerIDs.push_back(&result.first->first);
+    }
+    return result.first->second;
+}
+
+EventListener::ListenerHandle EventListener::findListenerHandle(const ListenerID& listenerID)
+{
+    const ListenerIDTable& table = getListenerIDTable();
+    auto it = table.handles.find(listenerID);
+    return it != table.handles.end() ? it->second : INVALID_HANDLE;
+}
+
+const EventListener::ListenerID& EventListener::getListenerIDOfHandle(ListenerHandle handle)
+{
+    const ListenerIDTable& table = getListenerIDTable();
+    CCASSERT(handle < table.listenerIDs.size(), "Invalid listener handle");
+    return *table.listenerIDs[handle];
+}
+
 EventListener::EventListener()
+: _listenerHandle(INVALID_HANDLE)
 {}
     
 EventListener::~EventListener() 
@@ -41,6 +87,7 @@ bool EventListener::init(Type t, const ListenerID& listenerID, const std::functi
     _onEvent = callback;
     _type = t;
     _listenerID = listenerID;
+    _listenerHandle = INVALID_HANDLE;
     _isRegistered = false;
     _paused = false;
     _isEnabled = true;
@@ -60,6 +60,23 @@ public:
 
     typedef std::string ListenerID;
 
+    /** Interned ListenerID, the listeners and events of the same ID share the same handle.
+     *  Handles are small consecutive numbers, EventDispatcher uses them as indices.
+     */
+    typedef uint32_t ListenerHandle;
+    static const ListenerHandle INVALID_HANDLE = UINT32_MAX;
+
+    /** Gets the handle of listenerID, creating it the first time the ID is seen.
+     *  @note Handles are never released, only call it from the cocos thread.
+     */
+    static ListenerHandle internListenerID(const ListenerID& listenerID);
+
+    /** Gets the handle of listenerID, INVALID_HANDLE if it was never interned. */
+    static ListenerHandle findListenerHandle(const ListenerID& listenerID);
+
+    /** Gets the ListenerID of a handle returned by internListenerID. */
+    static const ListenerID& getListenerIDOfHandle(ListenerHandle handle);
+
 CC_CONSTRUCTOR_ACCESS:
     /**
      * Constructor
@@ -135,6 +152,9 @@ protected:
      */
     inline const ListenerID& getListenerID() const { return _listenerID; };
 
+    /** Gets the interned listener ID, set when the listener is added to EventDispatcher */
+    inline ListenerHandle getListenerHandle() const { return _listenerHandle; };
+
     /** Sets the fixed priority for this listener
      *  @note This method is only used for `fixed priority listeners`, it needs to access a non-zero value.
      *  0 is reserved for scene graph priority listeners
@@ -161,6 +181,7 @@ protected:
 
     Type _type;                             /// Event listener type
     ListenerID _listenerID;                 /// Event listener ID
+    ListenerHandle _listenerHandle;         /// Interned _listenerID
     bool _isRegistered;                     /// Whether the listener has been added to dispatcher.
 
     int   _fixedPriority;   // The higher the number, the higher the priority, 0 is for scene graph base priority.
@@ -37,6 +37,7 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _hitTestEnabled(false)
 {
 }
 
@@ -65,6 +66,21 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setHitTestEnabled(bool enabled)
+{
+    // the dispatcher indexes the node when the listener is added
+    CCASSERT(!_isRegistered, "setHitTestEnabled must be called before the listener is added");
+    if (!_isRegistered)
+    {
+        _hitTestEnabled = enabled;
+    }
+}
+
+bool EventListenerTouchOneByOne::isHitTestEnabled() const
+{
+    return _hitTestEnabled;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new (std::nothrow) EventListenerTouchOneByOne();
@@ -106,6 +122,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
 
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_hitTestEnabled = _hitTestEnabled;
     }
     else
     {
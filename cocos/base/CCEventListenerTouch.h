@@ -67,6 +67,15 @@ public:
      */
     bool isSwallowTouches();
 
+    /** Tells that onTouchBegan only claims touches inside the content rect of the associated node.
+     * The dispatcher then skips the listener for touches outside the node's bounds without calling it.
+     * Must be set before the listener is added.
+     *
+     * @param enabled True if touches outside the node never begin.
+     */
+    void setHitTestEnabled(bool enabled);
+    bool isHitTestEnabled() const;
+
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
     virtual bool checkAvailable() override;
@@ -89,6 +98,7 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _hitTestEnabled;
 
     friend class EventDispatcher;
 };
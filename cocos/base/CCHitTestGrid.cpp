@@ -0,0 +1,193 @@
+#include "ccHeader.h"
+#include "base/CCHitTestGrid.h"
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // a full screen panel at the default cell size spans about 150 cells
+    const int MaxCellsPerNode = 256;
+}
+
+HitTestGrid::HitTestGrid(float cellSize)
+    :cellSize_(cellSize)
+    ,stamp_(0)
+{
+}
+
+HitTestGrid::~HitTestGrid()
+{
+    for (const auto& item : entries_)
+    {
+        item.first->flags_.setOff(Node::HitTestIndexed);
+        item.first->addHitTestCount(-1);
+    }
+}
+
+void HitTestGrid::add(Node* node)
+{
+    auto result = entries_.emplace(node, Entry());
+    Entry& entry = result.first->second;
+    if (result.second)
+    {
+        entry.refs = 0;
+        entry.stale = true;
+        entry.placed = false;
+        entry.large = false;
+        entry.minX = entry.minY = entry.maxX = entry.maxY = 0;
+        entry.stamp = 0;
+        staleNodes_.push_back(node);
+        node->flags_.setOn(Node::HitTestIndexed);
+        node->addHitTestCount(1);
+    }
+    entry.refs++;
+}
+
+void HitTestGrid::remove(Node* node)
+{
+    auto it = entries_.find(node);
+    if (it == entries_.end() || --it->second.refs > 0)
+    {
+        return;
+    }
+    unplace(node, it->second);
+    entries_.erase(it);
+    node->flags_.setOff(Node::HitTestIndexed);
+    node->addHitTestCount(-1);
+}
+
+void HitTestGrid::invalidate(Node* node)
+{
+    auto it = entries_.find(node);
+    if (it != entries_.end() && !it->second.stale)
+    {
+        it->second.stale = true;
+        staleNodes_.push_back(node);
+    }
+}
+
+void HitTestGrid::query(const Vec2& point)
+{
+    CC_TRACE_SCOPE("HitTestGrid::query");
+    for (Node* node : staleNodes_)
+    {
+        // removed nodes are skipped, stale entries may be listed more than once
+        auto it = entries_.find(node);
+        if (it != entries_.end() && it->second.stale)
+        {
+            refresh(node, it->second);
+        }
+    }
+    staleNodes_.clear();
+
+    if (++stamp_ == 0)
+    {
+        ++stamp_;
+    }
+    int x = static_cast<int>(floorf(point.x / cellSize_));
+    int y = static_cast<int>(floorf(point.y / cellSize_));
+    auto cell = cells_.find(getCellKey(x, y));
+    if (cell != cells_.end())
+    {
+        for (Node* node : cell->second)
+        {
+            entries_[node].stamp = stamp_;
+        }
+    }
+    for (Node* node : largeNodes_)
+    {
+        entries_[node].stamp = stamp_;
+    }
+}
+
+bool HitTestGrid::isCandidate(Node* node) const
+{
+    auto it = entries_.find(node);
+    if (it == entries_.end() || it->second.stale)
+    {
+        return true;
+    }
+    // resized since its last visit, the bounds may be out of date, moves of the node
+    // or of an ancestor have already invalidated the entry, see Node::markDirty
+    if (node->_contentSizeDirty)
+    {
+        return true;
+    }
+    return it->second.stamp == stamp_;
+}
+
+void HitTestGrid::refresh(Node* node, Entry& entry)
+{
+    unplace(node, entry);
+    entry.stale = false;
+
+    const Size& size = node->getContentSize();
+    Rect bounds = RectApplyTransform(Rect(0, 0, size.width, size.height), node->getNodeToWorldTransform());
+    float minX = floorf(bounds.getMinX() / cellSize_);
+    float minY = floorf(bounds.getMinY() / cellSize_);
+    float maxX = floorf(bounds.getMaxX() / cellSize_);
+    float maxY = floorf(bounds.getMaxY() / cellSize_);
+    // also catches infinite and NaN bounds, and bounds too far out for int cells
+    const float limit = 1e6f;
+    entry.large = !((maxX - minX + 1) * (maxY - minY + 1) <= MaxCellsPerNode
+        && minX >= -limit && minY >= -limit && maxX <= limit && maxY <= limit);
+    if (!entry.large)
+    {
+        entry.minX = static_cast<int>(minX);
+        entry.minY = static_cast<int>(minY);
+        entry.maxX = static_cast<int>(maxX);
+        entry.maxY = static_cast<int>(maxY);
+    }
+    place(node, entry);
+}
+
+void HitTestGrid::place(Node* node, Entry& entry)
+{
+    if (entry.large)
+    {
+        largeNodes_.push_back(node);
+    }
+    else
+    {
+        for (int y = entry.minY; y <= entry.maxY; y++)
+        {
+            for (int x = entry.minX; x <= entry.maxX; x++)
+            {
+                cells_[getCellKey(x, y)].push_back(node);
+            }
+        }
+    }
+    entry.placed = true;
+}
+
+void HitTestGrid::unplace(Node* node, Entry& entry)
+{
+    if (!entry.placed)
+    {
+        return;
+    }
+    entry.placed = false;
+    if (entry.large)
+    {
+        largeNodes_.erase(std::find(largeNodes_.begin(), largeNodes_.end(), node));
+        return;
+    }
+    for (int y = entry.minY; y <= entry.maxY; y++)
+    {
+        for (int x = entry.minX; x <= entry.maxX; x++)
+        {
+            auto cell = cells_.find(getCellKey(x, y));
+            std::vector<Node*>& nodes = cell->second;
+            auto it = std::find(nodes.begin(), nodes.end(), node);
+            *it = nodes.back();
+            nodes.pop_back();
+            if (nodes.empty())
+            {
+                cells_.erase(cell);
+            }
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "math/CCGeometry.h"
+#include <unordered_map>
+
+NS_CC_BEGIN
+
+class Node;
+
+/** @brief Broad phase of touch hit testing.
+ A uniform grid over the world bounding boxes of the nodes of the touch
+ listeners that hit test their node's content rect. Nodes tell the grid
+ when visit recomputes their world transform, and when they or one of
+ their ancestors are moved or reparented in between. Their bounds are only
+ computed again before the next query, so nodes that move every frame
+ cost a lookup per frame. query() marks the nodes whose bounds contain
+ the point, touches can skip the listeners of the other nodes.
+ */
+
+class CC_DLL HitTestGrid
+{
+public:
+    explicit HitTestGrid(float cellSize = 128.0f);
+    virtual ~HitTestGrid();
+
+    /** Indexes node, add and remove calls are counted per node. */
+    void add(Node* node);
+    void remove(Node* node);
+
+    /** The world transform or the content size of node changed. */
+    void invalidate(Node* node);
+
+    /** Marks the nodes that may contain point, the previous query is forgotten. */
+    void query(const Vec2& point);
+
+    /** Whether node may contain the point of the last query, always true for nodes the grid doesn't index. */
+    bool isCandidate(Node* node) const;
+
+    inline int getNodeCount() const { return static_cast<int>(entries_.size()); }
+private:
+    struct Entry
+    {
+        int refs;
+        bool stale;
+        bool placed;
+        bool large;
+        int minX, minY, maxX, maxY;
+        uint32_t stamp;
+    };
+
+    void refresh(Node* node, Entry& entry);
+    void place(Node* node, Entry& entry);
+    void unplace(Node* node, Entry& entry);
+    inline static uint64_t getCellKey(int x, int y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+private:
+    float cellSize_;
+    uint32_t stamp_;
+    std::unordered_map<Node*, Entry> entries_;
+    std::unordered_map<uint64_t, std::vector<Node*>> cells_;
+    // nodes spanning too many cells, always tested
+    std::vector<Node*> largeNodes_;
+    std::vector<Node*> staleNodes_;
+};
+
+NS_CC_END
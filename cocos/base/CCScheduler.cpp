@@ -27,45 +27,37 @@ THE SOFTWARE.
 #include "ccHeader.h"
 #include "base/CCScheduler.h"
 #include "base/CCDirector.h"
-#include "base/utlist.h"
-#include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
 
 NS_CC_BEGIN
 
 // data structures
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
+// Timers of one target, for "selectors with interval"
+typedef struct _timerTargetEntry
 {
-    struct _listEntry   *prev, *next;
-    ccSchedulerFunc     callback;
     void                *target;
-    int                 priority;
+    std::vector<SmartPtr<Timer>> timers;
     bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
+} tTimerTargetEntry;
 
-typedef struct _hashUpdateEntry
+namespace
 {
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    void                *target;
-    ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
-
-// Hash Element used for "selectors with interval"
-typedef struct _hashSelectorEntry
-{
-    ccArray             *timers;
-    void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                currentTimerSalvaged;
-    bool                paused;
-    UT_hash_handle      hh;
-} tHashTimerEntry;
+    // the timer wheel counts time in ticks of about a millisecond
+    const double WheelTicksPerSecond = 1024.0;
+    const int WheelBits = 8;
+    const int WheelLevelBits = 6;
+    const int WheelLevels = 4;
+    const uint64_t WheelSize = 1 << WheelBits;
+    const uint64_t WheelLevelSize = 1 << WheelLevelBits;
+    // timers further away are parked in the last level and checked again when it comes around
+    const uint64_t WheelMaxDelta = (uint64_t(1) << (WheelBits + WheelLevels * WheelLevelBits)) - 1;
+
+    // Timer::_slot of timers outside the wheel
+    const int TimerEveryFrame = -1;
+    const int TimerParked = -2;
+    const int TimerDetached = -3;
+}
 
 class FuncWrapper : public Ref
 {
@@ -75,12 +67,10 @@ public:
         return func(deltaTime);
     }
     std::function<bool(float)> func;
-    tHashTimerEntry* entry;
     CREATE_FUNC(FuncWrapper);
 protected:
     FuncWrapper(const std::function<bool (float)>& func)
         :func(func)
-        ,entry(nullptr)
     {}
     COCOS_TYPE_OVERRIDE(FuncWrapper);
 };
@@ -96,6 +86,11 @@ Timer::Timer()
 , _repeat(0)
 , _delay(0.0f)
 , _interval(0.0f)
+, _owner(nullptr)
+, _wheelTime(0.0)
+, _deadline(0.0)
+, _slot(TimerDetached)
+, _index(-1)
 {
 }
 
@@ -257,6 +252,7 @@ void TimerScriptHandler::cancel()
 
 #endif
 
+
 // implementation of Scheduler
 
 // Priority level reserved for system services.
@@ -267,14 +263,13 @@ const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
 Scheduler::Scheduler(void)
 : _timeScale(1.0f)
-, _updatesNegList(nullptr)
-, _updates0List(nullptr)
-, _updatesPosList(nullptr)
-, _hashForUpdates(nullptr)
-, _hashForTimers(nullptr)
+, _updatesDirty(false)
 , _currentTarget(nullptr)
 , _currentTargetSalvaged(false)
 , _updateHashLocked(false)
+, _time(0.0)
+, _wheelTick(0)
+, _frameTimersDirty(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
@@ -288,13 +283,6 @@ Scheduler::~Scheduler(void)
     unscheduleAll();
 }
 
-void Scheduler::removeHashElement(_hashSelectorEntry *element)
-{
-    ccArrayFree(element->timers);
-    HASH_DEL(_hashForTimers, element);
-    free(element);
-}
-
 void Scheduler::schedule(const std::function<bool(float)>& handler)
 {
     //the functionWrappers container is a little redundent, how to remove it?
@@ -313,47 +301,39 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
     CCASSERT(target, "Argument target must be non-nullptr");
     CCASSERT(!key.empty(), "key should not be empty!");
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    tTimerTargetEntry *element = nullptr;
+    auto it = _timerTargets.find(target);
 
-    if (! element)
+    if (it == _timerTargets.end())
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
+        element = new (std::nothrow) tTimerTargetEntry();
         element->target = target;
 
-        HASH_ADD_PTR(_hashForTimers, target, element);
-
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
+        _timerTargets.emplace(target, element);
     }
     else
     {
+        element = it->second;
         CCASSERT(element->paused == paused, "element's paused should be paused!");
-    }
 
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else
-    {
-        for (int i = 0; i < element->timers->num; ++i)
+        for (const auto& item : element->timers)
         {
-            TimerTargetCallback *timer = CocosCast<TimerTargetCallback>(element->timers->arr[i]);
+            TimerTargetCallback *timer = CocosCast<TimerTargetCallback>(item.get());
 
             if (timer && key == timer->getKey())
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
-                timer->setInterval(interval);
+                setTimerInterval(timer, interval);
                 return;
             }
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
 
     TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -365,174 +345,149 @@ void Scheduler::unschedule(const std::string &key, void *target)
         return;
     }
 
-    //CCASSERT(target);
-    //CCASSERT(selector);
-
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (element)
+    auto it = _timerTargets.find(target);
+    if (it != _timerTargets.end())
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        tTimerTargetEntry *element = it->second;
+        for (size_t i = 0; i < element->timers.size(); ++i)
         {
-            TimerTargetCallback *timer = CocosCast<TimerTargetCallback>(element->timers->arr[i]);
+            TimerTargetCallback *timer = CocosCast<TimerTargetCallback>(element->timers[i].get());
 
             if (timer && key == timer->getKey())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-
+                removeTimer(element, i);
                 return;
             }
         }
     }
 }
 
-void Scheduler::priorityIn(tListEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused)
+Scheduler::UpdateEntry* Scheduler::findUpdate(void* target)
 {
-    tListEntry *listElement = new (std::nothrow) tListEntry();
-
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->priority = priority;
-    listElement->paused = paused;
-    listElement->next = listElement->prev = nullptr;
-    listElement->markedForDeletion = false;
+    auto it = _updateIndex.find(target);
+    if (it == _updateIndex.end())
+    {
+        return nullptr;
+    }
+    return it->second >= 0 ? &_updates[it->second] : &_pendingUpdates[-1 - it->second];
+}
 
-    // empty list ?
-    if (! *list)
+void Scheduler::flushUpdates()
+{
+    if (_updateHashLocked || (!_updatesDirty && _pendingUpdates.empty()))
     {
-        DL_APPEND(*list, listElement);
+        return;
     }
-    else
+
+    // a marked entry may have been replaced by a pending one of the same target meanwhile
+    auto forget = [this](const UpdateEntry& entry, int index)
     {
-        bool added = false;
+        auto it = _updateIndex.find(entry.target);
+        if (it != _updateIndex.end() && it->second == index)
+        {
+            _updateIndex.erase(it);
+        }
+    };
 
-        for (tListEntry *element = *list; element; element = element->next)
+    // compact, only the entries after a removed one move
+    size_t count = 0;
+    for (size_t i = 0; i < _updates.size(); i++)
+    {
+        if (_updates[i].markedForDeletion)
         {
-            if (priority < element->priority)
+            forget(_updates[i], static_cast<int>(i));
+        }
+        else
+        {
+            if (count != i)
             {
-                if (element == *list)
-                {
-                    DL_PREPEND(*list, listElement);
-                }
-                else
-                {
-                    listElement->next = element;
-                    listElement->prev = element->prev;
+                _updates[count] = std::move(_updates[i]);
+                _updateIndex[_updates[count].target] = static_cast<int>(count);
+            }
+            count++;
+        }
+    }
+    _updates.resize(count);
 
-                    element->prev->next = listElement;
-                    element->prev = listElement;
+    if (!_pendingUpdates.empty())
+    {
+        size_t pendingCount = 0;
+        for (size_t i = 0; i < _pendingUpdates.size(); i++)
+        {
+            if (_pendingUpdates[i].markedForDeletion)
+            {
+                forget(_pendingUpdates[i], -1 - static_cast<int>(i));
+            }
+            else
+            {
+                if (pendingCount != i)
+                {
+                    _pendingUpdates[pendingCount] = std::move(_pendingUpdates[i]);
                 }
-
-                added = true;
-                break;
+                pendingCount++;
             }
         }
+        _pendingUpdates.resize(pendingCount);
 
-        // Not added? priority has the higher value. Append it.
-        if (! added)
+        // stable, new entries go after the scheduled ones of the same priority
+        std::stable_sort(_pendingUpdates.begin(), _pendingUpdates.end(), [](const UpdateEntry& a, const UpdateEntry& b)
+        {
+            return a.priority < b.priority;
+        });
+
+        // merged from the back, the scheduled entries before the first new one stay where they are
+        int scheduled = static_cast<int>(_updates.size()) - 1;
+        int pending = static_cast<int>(_pendingUpdates.size()) - 1;
+        _updates.resize(_updates.size() + _pendingUpdates.size());
+        for (int index = static_cast<int>(_updates.size()) - 1; pending >= 0; index--)
         {
-            DL_APPEND(*list, listElement);
+            if (scheduled >= 0 && _updates[scheduled].priority > _pendingUpdates[pending].priority)
+            {
+                _updates[index] = std::move(_updates[scheduled--]);
+            }
+            else
+            {
+                _updates[index] = std::move(_pendingUpdates[pending--]);
+            }
+            _updateIndex[_updates[index].target] = index;
         }
+        _pendingUpdates.clear();
     }
-
-    // update hash entry for quick access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
-}
-
-void Scheduler::appendIn(_listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused)
-{
-    tListEntry *listElement = new (std::nothrow) tListEntry();
-
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->paused = paused;
-    listElement->priority = 0;
-    listElement->markedForDeletion = false;
-
-    DL_APPEND(*list, listElement);
-
-    // update hash entry for quicker access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+    _updatesDirty = false;
 }
 
 void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
 {
-    tHashUpdateEntry *hashElement = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, hashElement);
-    if (hashElement)
+    UpdateEntry *entry = findUpdate(target);
+    if (entry)
     {
         // check if priority has changed
-        if ((*hashElement->list)->priority != priority)
+        if (entry->priority != priority)
         {
             if (_updateHashLocked)
             {
                 CCLOG("warning: you CANNOT change update priority in scheduled function");
-                hashElement->entry->markedForDeletion = false;
-                hashElement->entry->paused = paused;
+                entry->markedForDeletion = false;
+                entry->paused = paused;
                 return;
             }
             else
             {
-                // will be added again outside if (hashElement).
+                // will be added again below.
                 unscheduleUpdate(target);
             }
         }
         else
         {
-            hashElement->entry->markedForDeletion = false;
-            hashElement->entry->paused = paused;
+            entry->markedForDeletion = false;
+            entry->paused = paused;
             return;
         }
     }
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (priority == 0)
-    {
-        appendIn(&_updates0List, callback, target, paused);
-    }
-    else if (priority < 0)
-    {
-        priorityIn(&_updatesNegList, callback, target, priority, paused);
-    }
-    else
-    {
-        // priority > 0
-        priorityIn(&_updatesPosList, callback, target, priority, paused);
-    }
+    // sorted in before the next update, so scheduling many targets at once stays linear
+    _pendingUpdates.push_back({callback, target, priority, paused, false});
+    _updateIndex[target] = -static_cast<int>(_pendingUpdates.size());
 }
 
 bool Scheduler::isScheduled(const std::string& key, void *target)
@@ -540,51 +495,22 @@ bool Scheduler::isScheduled(const std::string& key, void *target)
     CCASSERT(!key.empty(), "Argument key must not be empty");
     CCASSERT(target, "Argument target must be non-nullptr");
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (!element)
+    auto it = _timerTargets.find(target);
+    if (it == _timerTargets.end())
     {
         return false;
     }
 
-    if (element->timers == nullptr)
-    {
-        return false;
-    }
-    else
+    for (const auto& item : it->second->timers)
     {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetCallback *timer = CocosCast<TimerTargetCallback>(element->timers->arr[i]);
+        TimerTargetCallback *timer = CocosCast<TimerTargetCallback>(item.get());
 
-            if (timer && key == timer->getKey())
-            {
-                return true;
-            }
+        if (timer && key == timer->getKey())
+        {
+            return true;
         }
-
-        return false;
-    }
-
-    return false;  // should never get here
-}
-
-void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
-{
-    tHashUpdateEntry *element = nullptr;
-
-    HASH_FIND_PTR(_hashForUpdates, &entry->target, element);
-    if (element)
-    {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        CC_SAFE_DELETE(element->entry);
-
-        // hash entry
-        HASH_DEL(_hashForUpdates, element);
-        free(element);
     }
+    return false;
 }
 
 void Scheduler::unscheduleUpdate(void *target)
@@ -594,17 +520,16 @@ void Scheduler::unscheduleUpdate(void *target)
         return;
     }
 
-    tHashUpdateEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, element);
-    if (element)
+    auto it = _updateIndex.find(target);
+    if (it != _updateIndex.end())
     {
-        if (_updateHashLocked)
+        UpdateEntry *entry = findUpdate(target);
+        entry->markedForDeletion = true;
+        _updatesDirty = true;
+        // while updating, a marked entry can still be scheduled again
+        if (!_updateHashLocked)
         {
-            element->entry->markedForDeletion = true;
-        }
-        else
-        {
-            this->removeUpdateFromHash(element->entry);
+            _updateIndex.erase(it);
         }
     }
 }
@@ -617,45 +542,29 @@ void Scheduler::unscheduleAll(void)
 void Scheduler::unscheduleAllWithMinPriority(int minPriority)
 {
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    tHashTimerEntry *nextElement = nullptr;
-    for (element = _hashForTimers; element != nullptr;)
+    std::vector<void*> targets;
+    targets.reserve(_timerTargets.size());
+    for (const auto& item : _timerTargets)
     {
-        // element may be removed in unscheduleAllSelectorsForTarget
-        nextElement = (tHashTimerEntry *)element->hh.next;
-        unscheduleAllForTarget(element->target);
-
-        element = nextElement;
+        targets.push_back(item.first);
+    }
+    for (void* target : targets)
+    {
+        unscheduleAllForTarget(target);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (auto* updates : {&_updates, &_pendingUpdates})
     {
-        DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+        for (size_t i = 0; i < updates->size(); i++)
         {
-            if(entry->priority >= minPriority)
+            const UpdateEntry& entry = (*updates)[i];
+            if (!entry.markedForDeletion && entry.priority >= minPriority)
             {
-                unscheduleUpdate(entry->target);
+                unscheduleUpdate(entry.target);
             }
         }
     }
-
-    if(minPriority <= 0)
-    {
-        DL_FOREACH_SAFE(_updates0List, entry, tmp)
-        {
-            unscheduleUpdate(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
-    {
-        if(entry->priority >= minPriority)
-        {
-            unscheduleUpdate(entry->target);
-        }
-    }
 #if CC_ENABLE_SCRIPT_BINDING
     _scriptHandlerEntries.clear();
 #endif
@@ -670,18 +579,15 @@ void Scheduler::unscheduleAllForTarget(void *target)
     }
 
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (element)
+    auto it = _timerTargets.find(target);
+    if (it != _timerTargets.end())
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimerSalvaged))
+        tTimerTargetEntry *element = it->second;
+        for (const auto& timer : element->timers)
         {
-            element->currentTimer->retain();
-            element->currentTimerSalvaged = true;
+            detachTimer(timer.get());
         }
-        ccArrayRemoveAllObjects(element->timers);
+        element->timers.clear();
 
         if (_currentTarget == element)
         {
@@ -689,7 +595,7 @@ void Scheduler::unscheduleAllForTarget(void *target)
         }
         else
         {
-            removeHashElement(element);
+            removeTimerTarget(element);
         }
     }
 
@@ -725,20 +631,18 @@ void Scheduler::resumeTarget(void *target)
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    auto it = _timerTargets.find(target);
+    if (it != _timerTargets.end() && it->second->paused)
     {
-        element->paused = false;
+        it->second->paused = false;
+        resumeTimers(it->second);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    UpdateEntry *entry = findUpdate(target);
+    if (entry)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = false;
+        entry->paused = false;
     }
 }
 
@@ -747,20 +651,18 @@ void Scheduler::pauseTarget(void *target)
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    auto it = _timerTargets.find(target);
+    if (it != _timerTargets.end() && !it->second->paused)
     {
-        element->paused = true;
+        it->second->paused = true;
+        pauseTimers(it->second);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    UpdateEntry *entry = findUpdate(target);
+    if (entry)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = true;
+        entry->paused = true;
     }
 }
 
@@ -769,19 +671,17 @@ bool Scheduler::isTargetPaused(void *target)
     CCASSERT( target != nullptr, "target must be non nil" );
 
     // Custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if( element )
+    auto it = _timerTargets.find(target);
+    if (it != _timerTargets.end())
     {
-        return element->paused;
+        return it->second->paused;
     }
 
     // We should check update selectors if target does not have custom selectors
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if ( elementUpdate )
+    UpdateEntry *entry = findUpdate(target);
+    if (entry)
     {
-        return elementUpdate->entry->paused;
+        return entry->paused;
     }
 
     return false;  // should never get here
@@ -797,45 +697,29 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     std::set<void*> idsWithSelectors;
 
     // Custom Selectors
-    for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
-        element = (tHashTimerEntry*)element->hh.next)
+    for (const auto& item : _timerTargets)
     {
-        element->paused = true;
-        idsWithSelectors.insert(element->target);
+        if (!item.second->paused)
+        {
+            item.second->paused = true;
+            pauseTimers(item.second);
+        }
+        idsWithSelectors.insert(item.first);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (auto* updates : {&_updates, &_pendingUpdates})
     {
-        DL_FOREACH_SAFE( _updatesNegList, entry, tmp )
+        for (auto& entry : *updates)
         {
-            if(entry->priority >= minPriority)
+            if (entry.priority >= minPriority)
             {
-                entry->paused = true;
-                idsWithSelectors.insert(entry->target);
+                entry.paused = true;
+                idsWithSelectors.insert(entry.target);
             }
         }
     }
 
-    if(minPriority <= 0)
-    {
-        DL_FOREACH_SAFE( _updates0List, entry, tmp )
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE( _updatesPosList, entry, tmp )
-    {
-        if(entry->priority >= minPriority)
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
     return idsWithSelectors;
 }
 
@@ -862,120 +746,328 @@ void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
     _functionsToPerform.clear();
 }
 
-// main loop
-void Scheduler::update(float dt)
+void Scheduler::addTimer(tTimerTargetEntry* element, Timer* timer)
 {
-    _updateHashLocked = true;
+    timer->_owner = element;
+    timer->_slot = TimerDetached;
+    element->timers.emplace_back(timer);
+    if (element->paused)
+    {
+        timer->_slot = TimerParked;
+    }
+    else
+    {
+        placeTimer(timer);
+    }
+}
 
-    if (_timeScale != 1.0f)
+void Scheduler::detachTimer(Timer* timer)
+{
+    if (timer->_slot >= 0)
     {
-        dt *= _timeScale;
+        removeFromWheel(timer);
+    }
+    else if (timer->_slot == TimerEveryFrame)
+    {
+        _frameTimers[timer->_index] = nullptr;
+        _frameTimersDirty = true;
     }
+    timer->_slot = TimerDetached;
+    timer->_owner = nullptr;
+}
 
-    //
-    // Selector callbacks
-    //
+void Scheduler::removeTimer(tTimerTargetEntry* element, size_t index)
+{
+    // a running timer is retained by runTimer, it can't go away before its update is done
+    detachTimer(element->timers[index].get());
+    element->timers.erase(element->timers.begin() + index);
+
+    if (element->timers.empty())
+    {
+        if (_currentTarget == element)
+        {
+            _currentTargetSalvaged = true;
+        }
+        else
+        {
+            removeTimerTarget(element);
+        }
+    }
+}
+
+void Scheduler::removeTimerTarget(tTimerTargetEntry* element)
+{
+    _timerTargets.erase(element->target);
+    delete element;
+}
 
-    // Iterate over all the Updates' selectors
-    tListEntry *entry, *tmp;
+void Scheduler::setTimerInterval(Timer* timer, float interval)
+{
+    timer->setInterval(interval);
+    // running and paused timers are placed again when they are done or resumed
+    if (timer->_slot >= 0 || timer->_slot == TimerEveryFrame)
+    {
+        placeTimer(timer);
+    }
+}
 
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+void Scheduler::pauseTimers(tTimerTargetEntry* element)
+{
+    for (const auto& item : element->timers)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        Timer* timer = item.get();
+        if (timer->_slot == TimerParked)
         {
-            entry->callback(dt);
+            continue;
         }
+        // stop the clock of the timer, it doesn't run while paused
+        if (timer->_slot >= 0 || timer->_slot == TimerDetached)
+        {
+            if (timer->_elapsed != -1)
+            {
+                timer->_elapsed += static_cast<float>(_time - timer->_wheelTime);
+            }
+            timer->_wheelTime = _time;
+        }
+        if (timer->_slot >= 0)
+        {
+            removeFromWheel(timer);
+        }
+        else if (timer->_slot == TimerEveryFrame)
+        {
+            _frameTimers[timer->_index] = nullptr;
+            _frameTimersDirty = true;
+        }
+        timer->_slot = TimerParked;
     }
+}
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
+void Scheduler::resumeTimers(tTimerTargetEntry* element)
+{
+    for (const auto& item : element->timers)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        Timer* timer = item.get();
+        if (timer->_slot == TimerParked)
         {
-            entry->callback(dt);
+            timer->_slot = TimerDetached;
+            placeTimer(timer);
         }
     }
+}
+
+void Scheduler::placeTimer(Timer* timer)
+{
+    if (timer->_slot >= 0)
+    {
+        // bring the elapsed time up to date before the wait is computed again
+        timer->_elapsed += static_cast<float>(_time - timer->_wheelTime);
+        removeFromWheel(timer);
+        timer->_slot = TimerDetached;
+    }
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // timers that haven't started yet or have to trigger every frame stay in the per frame timers
+    float wait = 0.0f;
+    if (timer->_elapsed != -1)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        wait = timer->_useDelay ? timer->_delay - timer->_elapsed : timer->_interval - timer->_elapsed;
+    }
+
+    if (wait > 0.0f)
+    {
+        if (timer->_slot == TimerEveryFrame)
         {
-            entry->callback(dt);
+            _frameTimers[timer->_index] = nullptr;
+            _frameTimersDirty = true;
         }
+        timer->_wheelTime = _time;
+        insertIntoWheel(timer, _time + wait);
+    }
+    else if (timer->_slot != TimerEveryFrame)
+    {
+        timer->_slot = TimerEveryFrame;
+        timer->_index = static_cast<int>(_frameTimers.size());
+        _frameTimers.push_back(timer);
+    }
+}
+
+void Scheduler::runTimer(Timer* timer, float dt)
+{
+    tTimerTargetEntry* element = timer->_owner;
+    // The timer may unschedule itself. To prevent it from deallocating itself
+    // before finishing its step, retain it until the step is done.
+    timer->retain();
+    timer->_wheelTime = _time;
+    _currentTarget = element;
+    _currentTargetSalvaged = false;
+
+    timer->update(dt);
+
+    _currentTarget = nullptr;
+    if (timer->_owner && timer->_slot != TimerParked)
+    {
+        placeTimer(timer);
+    }
+    // only delete the target if no timers were scheduled during the cycle (issue #481)
+    if (_currentTargetSalvaged && element->timers.empty())
+    {
+        removeTimerTarget(element);
     }
+    timer->release();
+}
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
+void Scheduler::insertIntoWheel(Timer* timer, double deadline)
+{
+    timer->_deadline = deadline;
+    double ticks = deadline * WheelTicksPerSecond;
+    uint64_t tick = _wheelTick;
+    if (ticks > static_cast<double>(_wheelTick))
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+        tick = ticks - _wheelTick >= static_cast<double>(WheelMaxDelta) ? _wheelTick + WheelMaxDelta : static_cast<uint64_t>(ticks);
+    }
 
-        if (! _currentTarget->paused)
+    uint64_t delta = tick - _wheelTick;
+    int slot = static_cast<int>(tick & (WheelSize - 1));
+    if (delta >= WheelSize)
+    {
+        int level = 0;
+        while (level < WheelLevels - 1 && delta >= (uint64_t(1) << (WheelBits + (level + 1) * WheelLevelBits)))
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
+            level++;
+        }
+        uint64_t index = (tick >> (WheelBits + level * WheelLevelBits)) & (WheelLevelSize - 1);
+        slot = static_cast<int>(WheelSize + level * WheelLevelSize + index);
+    }
 
-                elt->currentTimer->update(dt);
+    std::vector<Timer*>& timers = _wheel[slot];
+    timer->_slot = slot;
+    timer->_index = static_cast<int>(timers.size());
+    timers.push_back(timer);
+}
 
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+void Scheduler::removeFromWheel(Timer* timer)
+{
+    std::vector<Timer*>& timers = _wheel[timer->_slot];
+    Timer* last = timers.back();
+    timers[timer->_index] = last;
+    last->_index = timer->_index;
+    timers.pop_back();
+}
 
-                elt->currentTimer = nullptr;
-            }
+void Scheduler::expireSlot(int slot, bool cascade)
+{
+    _wheelBuffer.swap(_wheel[slot]);
+    for (Timer* timer : _wheelBuffer)
+    {
+        if (!cascade && timer->_deadline <= _time)
+        {
+            timer->_slot = TimerDetached;
+            timer->retain();
+            _expiredTimers.push_back(timer);
         }
+        else
+        {
+            // spread over the lower levels, or not due yet
+            insertIntoWheel(timer, timer->_deadline);
+        }
+    }
+    _wheelBuffer.clear();
+}
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
+void Scheduler::advanceTimers(float dt)
+{
+    _time += dt;
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+    // per frame timers, the ones added meanwhile wait for the next update
+    for (size_t i = 0, count = _frameTimers.size(); i < count; i++)
+    {
+        Timer* timer = _frameTimers[i];
+        if (timer)
+        {
+            runTimer(timer, dt);
+        }
+    }
+    if (_frameTimersDirty)
+    {
+        _frameTimers.erase(std::remove(_frameTimers.begin(), _frameTimers.end(), nullptr), _frameTimers.end());
+        for (size_t i = 0; i < _frameTimers.size(); i++)
         {
-            removeHashElement(_currentTarget);
+            _frameTimers[i]->_index = static_cast<int>(i);
         }
+        _frameTimersDirty = false;
     }
 
-    // delete all updates that are marked for deletion
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+    // walk the wheel up to the current tick, which is only partly over and stays the current slot
+    uint64_t nowTick = static_cast<uint64_t>(_time * WheelTicksPerSecond);
+    while (true)
     {
-        if (entry->markedForDeletion)
+        expireSlot(static_cast<int>(_wheelTick & (WheelSize - 1)), false);
+        if (_wheelTick >= nowTick)
+        {
+            break;
+        }
+        _wheelTick++;
+        // a new round of some levels starts, spread the next slot of each over the level below,
+        // from the top so timers coming down a level are spread further in the same tick
+        int levels = 0;
+        while (levels < WheelLevels && !(_wheelTick & ((uint64_t(1) << (WheelBits + levels * WheelLevelBits)) - 1)))
         {
-            this->removeUpdateFromHash(entry);
+            levels++;
+        }
+        for (int level = levels - 1; level >= 0; level--)
+        {
+            uint64_t index = (_wheelTick >> (WheelBits + level * WheelLevelBits)) & (WheelLevelSize - 1);
+            expireSlot(static_cast<int>(WheelSize + level * WheelLevelSize + index), true);
         }
     }
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
+    // triggers in deadline order of the ticks, callbacks may unschedule or pause timers still waiting here
+    for (size_t i = 0; i < _expiredTimers.size(); i++)
     {
-        if (entry->markedForDeletion)
+        Timer* timer = _expiredTimers[i];
+        if (timer->_owner && timer->_slot == TimerDetached)
         {
-            this->removeUpdateFromHash(entry);
+            runTimer(timer, static_cast<float>(_time - timer->_wheelTime));
         }
+        timer->release();
     }
+    _expiredTimers.clear();
+}
+
+// main loop
+void Scheduler::update(float dt)
+{
+    CC_TRACE_SCOPE("Scheduler::update");
+    flushUpdates();
+    _updateHashLocked = true;
+
+    if (_timeScale != 1.0f)
+    {
+        dt *= _timeScale;
+    }
+
+    //
+    // Selector callbacks
+    //
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // Iterate over all the Updates' selectors, lower priorities first
+    for (size_t i = 0, count = _updates.size(); i < count; i++)
     {
-        if (entry->markedForDeletion)
+        UpdateEntry& entry = _updates[i];
+        if ((! entry.paused) && (! entry.markedForDeletion))
         {
-            this->removeUpdateFromHash(entry);
+            entry.callback(dt);
         }
     }
 
+    // Iterate over the custom selectors that are due
+    advanceTimers(dt);
+
     _updateHashLocked = false;
     _currentTarget = nullptr;
 
+    // delete all updates that are marked for deletion, add the ones scheduled meanwhile
+    flushUpdates();
+
 #if CC_ENABLE_SCRIPT_BINDING
     //
     // Script callbacks
@@ -1021,47 +1113,39 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
 {
     CCASSERT(target, "Argument target must be non-nullptr");
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    tTimerTargetEntry *element = nullptr;
+    auto it = _timerTargets.find(target);
 
-    if (! element)
+    if (it == _timerTargets.end())
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
+        element = new (std::nothrow) tTimerTargetEntry();
         element->target = target;
 
-        HASH_ADD_PTR(_hashForTimers, target, element);
-
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
+        _timerTargets.emplace(target, element);
     }
     else
     {
+        element = it->second;
         CCASSERT(element->paused == paused, "element's paused should be paused.");
-    }
 
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else
-    {
-        for (int i = 0; i < element->timers->num; ++i)
+        for (const auto& item : element->timers)
         {
-            TimerTargetSelector *timer = CocosCast<TimerTargetSelector>(element->timers->arr[i]);
+            TimerTargetSelector *timer = CocosCast<TimerTargetSelector>(item.get());
 
             if (timer && selector == timer->getSelector())
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
-                timer->setInterval(interval);
+                setTimerInterval(timer, interval);
                 return;
             }
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
 
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -1075,34 +1159,22 @@ bool Scheduler::isScheduled(SEL_SCHEDULE selector, Ref *target)
     CCASSERT(selector, "Argument selector must be non-nullptr");
     CCASSERT(target, "Argument target must be non-nullptr");
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (!element)
+    auto it = _timerTargets.find(target);
+    if (it == _timerTargets.end())
     {
         return false;
     }
 
-    if (element->timers == nullptr)
+    for (const auto& item : it->second->timers)
     {
-        return false;
-    }
-    else
-    {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetSelector *timer = CocosCast<TimerTargetSelector>(element->timers->arr[i]);
+        TimerTargetSelector *timer = CocosCast<TimerTargetSelector>(item.get());
 
-            if (timer && selector == timer->getSelector())
-            {
-                return true;
-            }
+        if (timer && selector == timer->getSelector())
+        {
+            return true;
         }
-
-        return false;
     }
-
-    return false;  // should never get here
+    return false;
 }
 
 void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
@@ -1113,46 +1185,17 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
         return;
     }
 
-    //CCASSERT(target);
-    //CCASSERT(selector);
-
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (element)
+    auto it = _timerTargets.find(target);
+    if (it != _timerTargets.end())
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        tTimerTargetEntry *element = it->second;
+        for (size_t i = 0; i < element->timers.size(); ++i)
         {
-            TimerTargetSelector *timer = CocosCast<TimerTargetSelector>(element->timers->arr[i]);
+            TimerTargetSelector *timer = CocosCast<TimerTargetSelector>(element->timers[i].get());
 
             if (timer && selector == timer->getSelector())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-
+                removeTimer(element, i);
                 return;
             }
         }
@@ -31,11 +31,11 @@ THE SOFTWARE.
 
 #include <mutex>
 #include "base/CCVector.h"
-#include "base/uthash.h"
 
 NS_CC_BEGIN
 
 class Scheduler;
+struct _timerTargetEntry;
 
 typedef std::function<void(float)> ccSchedulerFunc;
 
@@ -61,6 +61,7 @@ public:
     void update(float dt);
 
 protected:
+    friend class Scheduler;
 
     Scheduler* _scheduler; // weak ref
     float _elapsed;
@@ -70,6 +71,12 @@ protected:
     unsigned int _repeat; //0 = once, 1 is 2 x executed
     float _delay;
     float _interval;
+    // bookkeeping of the scheduler
+    struct _timerTargetEntry* _owner; // nullptr once unscheduled
+    double _wheelTime; // scheduler time _elapsed is up to date with
+    double _deadline;  // scheduler time of the next trigger while in the timer wheel
+    int _slot;         // timer wheel slot, or where else the timer is kept
+    int _index;        // position in the slot or in the per frame timers
     COCOS_TYPE_OVERRIDE(Timer);
 };
 
@@ -141,10 +148,6 @@ private:
  * @{
  */
 
-struct _listEntry;
-struct _hashSelectorEntry;
-struct _hashUpdateEntry;
-
 #if CC_ENABLE_SCRIPT_BINDING
 class SchedulerScriptHandlerEntry;
 #endif
@@ -159,6 +162,9 @@ There are 2 different types of callbacks (selectors):
 
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update selector'.
 
+Update selectors are kept in an array sorted by priority. Custom selectors that wait longer than a
+frame sit in a hierarchical timer wheel, so a frame only touches the timers that are due.
+
 */
 class CC_DLL Scheduler : public Ref
 {
@@ -451,32 +457,62 @@ public:
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
 
 protected:
-    void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
+    struct UpdateEntry
+    {
+        ccSchedulerFunc callback;
+        void* target;
+        int priority;
+        bool paused;
+        bool markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
+    };
 
     // update specific
-
-    void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
-    void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
-
+    UpdateEntry* findUpdate(void* target);
+    void flushUpdates();
+
+    // timer specific
+    void addTimer(struct _timerTargetEntry* element, Timer* timer);
+    void detachTimer(Timer* timer);
+    void removeTimer(struct _timerTargetEntry* element, size_t index);
+    void removeTimerTarget(struct _timerTargetEntry* element);
+    void setTimerInterval(Timer* timer, float interval);
+    void pauseTimers(struct _timerTargetEntry* element);
+    void resumeTimers(struct _timerTargetEntry* element);
+    void placeTimer(Timer* timer);
+    void runTimer(Timer* timer, float dt);
+    void insertIntoWheel(Timer* timer, double deadline);
+    void removeFromWheel(Timer* timer);
+    void expireSlot(int slot, bool cascade);
+    void advanceTimers(float dt);
 
     float _timeScale;
 
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *_updatesNegList;        // list of priority < 0
-    struct _listEntry *_updates0List;            // list priority == 0
-    struct _listEntry *_updatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *_hashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
+    std::vector<UpdateEntry> _updates;        // sorted by priority, same priorities in scheduling order
+    std::vector<UpdateEntry> _pendingUpdates; // scheduled since the last update, merged into _updates before the next one
+    std::unordered_map<void*, int> _updateIndex; // index in _updates, or -1 - index in _pendingUpdates
+    bool _updatesDirty; // entries marked for deletion need to be compacted
 
     // Used for "selectors with interval"
-    struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
+    std::unordered_map<void*, struct _timerTargetEntry*> _timerTargets;
+    struct _timerTargetEntry *_currentTarget;
     bool _currentTargetSalvaged;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
 
+    // 256 slots of about a millisecond, then 4 levels of 64 slots, each slot spanning a whole lower level
+    static const int WheelSlotCount = 256 + 4 * 64;
+    double _time; // scaled time the timers have been updated for
+    uint64_t _wheelTick;
+    std::vector<Timer*> _wheel[WheelSlotCount];
+    std::vector<Timer*> _wheelBuffer;
+    std::vector<Timer*> _expiredTimers;
+    // timers running every frame, and the ones about to start
+    std::vector<Timer*> _frameTimers;
+    bool _frameTimersDirty;
+
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
 #endif
@@ -0,0 +1,158 @@
+#include "ccHeader.h"
+#include "base/CCTrace.h"
+#include "bx/timer.h"
+#include <mutex>
+
+NS_CC_BEGIN
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        int64_t time;
+        char phase;
+    };
+
+    struct TraceBuffer
+    {
+        uint32_t tid;
+        std::string threadName;
+        std::atomic<uint32_t> head;
+        std::atomic<uint32_t> tail;
+        TraceEvent events[Trace::BufferCapacity];
+    };
+
+    std::mutex s_buffersMutex;
+    std::vector<TraceBuffer*> s_buffers;
+    thread_local TraceBuffer* s_buffer = nullptr;
+
+    TraceBuffer* getThreadBuffer()
+    {
+        if (!s_buffer)
+        {
+            // buffers live until exit so late exports still see finished threads
+            TraceBuffer* buffer = new TraceBuffer();
+            buffer->head = 0;
+            buffer->tail = 0;
+            std::lock_guard<std::mutex> lock(s_buffersMutex);
+            buffer->tid = static_cast<uint32_t>(s_buffers.size());
+            s_buffers.push_back(buffer);
+            s_buffer = buffer;
+        }
+        return s_buffer;
+    }
+
+    inline void record(const char* name, char phase)
+    {
+        TraceBuffer* buffer = getThreadBuffer();
+        uint32_t head = buffer->head.load(std::memory_order_relaxed);
+        TraceEvent& event = buffer->events[head & (Trace::BufferCapacity - 1)];
+        event.name = name;
+        event.time = bx::getHPCounter();
+        event.phase = phase;
+        buffer->head.store(head + 1, std::memory_order_release);
+    }
+
+    void appendEscaped(std::string& out, const char* text)
+    {
+        for (; *text; text++)
+        {
+            switch (*text)
+            {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            default: out += *text; break;
+            }
+        }
+    }
+}
+
+std::atomic<bool> Trace::enabled_(false);
+
+void Trace::setEnabled(bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Trace::setThreadName(const std::string& name)
+{
+    TraceBuffer* buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    buffer->threadName = name;
+}
+
+void Trace::begin(const char* name)
+{
+    record(name, 'B');
+}
+
+void Trace::end(const char* name)
+{
+    record(name, 'E');
+}
+
+void Trace::clear()
+{
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    for (TraceBuffer* buffer : s_buffers)
+    {
+        buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+std::string Trace::exportToString()
+{
+    std::string out;
+    out.reserve(1024 * 1024);
+    out += "{\"traceEvents\":[";
+    bool first = true;
+    char line[128];
+    double toMicroseconds = 1000000.0 / double(bx::getHPFrequency());
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    for (TraceBuffer* buffer : s_buffers)
+    {
+        if (!buffer->threadName.empty())
+        {
+            snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"", first ? "" : ",", buffer->tid);
+            out += line;
+            appendEscaped(out, buffer->threadName.c_str());
+            out += "\"}}";
+            first = false;
+        }
+        uint32_t head = buffer->head.load(std::memory_order_acquire);
+        uint32_t start = buffer->tail.load(std::memory_order_relaxed);
+        // the writer may be overwriting the oldest slots while we read, skip a margin of them
+        if (head - start > BufferCapacity)
+        {
+            start = head - BufferCapacity + BufferCapacity / 16;
+        }
+        for (uint32_t i = start; i != head; i++)
+        {
+            const TraceEvent& event = buffer->events[i & (BufferCapacity - 1)];
+            snprintf(line, sizeof(line), "%s{\"ph\":\"%c\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"name\":\"", first ? "" : ",", event.phase, buffer->tid, event.time * toMicroseconds);
+            out += line;
+            appendEscaped(out, event.name);
+            out += "\"}";
+            first = false;
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+bool Trace::exportToFile(const std::string& path)
+{
+    std::string json = exportToString();
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        CCLOG("can not open %s to write trace.", path.c_str());
+        return false;
+    }
+    bool done = fwrite(json.data(), 1, json.size(), file) == json.size();
+    fclose(file);
+    return done;
+}
+
+NS_CC_END
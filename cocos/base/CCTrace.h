@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+
+NS_CC_BEGIN
+
+/** @brief Low overhead frame tracer.
+ Scoped events are appended to a per-thread ring buffer, only the owning
+ thread writes to it, so recording takes no lock. When tracing is off a
+ scope costs one relaxed load and a branch. Export the rings as Chrome
+ trace JSON and open the file in chrome://tracing.
+ @example Trace a block.
+ void Foo::update()
+ {
+    CC_TRACE_SCOPE("Foo::update");
+    ...
+ }
+ Trace::setEnabled(true);
+ ...
+ Trace::exportToFile(FileUtils::getInstance()->getWritablePath() + "trace.json");
+ */
+
+class CC_DLL Trace
+{
+public:
+    /** Events kept per thread, older events are overwritten. */
+    static const uint32_t BufferCapacity = 1 << 16;
+
+    static inline bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    /** Names the current thread in exported traces. */
+    static void setThreadName(const std::string& name);
+
+    /** name must outlive the trace, pass string literals. */
+    static void begin(const char* name);
+    static void end(const char* name);
+
+    /** Drops every recorded event. */
+    static void clear();
+
+    static std::string exportToString();
+    static bool exportToFile(const std::string& path);
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name)
+        :name_(Trace::isEnabled() ? name : nullptr)
+    {
+        if (name_)
+        {
+            Trace::begin(name_);
+        }
+    }
+    ~TraceScope()
+    {
+        if (name_)
+        {
+            Trace::end(name_);
+        }
+    }
+private:
+    const char* name_;
+};
+
+NS_CC_END
+
+#if CC_ENABLE_TRACING
+#define CC_TRACE_CONCAT_(a, b) a##b
+#define CC_TRACE_CONCAT(a, b) CC_TRACE_CONCAT_(a, b)
+#define CC_TRACE_SCOPE(__name__) NS_CC::TraceScope CC_TRACE_CONCAT(__traceScope, __LINE__)(__name__)
+#define CC_TRACE_THREAD_NAME(__name__) NS_CC::Trace::setThreadName(__name__)
+#else
+#define CC_TRACE_SCOPE(__name__) do {} while (0)
+#define CC_TRACE_THREAD_NAME(__name__) do {} while (0)
+#endif
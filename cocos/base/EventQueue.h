@@ -1,6 +1,8 @@
 #pragma once
 
 #include "bx/spscqueue.h"
+#include <atomic>
+#include <mutex>
 
 NS_CC_BEGIN
 
@@ -105,4 +107,269 @@ private:
     bx::SpScUnboundedQueueT<QEvent> queue_;
 };
 
+/** @brief Allocation-free variant of EventQueue for hot cross-thread paths.
+ Messages are plain structs carrying a compile-time id, they are copied into
+ a fixed-capacity lock-free ring and dispatched by id without string hashing.
+ Messages larger than InlineSize, and messages posted while the ring is full,
+ go to blocks recycled by a pool so steady state traffic never hits the heap.
+ Any thread may post, messages from one thread are polled in posting order.
+ @example Communicate between threads.
+ struct MoveMessage
+ {
+    static constexpr std::size_t Id = "Move"_hash;
+    float x, y;
+ };
+ TypedEventQueue<> queue;
+
+ // producer thread
+ queue.post(MoveMessage{1.0f, 2.0f});
+
+ // consumer thread
+ queue.poll([](const TEvent& event)
+ {
+    switch (event.getId())
+    {
+        case MoveMessage::Id:
+        {
+            const MoveMessage& move = event.get<MoveMessage>();
+            break;
+        }
+    }
+ });
+ */
+
+class TEvent
+{
+public:
+    TEvent(std::size_t id, void* payload)
+        :id_(id)
+        ,payload_(payload)
+    {}
+    inline std::size_t getId() const { return id_; }
+
+    template<typename Msg>
+    inline Msg& get() const
+    {
+        CCAssertIf(id_ != Msg::Id, "no required message type can be retrieved.");
+        return *reinterpret_cast<Msg*>(payload_);
+    }
+private:
+    std::size_t id_;
+    void* payload_;
+};
+
+template<std::size_t Capacity = 256, std::size_t InlineSize = 64, std::size_t BlockSize = 512>
+class TypedEventQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity should be power of two.");
+    typedef void (*Destroy)(void*);
+    struct Block
+    {
+        Block* next;
+        std::size_t id;
+        Destroy destroy;
+        alignas(16) uint8_t storage[BlockSize];
+    };
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        std::size_t id;
+        Destroy destroy;
+        Block* block;
+        alignas(16) uint8_t storage[InlineSize];
+    };
+public:
+    TypedEventQueue()
+        :enqueuePos_(0)
+        ,dequeuePos_(0)
+        ,overflowing_(false)
+        ,overflowHead_(nullptr)
+        ,overflowTail_(nullptr)
+        ,freeBlocks_(nullptr)
+        ,blockCount_(0)
+    {
+        for (std::size_t i = 0; i < Capacity; i++)
+        {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~TypedEventQueue()
+    {
+        poll([](const TEvent&) {});
+        while (freeBlocks_)
+        {
+            Block* block = freeBlocks_;
+            freeBlocks_ = block->next;
+            delete block;
+        }
+    }
+
+    template<typename Msg>
+    void post(const Msg& msg)
+    {
+        static_assert(sizeof(Msg) <= BlockSize, "message is too large for the queue.");
+        if (!overflowing_.load(std::memory_order_acquire) && tryPush(msg))
+        {
+            return;
+        }
+        Block* block = allocBlock();
+        block->next = nullptr;
+        block->id = Msg::Id;
+        block->destroy = &TypedEventQueue::destroy<Msg>;
+        new (block->storage) Msg(msg);
+        std::lock_guard<std::mutex> lock(overflowMutex_);
+        if (overflowTail_)
+        {
+            overflowTail_->next = block;
+        }
+        else
+        {
+            overflowHead_ = block;
+        }
+        overflowTail_ = block;
+        overflowing_.store(true, std::memory_order_release);
+    }
+
+    /** Dispatches every pending message to handler and returns the number of messages. */
+    template<typename Handler>
+    int poll(const Handler& handler)
+    {
+        int count = 0;
+        std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& slot = slots_[pos & (Capacity - 1)];
+            intptr_t diff = static_cast<intptr_t>(slot.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos + 1);
+            if (diff < 0)
+            {
+                break;
+            }
+            if (diff > 0 || !dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+                continue;
+            }
+            void* payload = slot.block ? slot.block->storage : slot.storage;
+            handler(TEvent(slot.id, payload));
+            slot.destroy(payload);
+            if (slot.block)
+            {
+                freeBlock(slot.block);
+            }
+            slot.sequence.store(pos + Capacity, std::memory_order_release);
+            pos++;
+            count++;
+        }
+        if (overflowing_.load(std::memory_order_acquire))
+        {
+            Block* block;
+            {
+                std::lock_guard<std::mutex> lock(overflowMutex_);
+                block = overflowHead_;
+                overflowHead_ = overflowTail_ = nullptr;
+                overflowing_.store(false, std::memory_order_release);
+            }
+            while (block)
+            {
+                Block* next = block->next;
+                handler(TEvent(block->id, block->storage));
+                block->destroy(block->storage);
+                freeBlock(block);
+                block = next;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    /** Number of pooled blocks ever allocated, stays flat once the pool is warm. */
+    inline int getBlockCount() const { return blockCount_; }
+private:
+    template<typename Msg>
+    bool tryPush(const Msg& msg)
+    {
+        std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true)
+        {
+            slot = &slots_[pos & (Capacity - 1)];
+            intptr_t diff = static_cast<intptr_t>(slot->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->id = Msg::Id;
+        slot->destroy = &TypedEventQueue::destroy<Msg>;
+        construct(slot, msg, std::integral_constant<bool, sizeof(Msg) <= InlineSize>());
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename Msg>
+    void construct(Slot* slot, const Msg& msg, std::true_type)
+    {
+        slot->block = nullptr;
+        new (slot->storage) Msg(msg);
+    }
+
+    template<typename Msg>
+    void construct(Slot* slot, const Msg& msg, std::false_type)
+    {
+        slot->block = allocBlock();
+        new (slot->block->storage) Msg(msg);
+    }
+
+    Block* allocBlock()
+    {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex_);
+            if (freeBlocks_)
+            {
+                Block* block = freeBlocks_;
+                freeBlocks_ = block->next;
+                return block;
+            }
+            blockCount_++;
+        }
+        return new Block();
+    }
+
+    void freeBlock(Block* block)
+    {
+        std::lock_guard<std::mutex> lock(poolMutex_);
+        block->next = freeBlocks_;
+        freeBlocks_ = block;
+    }
+
+    template<typename Msg>
+    static void destroy(void* payload)
+    {
+        reinterpret_cast<Msg*>(payload)->~Msg();
+    }
+private:
+    Slot slots_[Capacity];
+    std::atomic<std::size_t> enqueuePos_;
+    std::atomic<std::size_t> dequeuePos_;
+    std::atomic<bool> overflowing_;
+    std::mutex overflowMutex_;
+    Block* overflowHead_;
+    Block* overflowTail_;
+    std::mutex poolMutex_;
+    Block* freeBlocks_;
+    int blockCount_;
+};
+
 NS_CC_END
\ No newline at end of file
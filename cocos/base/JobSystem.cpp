@@ -0,0 +1,390 @@
+#include "ccHeader.h"
+#include "JobSystem.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "bx/timer.h"
+#include <thread>
+
+NS_CC_BEGIN
+
+// index of the worker owning the current thread, -1 for threads outside the pool
+static thread_local int s_workerIndex = -1;
+// job being executed by the current thread
+static thread_local Job* s_currentJob = nullptr;
+
+Job::Job(const std::function<void()>& work, JobPriority priority)
+    :work_(work)
+    ,priority_(priority)
+    ,uploadBytes_(0)
+    ,dependencies_(1)
+    ,finished_(false)
+{
+}
+
+JobSystem::JobSystem()
+    :scheduled_(false)
+    ,stopping_(false)
+    ,nextWorker_(0)
+    ,budgetSeconds_(0.0)
+    ,budgetBytes_(0)
+    ,deferredBytes_(0)
+    ,totalDeferred_(0)
+{
+}
+
+JobSystem::~JobSystem()
+{
+    JobSystem::stop();
+}
+
+void JobSystem::start()
+{
+    if (!scheduled_ && s_workerIndex < 0)
+    {
+        scheduled_ = true;
+        SharedDirector.getScheduler()->schedule([this](float deltaTime) -> bool
+        {
+            runCompletions();
+            return false;
+        });
+    }
+    if (!workers_.empty())
+    {
+        return;
+    }
+    // keep one core for the main thread, but never go below two workers so blocking IO can't starve the pool
+    int count = std::max(2, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    stopping_ = false;
+    for (int i = 0; i < count; i++)
+    {
+        Worker* worker = new Worker();
+        worker->owner = this;
+        worker->index = i;
+        workers_.push_back(worker);
+    }
+    for (Worker* worker : workers_)
+    {
+        worker->thread.init(JobSystem::work, worker);
+    }
+}
+
+void JobSystem::stop()
+{
+    if (!workers_.empty())
+    {
+        stopping_ = true;
+        workerSemaphore_.post(static_cast<uint32_t>(workers_.size()));
+        for (Worker* worker : workers_)
+        {
+            worker->thread.shutdown();
+        }
+        for (Worker* worker : workers_)
+        {
+            delete worker;
+        }
+        workers_.clear();
+    }
+    scheduled_ = false;
+}
+
+JobHandle JobSystem::run(const std::function<void()>& work, JobPriority priority)
+{
+    return JobSystem::run(work, std::vector<JobHandle>(), priority);
+}
+
+JobHandle JobSystem::run(const std::function<void()>& work, const std::vector<JobHandle>& dependencies, JobPriority priority)
+{
+    start();
+    JobHandle job = std::make_shared<Job>(work, priority);
+    for (const JobHandle& dependency : dependencies)
+    {
+        std::lock_guard<std::mutex> lock(dependency->mutex_);
+        if (!dependency->isFinished())
+        {
+            job->dependencies_.fetch_add(1, std::memory_order_relaxed);
+            dependency->dependents_.push_back(job);
+        }
+    }
+    // drop the submission guard, the last finished dependency submits the job
+    if (job->dependencies_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        submit(job);
+    }
+    return job;
+}
+
+JobHandle JobSystem::run(const std::function<SmartPtr<TValues>()>& worker, const std::function<void(TValues*)>& finisher, JobPriority priority)
+{
+    auto result = std::make_shared<SmartPtr<TValues>>();
+    JobHandle job = JobSystem::run([worker, result]()
+    {
+        *result = worker();
+    }, priority);
+    JobSystem::then(job, [finisher, result]()
+    {
+        finisher(*result);
+    });
+    return job;
+}
+
+void JobSystem::then(const JobHandle& job, const std::function<void()>& continuation)
+{
+    {
+        std::lock_guard<std::mutex> lock(job->mutex_);
+        if (!job->isFinished())
+        {
+            job->continuations_.push_back(continuation);
+            return;
+        }
+    }
+    postToMainThread(continuation, job->priority_, job->uploadBytes_);
+}
+
+void JobSystem::setUploadBytes(uint32_t bytes)
+{
+    CCAssertIf(s_currentJob == nullptr, "upload bytes can only be set from inside a job.");
+    s_currentJob->uploadBytes_ = bytes;
+}
+
+void JobSystem::setCompletionBudget(float milliseconds, uint32_t uploadBytes)
+{
+    budgetSeconds_ = milliseconds / 1000.0;
+    budgetBytes_ = uploadBytes;
+}
+
+void JobSystem::parallelFor(int count, int grain, const std::function<void(int begin, int end)>& body)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    grain = std::max(1, grain);
+    if (count <= grain)
+    {
+        body(0, count);
+        return;
+    }
+    std::vector<JobHandle> jobs;
+    jobs.reserve((count + grain - 1) / grain);
+    // the calling thread takes the first range itself
+    for (int begin = grain; begin < count; begin += grain)
+    {
+        int end = std::min(count, begin + grain);
+        jobs.push_back(JobSystem::run([&body, begin, end]()
+        {
+            body(begin, end);
+        }, JobPriority::High));
+    }
+    body(0, grain);
+    for (const JobHandle& job : jobs)
+    {
+        JobSystem::wait(job);
+    }
+}
+
+void JobSystem::wait(const JobHandle& job)
+{
+    while (!job->isFinished())
+    {
+        JobHandle other = s_workerIndex < 0 ? stealJob(-1) : popJob(s_workerIndex);
+        if (other)
+        {
+            execute(other);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::submit(const JobHandle& job)
+{
+    int index = s_workerIndex;
+    if (index < 0)
+    {
+        index = static_cast<int>(nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size());
+    }
+    Worker* worker = workers_[index];
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->jobs[static_cast<int>(job->priority_)].push_back(job);
+    }
+    workerSemaphore_.post();
+}
+
+void JobSystem::execute(const JobHandle& job)
+{
+    CC_TRACE_SCOPE("JobSystem::execute");
+    Job* outerJob = s_currentJob;
+    s_currentJob = job.get();
+    job->work_();
+    job->work_ = nullptr;
+    s_currentJob = outerJob;
+
+    std::vector<JobHandle> dependents;
+    std::vector<std::function<void()>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex_);
+        job->finished_.store(true, std::memory_order_release);
+        dependents.swap(job->dependents_);
+        continuations.swap(job->continuations_);
+    }
+    for (const JobHandle& dependent : dependents)
+    {
+        if (dependent->dependencies_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            submit(dependent);
+        }
+    }
+    for (const auto& continuation : continuations)
+    {
+        postToMainThread(continuation, job->priority_, job->uploadBytes_);
+    }
+}
+
+void JobSystem::postToMainThread(const std::function<void()>& continuation, JobPriority priority, uint32_t uploadBytes)
+{
+    std::lock_guard<std::mutex> lock(mainThreadMutex_);
+    mainThreadJobs_.push_back({continuation, priority, uploadBytes, false});
+}
+
+void JobSystem::runCompletions()
+{
+    CC_TRACE_SCOPE("JobSystem::runCompletions");
+    {
+        std::lock_guard<std::mutex> lock(mainThreadMutex_);
+        if (!mainThreadJobs_.empty())
+        {
+            for (auto& completion : mainThreadJobs_)
+            {
+                completions_.push_back(std::move(completion));
+            }
+            mainThreadJobs_.clear();
+            // stable to keep completion order within the same priority
+            std::stable_sort(completions_.begin(), completions_.end(), [](const Completion& a, const Completion& b)
+            {
+                return a.priority < b.priority;
+            });
+        }
+    }
+    if (completions_.empty())
+    {
+        return;
+    }
+
+    // continuations may post new completions, only run the ones present now
+    std::vector<Completion> running;
+    running.swap(completions_);
+    int64_t start = bx::getHPCounter();
+    double frequency = double(bx::getHPFrequency());
+    uint32_t bytes = 0;
+    size_t index = 0;
+    for (; index < running.size(); index++)
+    {
+        Completion& completion = running[index];
+        if (index > 0)
+        {
+            bool overTime = budgetSeconds_ > 0.0 && (bx::getHPCounter() - start) / frequency >= budgetSeconds_;
+            bool overBytes = budgetBytes_ > 0 && bytes + completion.uploadBytes > budgetBytes_;
+            if (overTime || overBytes)
+            {
+                break;
+            }
+        }
+        bytes += completion.uploadBytes;
+        completion.func();
+    }
+
+    deferredBytes_ = 0;
+    std::vector<Completion> deferred;
+    for (; index < running.size(); index++)
+    {
+        Completion& completion = running[index];
+        if (!completion.deferred)
+        {
+            completion.deferred = true;
+            totalDeferred_++;
+        }
+        deferredBytes_ += completion.uploadBytes;
+        deferred.push_back(std::move(completion));
+    }
+    if (!deferred.empty())
+    {
+        for (auto& completion : completions_)
+        {
+            deferred.push_back(std::move(completion));
+        }
+        completions_.swap(deferred);
+    }
+}
+
+JobHandle JobSystem::popJob(int workerIndex)
+{
+    Worker* worker = workers_[workerIndex];
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        for (auto& jobs : worker->jobs)
+        {
+            if (!jobs.empty())
+            {
+                JobHandle job = jobs.back();
+                jobs.pop_back();
+                return job;
+            }
+        }
+    }
+    return stealJob(workerIndex);
+}
+
+JobHandle JobSystem::stealJob(int workerIndex)
+{
+    int count = static_cast<int>(workers_.size());
+    int start = workerIndex < 0 ? 0 : workerIndex + 1;
+    for (int priority = 0; priority < static_cast<int>(JobPriority::Count); priority++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            Worker* victim = workers_[(start + i) % count];
+            if (victim->index == workerIndex)
+            {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(victim->mutex);
+            auto& jobs = victim->jobs[priority];
+            if (!jobs.empty())
+            {
+                JobHandle job = jobs.front();
+                jobs.pop_front();
+                return job;
+            }
+        }
+    }
+    return nullptr;
+}
+
+int JobSystem::work(bx::Thread* thread, void* userData)
+{
+    Worker* worker = reinterpret_cast<Worker*>(userData);
+    JobSystem* system = worker->owner;
+    s_workerIndex = worker->index;
+    CC_TRACE_THREAD_NAME("Worker " + std::to_string(worker->index));
+    while (true)
+    {
+        JobHandle job = system->popJob(worker->index);
+        if (job)
+        {
+            system->execute(job);
+            continue;
+        }
+        if (system->stopping_)
+        {
+            break;
+        }
+        system->workerSemaphore_.wait();
+    }
+    s_workerIndex = -1;
+    return 0;
+}
+
+NS_CC_END
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Value.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+NS_CC_BEGIN
+
+/** @brief Engine-wide work-stealing job scheduler.
+ It owns one worker per spare core. Each worker drains its own queue first
+ and steals from the other workers when it runs dry.
+ @example Load two files and merge them on the main thread.
+ auto a = SharedJobSystem.run([]() { loadA(); });
+ auto b = SharedJobSystem.run([]() { loadB(); });
+ auto merge = SharedJobSystem.run([]() { merge(); }, {a, b});
+ SharedJobSystem.then(merge, []() { onMerged(); });
+ */
+
+enum class JobPriority
+{
+    High,
+    Normal,
+    Low,
+    Count
+};
+
+class Job
+{
+public:
+    Job(const std::function<void()>& work, JobPriority priority);
+    inline bool isFinished() const { return finished_.load(std::memory_order_acquire); }
+private:
+    std::function<void()> work_;
+    JobPriority priority_;
+    uint32_t uploadBytes_;
+    std::atomic<int> dependencies_;
+    std::atomic<bool> finished_;
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<Job>> dependents_;
+    std::vector<std::function<void()>> continuations_;
+    friend class JobSystem;
+};
+
+typedef std::shared_ptr<Job> JobHandle;
+
+class JobSystem
+{
+public:
+    JobSystem();
+    virtual ~JobSystem();
+
+    /** Runs work on a worker thread. */
+    JobHandle run(const std::function<void()>& work, JobPriority priority = JobPriority::Normal);
+
+    /** Runs work on a worker thread once all dependencies are finished. */
+    JobHandle run(const std::function<void()>& work, const std::vector<JobHandle>& dependencies, JobPriority priority = JobPriority::Normal);
+
+    /** Runs worker on a worker thread and passes its result to finisher on the main thread. */
+    JobHandle run(const std::function<SmartPtr<TValues>()>& worker, const std::function<void(TValues*)>& finisher, JobPriority priority = JobPriority::Normal);
+
+    /** Calls continuation on the main thread after job is finished. */
+    void then(const JobHandle& job, const std::function<void()>& continuation);
+
+    /** Called from inside a job to declare how many bytes its main thread continuations will upload to the GPU. */
+    static void setUploadBytes(uint32_t bytes);
+
+    /** Limits the main thread continuations run per frame, zero means no limit.
+     Continuations over budget are deferred to the next frames, higher priority first.
+     At least one continuation runs each frame so nothing starves. */
+    void setCompletionBudget(float milliseconds, uint32_t uploadBytes);
+
+    /** Continuations waiting for the next frame. */
+    inline int getDeferredCount() const { return static_cast<int>(completions_.size()); }
+    /** GPU bytes declared by the continuations waiting for the next frame. */
+    inline uint32_t getDeferredBytes() const { return deferredBytes_; }
+    /** Continuations that have been pushed to a later frame since startup. */
+    inline uint32_t getTotalDeferred() const { return totalDeferred_; }
+
+    /** Splits [0, count) into ranges of grain items, runs them in parallel and returns when all are done. */
+    void parallelFor(int count, int grain, const std::function<void(int begin, int end)>& body);
+
+    /** Blocks until job is finished, running other jobs in the meantime. */
+    void wait(const JobHandle& job);
+
+    /** Finishes queued jobs and shuts the workers down. They restart on the next run. */
+    void stop();
+
+    inline int getWorkerCount() const { return static_cast<int>(workers_.size()); }
+#if BX_PLATFORM_WINDOWS
+    inline void* operator new(size_t i)
+    {
+        return _mm_malloc(i, 16);
+    }
+    inline void operator delete(void* p)
+    {
+        _mm_free(p);
+    }
+#endif // BX_PLATFORM_WINDOWS
+private:
+    struct Completion
+    {
+        std::function<void()> func;
+        JobPriority priority;
+        uint32_t uploadBytes;
+        bool deferred;
+    };
+    struct Worker
+    {
+        JobSystem* owner;
+        int index;
+        bx::Thread thread;
+        std::mutex mutex;
+        std::deque<JobHandle> jobs[static_cast<int>(JobPriority::Count)];
+    };
+    void start();
+    void submit(const JobHandle& job);
+    void execute(const JobHandle& job);
+    void postToMainThread(const std::function<void()>& continuation, JobPriority priority = JobPriority::Normal, uint32_t uploadBytes = 0);
+    void runCompletions();
+    JobHandle popJob(int workerIndex);
+    JobHandle stealJob(int workerIndex);
+    static int work(bx::Thread* thread, void* userData);
+private:
+    bool scheduled_;
+    std::atomic<bool> stopping_;
+    std::atomic<unsigned int> nextWorker_;
+    std::vector<Worker*> workers_;
+    bx::Semaphore workerSemaphore_;
+    std::mutex mainThreadMutex_;
+    std::vector<Completion> mainThreadJobs_;
+    std::vector<Completion> completions_;
+    double budgetSeconds_;
+    uint32_t budgetBytes_;
+    uint32_t deferredBytes_;
+    uint32_t totalDeferred_;
+    SINGLETON_REF(JobSystem);
+};
+
+#define SharedJobSystem \
+    cocos2d::Singleton<cocos2d::JobSystem>::shared()
+
+NS_CC_END
@@ -0,0 +1,277 @@
+#include "ccHeader.h"
+#include "base/SlabAllocator.h"
+#include <atomic>
+#include <mutex>
+
+NS_CC_BEGIN
+
+namespace
+{
+    // in front of every block, tells deallocate where the block comes from
+    struct BlockHeader
+    {
+        void* base;
+        uint32_t sizeClass;
+    };
+    const size_t HeaderSize = 16;
+    static_assert(sizeof(BlockHeader) <= HeaderSize, "block header must keep blocks 16 bytes aligned");
+    const uint32_t LargeClass = SlabAllocator::ClassCount;
+
+    // blocks moved between a thread cache and the depot at once
+    const uint32_t BatchSize = 32;
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct SizeClass
+    {
+        std::mutex mutex;
+        FreeBlock* depot = nullptr;
+        std::atomic<uint32_t> slabs{0};
+        std::atomic<uint32_t> liveBlocks{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> frees{0};
+    };
+
+    SizeClass* getSizeClasses()
+    {
+        // never destroyed, objects may still be freed while statics are torn down
+        static SizeClass* sizeClasses = new SizeClass[SlabAllocator::ClassCount + 1];
+        return sizeClasses;
+    }
+
+    struct ThreadCache
+    {
+        FreeBlock* heads[SlabAllocator::ClassCount];
+        uint32_t counts[SlabAllocator::ClassCount];
+        bool disabled;
+    };
+    // trivially destructible, stays usable after the flusher below is gone
+    thread_local ThreadCache s_cache;
+
+    inline size_t getBlockSize(uint32_t sizeClass)
+    {
+        return (sizeClass + 1) * SlabAllocator::Granularity;
+    }
+
+    void flushToDepot(uint32_t sizeClass, uint32_t count)
+    {
+        FreeBlock* first = s_cache.heads[sizeClass];
+        FreeBlock* last = first;
+        for (uint32_t i = 1; i < count; i++)
+        {
+            last = last->next;
+        }
+        s_cache.heads[sizeClass] = last->next;
+        s_cache.counts[sizeClass] -= count;
+        SizeClass& sc = getSizeClasses()[sizeClass];
+        std::lock_guard<std::mutex> lock(sc.mutex);
+        last->next = sc.depot;
+        sc.depot = first;
+    }
+
+    struct ThreadCacheFlusher
+    {
+        ~ThreadCacheFlusher()
+        {
+            for (uint32_t i = 0; i < SlabAllocator::ClassCount; i++)
+            {
+                if (s_cache.counts[i] > 0)
+                {
+                    flushToDepot(i, s_cache.counts[i]);
+                }
+            }
+            s_cache.disabled = true;
+        }
+    };
+    thread_local ThreadCacheFlusher s_flusher;
+
+    void refill(uint32_t sizeClass)
+    {
+        // touch the flusher so it gets constructed, and destructed when the thread ends
+        (void)&s_flusher;
+        SizeClass& sc = getSizeClasses()[sizeClass];
+        std::lock_guard<std::mutex> lock(sc.mutex);
+        if (!sc.depot)
+        {
+            char* slab = static_cast<char*>(malloc(SlabAllocator::SlabSize + HeaderSize));
+            if (!slab)
+            {
+                return;
+            }
+            char* begin = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(slab) + HeaderSize - 1) & ~uintptr_t(HeaderSize - 1));
+            size_t blockSize = getBlockSize(sizeClass);
+            size_t count = SlabAllocator::SlabSize / blockSize;
+            for (size_t i = count; i > 0; i--)
+            {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(begin + (i - 1) * blockSize);
+                block->next = sc.depot;
+                sc.depot = block;
+            }
+            sc.slabs++;
+        }
+        for (uint32_t i = 0; i < BatchSize && sc.depot; i++)
+        {
+            FreeBlock* block = sc.depot;
+            sc.depot = block->next;
+            block->next = s_cache.heads[sizeClass];
+            s_cache.heads[sizeClass] = block;
+            s_cache.counts[sizeClass]++;
+        }
+    }
+}
+
+void* SlabAllocator::allocate(size_t size)
+{
+    size_t total = size + HeaderSize;
+    SizeClass* sizeClasses = getSizeClasses();
+    if (total > MaxBlockSize)
+    {
+        char* base = static_cast<char*>(malloc(total + HeaderSize));
+        if (!base)
+        {
+            return nullptr;
+        }
+        char* block = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(base) + HeaderSize - 1) & ~uintptr_t(HeaderSize - 1));
+        BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+        header->base = base;
+        header->sizeClass = LargeClass;
+        sizeClasses[LargeClass].allocations.fetch_add(1, std::memory_order_relaxed);
+        sizeClasses[LargeClass].liveBlocks.fetch_add(1, std::memory_order_relaxed);
+        return block + HeaderSize;
+    }
+
+    uint32_t sizeClass = static_cast<uint32_t>((total + Granularity - 1) / Granularity - 1);
+    FreeBlock* block = nullptr;
+    if (!s_cache.disabled)
+    {
+        if (!s_cache.heads[sizeClass])
+        {
+            refill(sizeClass);
+        }
+        block = s_cache.heads[sizeClass];
+        if (block)
+        {
+            s_cache.heads[sizeClass] = block->next;
+            s_cache.counts[sizeClass]--;
+        }
+    }
+    else
+    {
+        // thread is exiting, go straight to the depot
+        refill(sizeClass);
+        block = s_cache.heads[sizeClass];
+        if (block)
+        {
+            s_cache.heads[sizeClass] = block->next;
+            s_cache.counts[sizeClass]--;
+            if (s_cache.counts[sizeClass] > 0)
+            {
+                flushToDepot(sizeClass, s_cache.counts[sizeClass]);
+            }
+        }
+    }
+    if (!block)
+    {
+        return nullptr;
+    }
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+    header->base = nullptr;
+    header->sizeClass = sizeClass;
+    sizeClasses[sizeClass].allocations.fetch_add(1, std::memory_order_relaxed);
+    sizeClasses[sizeClass].liveBlocks.fetch_add(1, std::memory_order_relaxed);
+    return reinterpret_cast<char*>(block) + HeaderSize;
+}
+
+void* SlabAllocator::allocateOrThrow(size_t size)
+{
+    void* p = allocate(size);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void SlabAllocator::deallocate(void* p)
+{
+    if (!p)
+    {
+        return;
+    }
+    char* block = static_cast<char*>(p) - HeaderSize;
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+    uint32_t sizeClass = header->sizeClass;
+    SizeClass& sc = getSizeClasses()[sizeClass];
+    sc.frees.fetch_add(1, std::memory_order_relaxed);
+    sc.liveBlocks.fetch_sub(1, std::memory_order_relaxed);
+    if (sizeClass == LargeClass)
+    {
+        free(header->base);
+        return;
+    }
+
+    FreeBlock* freeBlock = reinterpret_cast<FreeBlock*>(block);
+    freeBlock->next = s_cache.heads[sizeClass];
+    s_cache.heads[sizeClass] = freeBlock;
+    s_cache.counts[sizeClass]++;
+    if (s_cache.disabled)
+    {
+        flushToDepot(sizeClass, s_cache.counts[sizeClass]);
+    }
+    else if (s_cache.counts[sizeClass] >= BatchSize * 2)
+    {
+        flushToDepot(sizeClass, BatchSize);
+    }
+}
+
+std::vector<SlabAllocator::Stats> SlabAllocator::getStats()
+{
+    std::vector<Stats> stats;
+    SizeClass* sizeClasses = getSizeClasses();
+    for (uint32_t i = 0; i <= LargeClass; i++)
+    {
+        SizeClass& sc = sizeClasses[i];
+        uint64_t allocations = sc.allocations.load(std::memory_order_relaxed);
+        if (allocations == 0 && i != LargeClass)
+        {
+            continue;
+        }
+        Stats stat;
+        stat.blockSize = i == LargeClass ? 0 : getBlockSize(i);
+        stat.slabs = sc.slabs.load(std::memory_order_relaxed);
+        stat.liveBlocks = sc.liveBlocks.load(std::memory_order_relaxed);
+        stat.allocations = allocations;
+        stat.frees = sc.frees.load(std::memory_order_relaxed);
+        stats.push_back(stat);
+    }
+    return stats;
+}
+
+std::string SlabAllocator::getDescription()
+{
+    std::string out;
+    char line[160];
+    size_t slabBytes = 0;
+    for (const Stats& stat : getStats())
+    {
+        if (stat.blockSize == 0)
+        {
+            snprintf(line, sizeof(line), "  oversized: live %u, allocations %llu, frees %llu\n",
+                stat.liveBlocks, (unsigned long long)stat.allocations, (unsigned long long)stat.frees);
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "  %5u bytes: slabs %u, live %u, allocations %llu, frees %llu\n",
+                (unsigned)stat.blockSize, stat.slabs, stat.liveBlocks, (unsigned long long)stat.allocations, (unsigned long long)stat.frees);
+            slabBytes += stat.slabs * SlabSize;
+        }
+        out += line;
+    }
+    snprintf(line, sizeof(line), "SlabAllocator: %u KB in slabs\n", (unsigned)(slabBytes / 1024));
+    return line + out;
+}
+
+NS_CC_END
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <new>
+
+NS_CC_BEGIN
+
+/** @brief Size class allocator for small engine objects that come and go every frame.
+ Blocks of one size class are carved from 64KB slabs and recycled through a
+ free list cached per thread, backed by a shared depot per size class.
+ Sizes over MaxBlockSize go to the system allocator. Slab memory is kept
+ for reuse and never handed back to the system, so churn neither hits the
+ heap nor fragments it.
+ Classes opt in with CC_SLAB_ALLOCATED, subclasses inherit it.
+ */
+
+class CC_DLL SlabAllocator
+{
+public:
+    static const size_t Granularity = 16;
+    static const size_t MaxBlockSize = 4096;
+    static const size_t SlabSize = 64 * 1024;
+    static const int ClassCount = static_cast<int>(MaxBlockSize / Granularity);
+
+    struct Stats
+    {
+        size_t blockSize;
+        uint32_t slabs;
+        uint32_t liveBlocks;
+        uint64_t allocations;
+        uint64_t frees;
+    };
+
+    /** Returns 16 bytes aligned memory, nullptr when out of memory. */
+    static void* allocate(size_t size);
+    /** Same as allocate, but throws std::bad_alloc when out of memory. */
+    static void* allocateOrThrow(size_t size);
+    static void deallocate(void* p);
+
+    /** Stats of the size classes used so far, the last entry accounts for the oversized blocks. */
+    static std::vector<Stats> getStats();
+    static std::string getDescription();
+};
+
+NS_CC_END
+
+#if CC_ENABLE_SLAB_ALLOCATOR
+#define CC_SLAB_ALLOCATED \
+public: \
+    static void* operator new(size_t size) { return cocos2d::SlabAllocator::allocateOrThrow(size); } \
+    static void* operator new(size_t size, const std::nothrow_t&) noexcept { return cocos2d::SlabAllocator::allocate(size); } \
+    static void* operator new(size_t, void* where) noexcept { return where; } \
+    static void operator delete(void* p) { cocos2d::SlabAllocator::deallocate(p); } \
+    static void operator delete(void* p, const std::nothrow_t&) noexcept { cocos2d::SlabAllocator::deallocate(p); } \
+    static void operator delete(void*, void*) noexcept {}
+#else
+#define CC_SLAB_ALLOCATED
+#endif
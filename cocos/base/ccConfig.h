@@ -288,6 +288,28 @@ THE SOFTWARE.
 #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_ENABLE_TRACING
+ * If enabled, CC_TRACE_SCOPE records timestamped events into per-thread ring buffers
+ * that can be exported as Chrome trace JSON, see Trace.
+ * Recording itself still has to be switched on at runtime with Trace::setEnabled or the "trace" console command.
+ * Enabled by default in debug builds.
+ */
+#ifndef CC_ENABLE_TRACING
+#if defined(COCOS2D_DEBUG) && COCOS2D_DEBUG > 0
+#define CC_ENABLE_TRACING 1
+#else
+#define CC_ENABLE_TRACING 0
+#endif
+#endif
+
+/** @def CC_ENABLE_SLAB_ALLOCATOR
+ * If enabled, Node, Action and their subclasses are allocated from the size class slabs of SlabAllocator
+ * instead of the system heap. Turn it off to track their memory with ASan or other heap tools.
+ */
+#ifndef CC_ENABLE_SLAB_ALLOCATOR
+#define CC_ENABLE_SLAB_ALLOCATOR 1
+#endif
+
 /** Enable Lua engine debug log. */
 #ifndef CC_LUA_ENGINE_DEBUG
 #define CC_LUA_ENGINE_DEBUG 0
@@ -27,6 +27,15 @@
 #include "base/ccUTF8.h"
 #include "platform/CCCommon.h"
 #include "ConvertUTF/ConvertUTF.h"
+// CC_UTF_NO_SIMD keeps the scalar loops, tools/utf-bench checks them against the SIMD ones
+#if defined(CC_UTF_NO_SIMD)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTF_USE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define UTF_USE_NEON
+#include <arm_neon.h>
+#endif
 
 NS_CC_BEGIN
 
@@ -197,9 +206,154 @@ bool utfConvert(
 };
 
 
+// Widens the ASCII bytes at the start of in, 16 at a time, returns how many there were.
+static size_t widenAscii(const char* in, size_t length, char16_t* out)
+{
+    size_t i = 0;
+#if defined(UTF_USE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        if (_mm_movemask_epi8(bytes) != 0)
+        {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(bytes, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(bytes, zero));
+    }
+#elif defined(UTF_USE_NEON)
+    for (; i + 16 <= length; i += 16)
+    {
+        uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(in + i));
+        uint8x8_t any = vorr_u8(vget_low_u8(bytes), vget_high_u8(bytes));
+        if (vget_lane_u64(vreinterpret_u64_u8(any), 0) & 0x8080808080808080ULL)
+        {
+            break;
+        }
+        vst1q_u16(reinterpret_cast<uint16_t*>(out + i), vmovl_u8(vget_low_u8(bytes)));
+        vst1q_u16(reinterpret_cast<uint16_t*>(out + i + 8), vmovl_u8(vget_high_u8(bytes)));
+    }
+#endif
+    for (; i < length && static_cast<unsigned char>(in[i]) < 0x80; ++i)
+    {
+        out[i] = in[i];
+    }
+    return i;
+}
+
+// Narrows the UTF-16 units below 0x80 at the start of in, 16 at a time, returns how many there were.
+static size_t narrowAscii(const char16_t* in, size_t length, char* out)
+{
+    size_t i = 0;
+#if defined(UTF_USE_SSE2)
+    const __m128i high = _mm_set1_epi16(static_cast<short>(0xff80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+        __m128i any = _mm_and_si128(_mm_or_si128(low, next), high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(any, zero)) != 0xffff)
+        {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(low, next));
+    }
+#elif defined(UTF_USE_NEON)
+    for (; i + 16 <= length; i += 16)
+    {
+        uint16x8_t low = vld1q_u16(reinterpret_cast<const uint16_t*>(in + i));
+        uint16x8_t next = vld1q_u16(reinterpret_cast<const uint16_t*>(in + i + 8));
+        uint16x8_t any = vandq_u16(vorrq_u16(low, next), vdupq_n_u16(0xff80));
+        uint16x4_t folded = vorr_u16(vget_low_u16(any), vget_high_u16(any));
+        if (vget_lane_u64(vreinterpret_u64_u16(folded), 0) != 0)
+        {
+            break;
+        }
+        vst1q_u8(reinterpret_cast<uint8_t*>(out + i), vcombine_u8(vmovn_u16(low), vmovn_u16(next)));
+    }
+#endif
+    for (; i < length && in[i] < 0x80; ++i)
+    {
+        out[i] = static_cast<char>(in[i]);
+    }
+    return i;
+}
+
+static inline bool isContinuation(char byte)
+{
+    return (static_cast<unsigned char>(byte) & 0xC0) == 0x80;
+}
+
 bool UTF8ToUTF16(const std::string& utf8, std::u16string& outUtf16)
 {
-    return utfConvert(utf8, outUtf16, ConvertUTF8toUTF16);
+    if (utf8.empty())
+    {
+        outUtf16.clear();
+        return true;
+    }
+
+    // a UTF-8 sequence never becomes more UTF-16 units than it has bytes
+    std::u16string working(utf8.length(), 0);
+    const char* in = utf8.data();
+    const char* inEnd = in + utf8.length();
+    char16_t* out = &working[0];
+    char16_t* outEnd = out + working.length();
+
+    while (in < inEnd)
+    {
+        size_t ascii = widenAscii(in, inEnd - in, out);
+        in += ascii;
+        out += ascii;
+
+        // two and three byte sequences, checked as strictly as ConvertUTF does
+        while (in < inEnd)
+        {
+            unsigned char lead = static_cast<unsigned char>(in[0]);
+            if (lead < 0x80)
+            {
+                break;
+            }
+            if (lead >= 0xC2 && lead <= 0xDF && inEnd - in >= 2 && isContinuation(in[1]))
+            {
+                *out++ = static_cast<char16_t>(((lead & 0x1F) << 6) | (in[1] & 0x3F));
+                in += 2;
+                continue;
+            }
+            if (lead >= 0xE0 && lead <= 0xEF && inEnd - in >= 3 && isContinuation(in[1]) && isContinuation(in[2]))
+            {
+                unsigned char second = static_cast<unsigned char>(in[1]);
+                // no overlong forms and no surrogates
+                if ((lead != 0xE0 || second >= 0xA0) && (lead != 0xED || second < 0xA0))
+                {
+                    *out++ = static_cast<char16_t>(((lead & 0x0F) << 12) | ((second & 0x3F) << 6) | (in[2] & 0x3F));
+                    in += 3;
+                    continue;
+                }
+            }
+
+            // four byte sequences and invalid input go through ConvertUTF up to the next ASCII byte,
+            // no byte of a multi-byte sequence is ASCII so a sequence cut there is invalid either way
+            const char* run = in;
+            while (run < inEnd && static_cast<unsigned char>(*run) >= 0x80)
+            {
+                ++run;
+            }
+            auto source = reinterpret_cast<const UTF8*>(in);
+            auto target = reinterpret_cast<UTF16*>(out);
+            if (ConvertUTF8toUTF16(&source, reinterpret_cast<const UTF8*>(run), &target, reinterpret_cast<UTF16*>(outEnd), strictConversion) != conversionOK)
+            {
+                return false;
+            }
+            in = reinterpret_cast<const char*>(source);
+            out = reinterpret_cast<char16_t*>(target);
+        }
+    }
+
+    working.resize(out - &working[0]);
+    outUtf16 = std::move(working);
+    return true;
 }
 
 bool UTF8ToUTF32(const std::string& utf8, std::u32string& outUtf32)
@@ -209,7 +363,70 @@ bool UTF8ToUTF32(const std::string& utf8, std::u32string& outUtf32)
 
 bool UTF16ToUTF8(const std::u16string& utf16, std::string& outUtf8)
 {
-    return utfConvert(utf16, outUtf8, ConvertUTF16toUTF8);
+    if (utf16.empty())
+    {
+        outUtf8.clear();
+        return true;
+    }
+
+    // a unit takes at most 3 bytes, a surrogate pair 4
+    std::string working(utf16.length() * 3, 0);
+    const char16_t* in = utf16.data();
+    const char16_t* inEnd = in + utf16.length();
+    char* out = &working[0];
+    char* outEnd = out + working.length();
+
+    while (in < inEnd)
+    {
+        size_t ascii = narrowAscii(in, inEnd - in, out);
+        in += ascii;
+        out += ascii;
+
+        while (in < inEnd)
+        {
+            char16_t unit = *in;
+            if (unit < 0x80)
+            {
+                break;
+            }
+            if (unit < 0x800)
+            {
+                out[0] = static_cast<char>(0xC0 | (unit >> 6));
+                out[1] = static_cast<char>(0x80 | (unit & 0x3F));
+                out += 2;
+                ++in;
+                continue;
+            }
+            if (unit < 0xD800 || unit > 0xDFFF)
+            {
+                out[0] = static_cast<char>(0xE0 | (unit >> 12));
+                out[1] = static_cast<char>(0x80 | ((unit >> 6) & 0x3F));
+                out[2] = static_cast<char>(0x80 | (unit & 0x3F));
+                out += 3;
+                ++in;
+                continue;
+            }
+
+            // surrogate pairs and lone surrogates go through ConvertUTF up to the next ASCII unit
+            const char16_t* run = in;
+            while (run < inEnd && *run >= 0x80)
+            {
+                ++run;
+            }
+            auto source = reinterpret_cast<const UTF16*>(in);
+            auto target = reinterpret_cast<UTF8*>(out);
+            if (ConvertUTF16toUTF8(&source, reinterpret_cast<const UTF16*>(run), &target, reinterpret_cast<UTF8*>(outEnd), strictConversion) != conversionOK)
+            {
+                return false;
+            }
+            in = reinterpret_cast<const char16_t*>(source);
+            out = reinterpret_cast<char*>(target);
+        }
+    }
+
+    working.resize(out - &working[0]);
+    outUtf8 = std::move(working);
+    return true;
 }
     
 bool UTF16ToUTF32(const std::u16string& utf16, std::u32string& outUtf32)
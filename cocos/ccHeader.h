@@ -43,6 +43,8 @@ using namespace silly::slice;
 #include "base/ccTypes.h"
 using namespace cocos2d::Switch::Literals;
 #include "base/ccConfig.h"
+#include "base/CCTrace.h"
+#include "base/SlabAllocator.h"
 #include "base/Singleton.h"
 #include "base/Own.h"
 #include "base/CCRef.h"
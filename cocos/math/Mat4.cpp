@@ -696,6 +696,29 @@ bool Mat4::inverse()
     return true;
 }
 
+bool Mat4::inverseAffine()
+{
+    float a = m[0], b = m[1], c = m[4], d = m[5];
+    float det2 = a * d - b * c;
+
+    // Same test as inverse(), the determinant of the whole matrix.
+    if (std::abs(det2 * m[10]) <= MATH_TOLERANCE)
+        return false;
+
+    float inv = 1.0f / det2;
+    float tx = m[12], ty = m[13];
+    m[0] = d * inv;
+    m[1] = -b * inv;
+    m[4] = -c * inv;
+    m[5] = a * inv;
+    m[12] = -(m[0] * tx + m[4] * ty);
+    m[13] = -(m[1] * tx + m[5] * ty);
+    m[14] = -m[14] / m[10];
+    m[10] = 1.0f / m[10];
+
+    return true;
+}
+
 bool Mat4::isIdentity() const
 {
     return (memcmp(m, &IDENTITY, MATRIX_SIZE) == 0);
@@ -736,6 +759,16 @@ void Mat4::multiply(const Mat4& m1, const Mat4& m2, Mat4* dst)
 #endif
 }
 
+void Mat4::multiplyAffine(const Mat4& m1, const Mat4& m2, Mat4* dst)
+{
+    GP_ASSERT(dst);
+#ifdef __SSE__
+    MathUtil::multiplyAffineMatrix(m1.col, m2.col, dst->col);
+#else
+    MathUtil::multiplyAffineMatrix(m1.m, m2.m, dst->m);
+#endif
+}
+
 void Mat4::negate()
 {
 #ifdef __SSE__
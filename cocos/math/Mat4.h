@@ -503,6 +503,14 @@ public:
      */
     bool inverse();
 
+    /**
+     * Inverts this matrix, which must be a 2D affine matrix as described in
+     * multiplyAffine. Same result as inverse() in a fraction of the work.
+     *
+     * @return true if the matrix can be inverted, false otherwise.
+     */
+    bool inverseAffine();
+
     /**
      * Get the inversed matrix.
      */
@@ -555,6 +563,17 @@ public:
      */
     static void multiply(const Mat4& m1, const Mat4& m2, Mat4* dst);
 
+    /**
+     * Multiplies m1 by the 2D affine matrix m2 and stores the result in dst.
+     * m2 may only rotate and skew in the XY plane, scale and translate, the
+     * other terms of m2 are taken from the identity and never read.
+     *
+     * @param m1 The first matrix to multiply.
+     * @param m2 The 2D affine matrix to multiply.
+     * @param dst A matrix to store the result in.
+     */
+    static void multiplyAffine(const Mat4& m1, const Mat4& m2, Mat4* dst);
+
     /**
      * Negates this matrix.
      */
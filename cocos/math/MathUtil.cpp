@@ -206,6 +206,11 @@ void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* dst)
 #endif
 }
 
+void MathUtil::multiplyAffineMatrix(const float* m1, const float* m2, float* dst)
+{
+    MathUtilC::multiplyAffineMatrix(m1, m2, dst);
+}
+
 void MathUtil::negateMatrix(const float* m, float* dst)
 {
 #ifdef USE_NEON32
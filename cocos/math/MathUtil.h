@@ -116,6 +116,8 @@ private:
 
     static void multiplyMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst[4]);
 
+    static void multiplyAffineMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst[4]);
+
     static void negateMatrix(const __m128 m[4], __m128 dst[4]);
 
     static void transposeMatrix(const __m128 m[4], __m128 dst[4]);
@@ -132,6 +134,8 @@ private:
 
     static void multiplyMatrix(const float* m1, const float* m2, float* dst);
 
+    static void multiplyAffineMatrix(const float* m1, const float* m2, float* dst);
+
     static void negateMatrix(const float* m, float* dst);
 
     static void transposeMatrix(const float* m, float* dst);
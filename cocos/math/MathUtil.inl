@@ -33,6 +33,8 @@ public:
     
     inline static void multiplyMatrix(const float* m1, const float* m2, float* dst);
     
+    inline static void multiplyAffineMatrix(const float* m1, const float* m2, float* dst);
+    
     inline static void negateMatrix(const float* m, float* dst);
     
     inline static void transposeMatrix(const float* m, float* dst);
@@ -152,6 +154,34 @@ inline void MathUtilC::multiplyMatrix(const float* m1, const float* m2, float* d
     memcpy(dst, product, MATRIX_SIZE);
 }
 
+inline void MathUtilC::multiplyAffineMatrix(const float* m1, const float* m2, float* dst)
+{
+    // m2 only uses m[0], m[1], m[4], m[5], m[10] and the translation, the other terms are skipped.
+    float product[16];
+    
+    product[0]  = m1[0] * m2[0]  + m1[4] * m2[1];
+    product[1]  = m1[1] * m2[0]  + m1[5] * m2[1];
+    product[2]  = m1[2] * m2[0]  + m1[6] * m2[1];
+    product[3]  = m1[3] * m2[0]  + m1[7] * m2[1];
+    
+    product[4]  = m1[0] * m2[4]  + m1[4] * m2[5];
+    product[5]  = m1[1] * m2[4]  + m1[5] * m2[5];
+    product[6]  = m1[2] * m2[4]  + m1[6] * m2[5];
+    product[7]  = m1[3] * m2[4]  + m1[7] * m2[5];
+    
+    product[8]  = m1[8]  * m2[10];
+    product[9]  = m1[9]  * m2[10];
+    product[10] = m1[10] * m2[10];
+    product[11] = m1[11] * m2[10];
+    
+    product[12] = m1[0] * m2[12] + m1[4] * m2[13] + m1[8]  * m2[14] + m1[12];
+    product[13] = m1[1] * m2[12] + m1[5] * m2[13] + m1[9]  * m2[14] + m1[13];
+    product[14] = m1[2] * m2[12] + m1[6] * m2[13] + m1[10] * m2[14] + m1[14];
+    product[15] = m1[3] * m2[12] + m1[7] * m2[13] + m1[11] * m2[14] + m1[15];
+    
+    memcpy(dst, product, MATRIX_SIZE);
+}
+
 inline void MathUtilC::negateMatrix(const float* m, float* dst)
 {
     dst[0]  = -m[0];
@@ -116,6 +116,32 @@ void MathUtil::multiplyMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst
     dst[3] = dst3;
 }
 
+void MathUtil::multiplyAffineMatrix(const __m128 m1[4], const __m128 m2[4], __m128 dst[4])
+{
+    // m2 only uses m[0], m[1], m[4], m[5], m[10] and the translation, the other terms are skipped.
+    __m128 a = _mm_shuffle_ps(m2[0], m2[0], _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 b = _mm_shuffle_ps(m2[0], m2[0], _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 c = _mm_shuffle_ps(m2[1], m2[1], _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 d = _mm_shuffle_ps(m2[1], m2[1], _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 sz = _mm_shuffle_ps(m2[2], m2[2], _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 tx = _mm_shuffle_ps(m2[3], m2[3], _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 ty = _mm_shuffle_ps(m2[3], m2[3], _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 tz = _mm_shuffle_ps(m2[3], m2[3], _MM_SHUFFLE(2, 2, 2, 2));
+    
+    __m128 dst0 = _mm_add_ps(_mm_mul_ps(m1[0], a), _mm_mul_ps(m1[1], b));
+    __m128 dst1 = _mm_add_ps(_mm_mul_ps(m1[0], c), _mm_mul_ps(m1[1], d));
+    __m128 dst2 = _mm_mul_ps(m1[2], sz);
+    __m128 dst3 = _mm_add_ps(
+                             _mm_add_ps(_mm_mul_ps(m1[0], tx), _mm_mul_ps(m1[1], ty)),
+                             _mm_add_ps(_mm_mul_ps(m1[2], tz), m1[3])
+                             );
+    
+    dst[0] = dst0;
+    dst[1] = dst1;
+    dst[2] = dst2;
+    dst[3] = dst3;
+}
+
 void MathUtil::negateMatrix(const __m128 m[4], __m128 dst[4])
 {
     __m128 z = _mm_setzero_ps();
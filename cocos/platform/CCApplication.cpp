@@ -79,6 +79,7 @@ Application::~Application()
 int Application::mainLogic(bx::Thread* thread, void* userData)
 {
     Application* app = reinterpret_cast<Application*>(userData);
+    CC_TRACE_THREAD_NAME("Logic");
 
     auto director = &SharedDirector;
     //app->setMaxFPS(60.0f);
@@ -113,152 +114,119 @@ int Application::mainLogic(bx::Thread* thread, void* userData)
 
     while (!glview->windowShouldClose())
     {
-        for (Own<QEvent> event = app->logicEvent_.poll();
-            event != nullptr; event = app->logicEvent_.poll())
+        app->logicEvent_.poll([glview](const TEvent& event)
         {
-            switch (Switch::hash(event->getName()))
+            switch (event.getId())
             {
 #if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
-            case "Mouse"_hash:
+            case AppEvent::Mouse::Id:
             {
-                int button, action, modify;
-                event->get(button, action, modify);
-                glview->mouseEvent(button, action, modify);
+                const auto& msg = event.get<AppEvent::Mouse>();
+                glview->mouseEvent(msg.button, msg.action, msg.modify);
             }
             break;
-            case "MouseMove"_hash:
+            case AppEvent::MouseMove::Id:
             {
-                intptr_t windowPtr;
-                double x, y;
-                event->get(windowPtr, x, y);
-                glview->mouseMoveEvent(reinterpret_cast<void*>(windowPtr), x, y);
+                const auto& msg = event.get<AppEvent::MouseMove>();
+                glview->mouseMoveEvent(reinterpret_cast<void*>(msg.window), msg.x, msg.y);
             }
             break;
-            case "MouseScroll"_hash:
+            case AppEvent::MouseScroll::Id:
             {
-                intptr_t windowPtr;
-                double x, y;
-                event->get(windowPtr, x, y);
-                glview->mouseScrollEvent(reinterpret_cast<void*>(windowPtr), x, y);
+                const auto& msg = event.get<AppEvent::MouseScroll>();
+                glview->mouseScrollEvent(reinterpret_cast<void*>(msg.window), msg.x, msg.y);
             }
             break;
-            case "Key"_hash:
+            case AppEvent::Key::Id:
             {
-                intptr_t windowPtr;
-                int key, scancode, action, mods;
-                event->get(windowPtr, key, scancode, action, mods);
-                glview->keyEvent(reinterpret_cast<void*>(windowPtr), key, scancode, action, mods);
+                const auto& msg = event.get<AppEvent::Key>();
+                glview->keyEvent(reinterpret_cast<void*>(msg.window), msg.key, msg.scancode, msg.action, msg.mods);
             }
             break;
-            case "Char"_hash:
+            case AppEvent::Char::Id:
             {
-                intptr_t windowPtr;
-                uint32_t character;
-                event->get(windowPtr, character);
-                glview->charEvent(reinterpret_cast<void*>(windowPtr), character);
+                const auto& msg = event.get<AppEvent::Char>();
+                glview->charEvent(reinterpret_cast<void*>(msg.window), msg.character);
             }
             break;
-            case "WindowPos"_hash:
+            case AppEvent::WindowPos::Id:
             {
-                intptr_t windowPtr;
-                int x, y;
-                event->get(windowPtr, x, y);
-                glview->posEvent(reinterpret_cast<void*>(windowPtr), x, y);
+                const auto& msg = event.get<AppEvent::WindowPos>();
+                glview->posEvent(reinterpret_cast<void*>(msg.window), msg.x, msg.y);
             }
             break;
-            case "FramebufferSize"_hash:
+            case AppEvent::FramebufferSize::Id:
             {
-                intptr_t windowPtr;
-                int width, height;
-                event->get(windowPtr, width, height);
-                glview->framebufferSizeEvent(reinterpret_cast<void*>(windowPtr), width, height);
+                const auto& msg = event.get<AppEvent::FramebufferSize>();
+                glview->framebufferSizeEvent(reinterpret_cast<void*>(msg.window), msg.width, msg.height);
             }
             break;
-            case "WindowSize"_hash:
+            case AppEvent::WindowSize::Id:
             {
-                intptr_t windowPtr;
-                int width, height;
-                event->get(windowPtr, width, height);
-                glview->sizeEvent(reinterpret_cast<void*>(windowPtr), width, height);
+                const auto& msg = event.get<AppEvent::WindowSize>();
+                glview->sizeEvent(reinterpret_cast<void*>(msg.window), msg.width, msg.height);
             }
             break;
-            case "Iconify"_hash:
+            case AppEvent::Iconify::Id:
             {
-                intptr_t windowPtr;
-                int iconified;
-                event->get(windowPtr, iconified);
-                glview->iconifyEvent(reinterpret_cast<void*>(windowPtr), iconified);
+                const auto& msg = event.get<AppEvent::Iconify>();
+                glview->iconifyEvent(reinterpret_cast<void*>(msg.window), msg.iconified);
             }
             break;
 #endif
 #if CC_TARGET_PLATFORM == CC_PLATFORM_IOS
-            case "TouchesBegin"_hash:
+            case AppEvent::TouchesBegin::Id:
             {
-                int num;
-                TouchEventBEC ev;
-                event->get(num, ev);
-                glview->handleTouchesBegin(num, ev.ids, ev.xs, ev.ys);
+                auto& msg = event.get<AppEvent::TouchesBegin>();
+                glview->handleTouchesBegin(msg.num, msg.ev.ids, msg.ev.xs, msg.ev.ys);
             }
             break;
-            case "TouchesMove"_hash:
+            case AppEvent::TouchesMove::Id:
             {
-                int num;
-                TouchEventMove ev;
-                event->get(num, ev);
-                glview->handleTouchesMove(num, ev.ids, ev.xs, ev.ys, ev.fs, ev.ms);
+                auto& msg = event.get<AppEvent::TouchesMove>();
+                glview->handleTouchesMove(msg.num, msg.ev.ids, msg.ev.xs, msg.ev.ys, msg.ev.fs, msg.ev.ms);
             }
             break;
-            case "TouchesEnd"_hash:
+            case AppEvent::TouchesEnd::Id:
             {
-                int num;
-                TouchEventBEC ev;
-                event->get(num, ev);
-                glview->handleTouchesEnd(num, ev.ids, ev.xs, ev.ys);
+                auto& msg = event.get<AppEvent::TouchesEnd>();
+                glview->handleTouchesEnd(msg.num, msg.ev.ids, msg.ev.xs, msg.ev.ys);
             }
             break;
-            case "TouchesCancel"_hash:
+            case AppEvent::TouchesCancel::Id:
             {
-                int num;
-                TouchEventBEC ev;
-                event->get(num, ev);
-                glview->handleTouchesCancel(num, ev.ids, ev.xs, ev.ys);
+                auto& msg = event.get<AppEvent::TouchesCancel>();
+                glview->handleTouchesCancel(msg.num, msg.ev.ids, msg.ev.xs, msg.ev.ys);
             }
             break;
 #endif
-            case "Invoke"_hash:
+            case AppEvent::Invoke::Id:
             {
-                std::function<void()> func;
-                event->get(func);
-                func();
+                event.get<AppEvent::Invoke>().func();
             }
             break;
             }
-        }
+        });
 
         director->mainLoop();
 
         app->_cpuTime = app->getElapsedTime();
         // advance to next frame. rendering thread will be kicked to
         // process submitted rendering primitives.
-        app->frame_ = bgfx::frame();
+        {
+            CC_TRACE_SCOPE("bgfx::frame");
+            double presentBegin = app->getCurrentTime();
+            app->frame_ = bgfx::frame();
+            app->_framePacer.presented(presentBegin, app->getCurrentTime());
+        }
 
         // limit for max FPS
         if (app->_fpsLimited)
         {
-            app->updateDeltaTime();
-            while (app->getDeltaTime() < 1.0 / app->_maxFPS)
-            {
-                int32_t waitMS = (1.0 / app->_maxFPS - app->getDeltaTime()) * 1000;
-#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
-                Sleep(waitMS);
-#endif
-                app->updateDeltaTime();
-            }
-        }
-        else
-        {
-            app->updateDeltaTime();
+            CC_TRACE_SCOPE("FramePacer::wait");
+            app->_framePacer.wait(app->_lastTime);
         }
+        app->updateDeltaTime();
         app->makeTimeNow();
     }
 
@@ -306,27 +274,24 @@ int Application::run()
 
     // start running logic thread
     _logicThread.init(Application::mainLogic, this);
+    CC_TRACE_THREAD_NAME("Render");
 
 
     while (!glView_->windowShouldClose())
     {
         glView_->pollEvents();
 
-        for (Own<QEvent> event = renderEvent_.poll();
-            event != nullptr;
-            event = renderEvent_.poll())
+        renderEvent_.poll([](const TEvent& event)
         {
-            switch (Switch::hash(event->getName()))
+            switch (event.getId())
             {
-            case "Invoke"_hash:
+            case AppEvent::Invoke::Id:
             {
-                std::function<void()> func;
-                event->get(func);
-                func();
+                event.get<AppEvent::Invoke>().func();
             }
             break;
             }
-        }
+        });
 
         Application::renderFrame();
     }
@@ -344,21 +309,17 @@ int Application::run()
 #if CC_TARGET_PLATFORM == CC_PLATFORM_IOS
 void Application::iOSEventLoop()
 {
-    for (Own<QEvent> event = renderEvent_.poll();
-         event != nullptr;
-         event = renderEvent_.poll())
+    renderEvent_.poll([](const TEvent& event)
     {
-        switch (Switch::hash(event->getName()))
+        switch (event.getId())
         {
-            case "Invoke"_hash:
+            case AppEvent::Invoke::Id:
             {
-                std::function<void()> func;
-                event->get(func);
-                func();
+                event.get<AppEvent::Invoke>().func();
             }
                 break;
         }
-    }
+    });
     
     Application::renderFrame();
 }
@@ -373,12 +334,12 @@ void Application::setStartupScriptFilename(const std::string& startupScriptFile)
 
 void Application::invokeInRenderer(const std::function<void()>& func)
 {
-    renderEvent_.post("Invoke"_slice, func);
+    renderEvent_.post(AppEvent::Invoke{func});
 }
 
 void Application::invokeInLogic(const std::function<void()>& func)
 {
-    logicEvent_.post("Invoke"_slice, func);
+    logicEvent_.post(AppEvent::Invoke{func});
 }
 
 void Application::setAppDelegate(ApplicationProtocol* app)
@@ -597,6 +558,7 @@ double Application::getTotalTime() const
 void Application::setMaxFPS(uint32_t var)
 {
     _maxFPS = var;
+    _framePacer.setInterval(1.0 / var);
     SharedDirector.setAnimationInterval(1.0f / var);
 }
 
@@ -29,12 +29,32 @@ THE SOFTWARE.
 #include "platform/CCApplicationProtocol.h"
 #include "platform/CCCommon.h"
 #include "base/EventQueue.h"
+#include "platform/CCFramePacer.h"
 
 NS_CC_BEGIN
 
 class GLView;
 class Rect;
 
+/** Messages posted to the logic and render threads through Application. */
+namespace AppEvent
+{
+    struct Invoke { static constexpr std::size_t Id = "Invoke"_hash; std::function<void()> func; };
+    struct Mouse { static constexpr std::size_t Id = "Mouse"_hash; int button, action, modify; };
+    struct MouseMove { static constexpr std::size_t Id = "MouseMove"_hash; intptr_t window; double x, y; };
+    struct MouseScroll { static constexpr std::size_t Id = "MouseScroll"_hash; intptr_t window; double x, y; };
+    struct Key { static constexpr std::size_t Id = "Key"_hash; intptr_t window; int key, scancode, action, mods; };
+    struct Char { static constexpr std::size_t Id = "Char"_hash; intptr_t window; uint32_t character; };
+    struct WindowPos { static constexpr std::size_t Id = "WindowPos"_hash; intptr_t window; int x, y; };
+    struct FramebufferSize { static constexpr std::size_t Id = "FramebufferSize"_hash; intptr_t window; int width, height; };
+    struct WindowSize { static constexpr std::size_t Id = "WindowSize"_hash; intptr_t window; int width, height; };
+    struct Iconify { static constexpr std::size_t Id = "Iconify"_hash; intptr_t window; int iconified; };
+    struct TouchesBegin { static constexpr std::size_t Id = "TouchesBegin"_hash; int num; TouchEventBEC ev; };
+    struct TouchesMove { static constexpr std::size_t Id = "TouchesMove"_hash; int num; TouchEventMove ev; };
+    struct TouchesEnd { static constexpr std::size_t Id = "TouchesEnd"_hash; int num; TouchEventBEC ev; };
+    struct TouchesCancel { static constexpr std::size_t Id = "TouchesCancel"_hash; int num; TouchEventBEC ev; };
+}
+
 class CC_DLL Application
 {
 public:
@@ -98,10 +118,10 @@ public:
         return _startupScriptFilename;
     }
 
-    template<typename... Args>
-    void postEventToLogic(String name, const Args& ...args)
+    template<typename Msg>
+    void postEventToLogic(const Msg& msg)
     {
-        logicEvent_.post(name, args...);
+        logicEvent_.post(msg);
     }
 
     void invokeInRenderer(const std::function<void()>& func);
@@ -159,6 +179,9 @@ public:
     * @lua NA
     */
     void applicationWillEnterForeground() { _appDelegate->applicationWillEnterForeground(); }
+
+    /** Paces the logic thread to MaxFPS, its mode and pacing statistics are set and read here. */
+    inline FramePacer* getFramePacer() { return &_framePacer; }
 protected:
     Application();
     void updateDeltaTime();
@@ -191,11 +214,13 @@ private:
     double _deltaTime;
     double _cpuTime;
     double _totalTime;
+    FramePacer _framePacer;
 
     ApplicationProtocol* _appDelegate;
 
-    EventQueue logicEvent_;
-    EventQueue renderEvent_;
+    // touch messages are ~250 bytes, keep them inline so input never touches the pool
+    TypedEventQueue<256, 256> logicEvent_;
+    TypedEventQueue<64> renderEvent_;
 
     SINGLETON_REF(Application, AsyncLogThread);
 };
@@ -29,7 +29,7 @@ THE SOFTWARE.
 
 #include "base/CCData.h"
 #include "base/CCDirector.h"
-#include "base/Async.h"
+#include "base/JobSystem.h"
 #include "platform/CCSAXParser.h"
 
 #include "tinyxml2/tinyxml2.h"
@@ -658,7 +658,7 @@ Data FileUtils::getDataFromFile(const std::string& filename)
 void FileUtils::loadFileAsyncUnsafe(String filename, const std::function<void(uint8_t*, ssize_t)>& callback)
 {
     std::string fileStr = filename;
-    SharedAsyncThread.FileIO.run([fileStr, this]()
+    SharedJobSystem.run([fileStr, this]()
     {
         ssize_t size = 0;
         uint8_t* buffer = this->getFileData(fileStr, "rb", &size);
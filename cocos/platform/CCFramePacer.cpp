@@ -0,0 +1,237 @@
+#include "ccHeader.h"
+#include "platform/CCFramePacer.h"
+#include "bx/timer.h"
+#include <thread>
+#if BX_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <cerrno>
+#include <time.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace
+{
+    // bounds of the time spun after sleeping, sleeps wake up late by up to the tail
+    const double MinSpinTail = 0.0002;
+    const double MaxSpinTail = 0.004;
+    // a frame starting later than this after it was due counts as late
+    const double LateThreshold = 0.0005;
+    const int MaxCadence = 4;
+    // frames the work must fit a shorter cadence before stepping down to it
+    const int CadenceDownFrames = 60;
+}
+
+FramePacer::FramePacer()
+    :mode_(Mode::Adaptive)
+    ,interval_(1.0 / 60.0)
+    ,frequency_(double(bx::getHPFrequency()))
+    ,cadence_(1)
+    ,cadenceDownFrames_(0)
+    ,averageWork_(0)
+    ,nextDue_(0)
+#if BX_PLATFORM_WINDOWS
+    ,spinTail_(0.002)
+#else
+    ,spinTail_(0.0005)
+#endif
+    ,presentBlock_(0)
+    ,vsyncBound_(false)
+{
+#if BX_PLATFORM_WINDOWS
+    // CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, missing before Windows 10 1803 where Sleep's 1 ms timer remains
+    timer_ = CreateWaitableTimerExW(nullptr, nullptr, 0x00000002, TIMER_ALL_ACCESS);
+    if (!timer_)
+    {
+        timer_ = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+    }
+#endif
+    resetStats();
+}
+
+FramePacer::~FramePacer()
+{
+#if BX_PLATFORM_WINDOWS
+    if (timer_)
+    {
+        CloseHandle(timer_);
+    }
+#endif
+}
+
+void FramePacer::setInterval(double interval)
+{
+    interval_ = interval;
+    nextDue_ = 0;
+}
+
+void FramePacer::setMode(Mode mode)
+{
+    mode_ = mode;
+    cadence_ = 1;
+    cadenceDownFrames_ = 0;
+    nextDue_ = 0;
+}
+
+void FramePacer::presented(double begin, double end)
+{
+    // bgfx::frame waits for the render thread, which waits for the swap when vsync holds it,
+    // presents blocking for a good part of the interval mean the frames are paced already
+    // a sample counts for an interval at most, so one long present (a hitch, a resize) can't
+    // set the flag alone, and the flag clears below half its threshold so it doesn't flicker
+    double block = std::min(end - begin, interval_);
+    presentBlock_ = presentBlock_ * 0.9 + block * 0.1;
+    if (presentBlock_ > interval_ * 0.25)
+    {
+        vsyncBound_ = true;
+    }
+    else if (presentBlock_ < interval_ * 0.125)
+    {
+        vsyncBound_ = false;
+    }
+}
+
+double FramePacer::wait(double frameStart)
+{
+    double start = now();
+    updateCadence(start - frameStart - presentBlock_);
+    double target = interval_ * cadence_;
+
+    // a present held by vsync has used up most of the wait, the rest still keeps the frame
+    // from starting before it is due, for a cap below the refresh rate
+    double due = frameStart + target;
+    if (vsyncBound_)
+    {
+        stats_.vsyncFrames++;
+        // the presents set the grid then, the next frame is due a target after this one
+        nextDue_ = std::max(due, start) + target;
+    }
+    else if (mode_ == Mode::FixedCadence)
+    {
+        if (nextDue_ == 0)
+        {
+            nextDue_ = due;
+        }
+        due = nextDue_;
+        double late = start - due;
+        if (late > interval_ * 0.5)
+        {
+            // too late for this slot, wait for the next one of the grid rather than squeezing a short frame
+            due += std::ceil(late / interval_) * interval_;
+        }
+        nextDue_ = due + target;
+    }
+
+    double remaining = due - start;
+    if (remaining > spinTail_)
+    {
+        double request = remaining - spinTail_;
+        double sleepBegin = now();
+        sleep(request);
+        double slept = now() - sleepBegin;
+        stats_.sleepTime += slept;
+
+        // follow a late wake up at once, come back slowly when the sleeps are on time
+        double needed = slept - request + MinSpinTail;
+        if (needed > spinTail_)
+        {
+            spinTail_ = std::min(needed, MaxSpinTail);
+        }
+        else
+        {
+            spinTail_ = std::max(spinTail_ - (spinTail_ - needed) * 0.01, MinSpinTail);
+        }
+    }
+
+    double spinBegin = now();
+    double current = spinBegin;
+    while (current < due)
+    {
+        std::this_thread::yield();
+        current = now();
+    }
+    stats_.spinTime += current - spinBegin;
+
+    record(due, current);
+    return current;
+}
+
+void FramePacer::resetStats()
+{
+    stats_.frames = 0;
+    stats_.lateFrames = 0;
+    stats_.vsyncFrames = 0;
+    stats_.meanError = 0;
+    stats_.maxError = 0;
+    stats_.sleepTime = 0;
+    stats_.spinTime = 0;
+}
+
+double FramePacer::now() const
+{
+    return bx::getHPCounter() / frequency_;
+}
+
+void FramePacer::sleep(double seconds)
+{
+#if BX_PLATFORM_WINDOWS
+    if (timer_)
+    {
+        LARGE_INTEGER due;
+        // negative for a relative time, in 100 ns units
+        due.QuadPart = -static_cast<LONGLONG>(seconds * 1e7);
+        if (SetWaitableTimer(timer_, &due, 0, nullptr, nullptr, FALSE))
+        {
+            WaitForSingleObject(timer_, INFINITE);
+            return;
+        }
+    }
+    Sleep(static_cast<DWORD>(seconds * 1000));
+#else
+    timespec time;
+    time.tv_sec = static_cast<time_t>(seconds);
+    time.tv_nsec = static_cast<long>((seconds - time.tv_sec) * 1e9);
+    while (nanosleep(&time, &time) == -1 && errno == EINTR);
+#endif
+}
+
+void FramePacer::updateCadence(double workTime)
+{
+    averageWork_ = averageWork_ == 0 ? workTime : averageWork_ * 0.9 + workTime * 0.1;
+    if (mode_ != Mode::FixedCadence)
+    {
+        return;
+    }
+    if (averageWork_ > interval_ * cadence_ && cadence_ < MaxCadence)
+    {
+        cadence_++;
+        cadenceDownFrames_ = 0;
+    }
+    else if (cadence_ > 1 && averageWork_ < interval_ * (cadence_ - 1) * 0.8)
+    {
+        if (++cadenceDownFrames_ >= CadenceDownFrames)
+        {
+            cadence_--;
+            cadenceDownFrames_ = 0;
+        }
+    }
+    else
+    {
+        cadenceDownFrames_ = 0;
+    }
+}
+
+void FramePacer::record(double due, double start)
+{
+    double error = std::abs(start - due);
+    stats_.frames++;
+    if (start - due > LateThreshold)
+    {
+        stats_.lateFrames++;
+    }
+    stats_.meanError += (error - stats_.meanError) / stats_.frames;
+    stats_.maxError = std::max(stats_.maxError, error);
+}
+
+NS_CC_END
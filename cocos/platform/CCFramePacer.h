@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include "bx/platform.h"
+
+NS_CC_BEGIN
+
+/** @brief Waits for the next frame of the logic thread.
+ Sleeps with the finest timer of the platform until shortly before the frame
+ is due and spins for the rest, the length of the spin tail follows how late
+ the sleeps wake up. The time bgfx::frame blocks tells when presents are held
+ by vsync, the pacer then follows the presents and only waits for what is
+ left of the interval.
+ In FixedCadence mode frames are due on a fixed grid, when the frames can't
+ keep up with the interval the cadence steps to a multiple of it instead of
+ alternating short and long frames.
+ */
+
+class CC_DLL FramePacer
+{
+public:
+    enum class Mode
+    {
+        /** The next frame is due an interval after the current one started. */
+        Adaptive,
+        /** Frames are due on a grid of whole intervals. */
+        FixedCadence
+    };
+
+    struct Stats
+    {
+        uint32_t frames;       ///< frames paced since the last reset
+        uint32_t lateFrames;   ///< frames started more than half a millisecond after they were due
+        uint32_t vsyncFrames;  ///< frames whose present was held by vsync
+        double meanError;      ///< mean of |start - due| in seconds
+        double maxError;       ///< largest |start - due| in seconds
+        double sleepTime;      ///< seconds spent sleeping
+        double spinTime;       ///< seconds spent spinning
+    };
+
+    FramePacer();
+    ~FramePacer();
+
+    void setInterval(double interval);
+    inline double getInterval() const { return interval_; }
+
+    void setMode(Mode mode);
+    inline Mode getMode() const { return mode_; }
+
+    /** The multiple of the interval frames are paced at, only FixedCadence changes it. */
+    inline int getCadence() const { return cadence_; }
+
+    /** Called around bgfx::frame with the times it was entered and returned. */
+    void presented(double begin, double end);
+
+    /** Waits until the frame following the one that started at frameStart is due.
+     * @return the time the wait ended.
+     */
+    double wait(double frameStart);
+
+    inline const Stats& getStats() const { return stats_; }
+    void resetStats();
+private:
+    double now() const;
+    void sleep(double seconds);
+    void updateCadence(double workTime);
+    void record(double due, double start);
+private:
+    Mode mode_;
+    double interval_;
+    double frequency_;
+    int cadence_;
+    int cadenceDownFrames_;
+    double averageWork_;
+    double nextDue_;
+    double spinTail_;
+    double presentBlock_;
+    bool vsyncBound_;
+    Stats stats_;
+#if BX_PLATFORM_WINDOWS
+    void* timer_;
+#endif
+};
+
+NS_CC_END
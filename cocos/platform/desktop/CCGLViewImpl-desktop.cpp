@@ -51,42 +51,42 @@ public:
 
     static void onGLFWMouseCallBack(GLFWwindow* window, int button, int action, int modify)
     {
-        SharedApplication.postEventToLogic("Mouse"_slice, button, action, modify);
+        SharedApplication.postEventToLogic(AppEvent::Mouse{button, action, modify});
     }
 
     static void onGLFWMouseMoveCallBack(GLFWwindow* window, double x, double y)
     {
-        SharedApplication.postEventToLogic("MouseMove"_slice, reinterpret_cast<intptr_t>(window), x, y);
+        SharedApplication.postEventToLogic(AppEvent::MouseMove{reinterpret_cast<intptr_t>(window), x, y});
     }
 
     static void onGLFWMouseScrollCallback(GLFWwindow* window, double x, double y)
     {
-        SharedApplication.postEventToLogic("MouseScroll"_slice, reinterpret_cast<intptr_t>(window), x, y);
+        SharedApplication.postEventToLogic(AppEvent::MouseScroll{reinterpret_cast<intptr_t>(window), x, y});
     }
 
     static void onGLFWKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
     {
-        SharedApplication.postEventToLogic("Key"_slice, reinterpret_cast<intptr_t>(window), key, scancode, action, mods);
+        SharedApplication.postEventToLogic(AppEvent::Key{reinterpret_cast<intptr_t>(window), key, scancode, action, mods});
     }
 
     static void onGLFWCharCallback(GLFWwindow* window, uint32_t character)
     {
-        SharedApplication.postEventToLogic("Char"_slice, reinterpret_cast<intptr_t>(window), character);
+        SharedApplication.postEventToLogic(AppEvent::Char{reinterpret_cast<intptr_t>(window), character});
     }
 
     static void onGLFWWindowPosCallback(GLFWwindow* window, int x, int y)
     {
-        SharedApplication.postEventToLogic("WindowPos"_slice, reinterpret_cast<intptr_t>(window), x, y);
+        SharedApplication.postEventToLogic(AppEvent::WindowPos{reinterpret_cast<intptr_t>(window), x, y});
     }
 
     static void onGLFWframebuffersize(GLFWwindow* window, int w, int h)
     {
-        SharedApplication.postEventToLogic("FramebufferSize"_slice, reinterpret_cast<intptr_t>(window), w, h);
+        SharedApplication.postEventToLogic(AppEvent::FramebufferSize{reinterpret_cast<intptr_t>(window), w, h});
     }
 
     static void onGLFWWindowSizeFunCallback(GLFWwindow *window, int width, int height)
     {
-        SharedApplication.postEventToLogic("WindowSize"_slice, reinterpret_cast<intptr_t>(window), width, height);
+        SharedApplication.postEventToLogic(AppEvent::WindowSize{reinterpret_cast<intptr_t>(window), width, height});
     }
 
     static void setGLViewImpl(GLViewImpl* view)
@@ -96,7 +96,7 @@ public:
 
     static void onGLFWWindowIconifyCallback(GLFWwindow* window, int iconified)
     {
-        SharedApplication.postEventToLogic("Iconify"_slice, reinterpret_cast<intptr_t>(window), iconified);
+        SharedApplication.postEventToLogic(AppEvent::Iconify{reinterpret_cast<intptr_t>(window), iconified});
     }
 
 private:
@@ -381,7 +381,7 @@ static    void* m_device = NULL;
         ev.ys[i] = [touch locationInView: [touch view]].y * self.contentScaleFactor;;
         ++i;
     }
-    SharedApplication.postEventToLogic("TouchesBegin"_slice, i, ev);
+    SharedApplication.postEventToLogic(cocos2d::AppEvent::TouchesBegin{i, ev});
 }
 
 - (void)touchesMoved:(NSSet *)touches withEvent:(UIEvent *)event
@@ -402,7 +402,7 @@ static    void* m_device = NULL;
 #endif
         ++i;
     }
-    SharedApplication.postEventToLogic("TouchesMove"_slice, i, ev);
+    SharedApplication.postEventToLogic(cocos2d::AppEvent::TouchesMove{i, ev});
 }
 
 - (void)touchesEnded:(NSSet *)touches withEvent:(UIEvent *)event
@@ -416,7 +416,7 @@ static    void* m_device = NULL;
         ev.ys[i] = [touch locationInView: [touch view]].y * self.contentScaleFactor;;
         ++i;
     }
-    SharedApplication.postEventToLogic("TouchesEnd"_slice, i, ev);
+    SharedApplication.postEventToLogic(cocos2d::AppEvent::TouchesEnd{i, ev});
 }
 
 - (void)touchesCancelled:(NSSet *)touches withEvent:(UIEvent *)event
@@ -430,7 +430,7 @@ static    void* m_device = NULL;
         ev.ys[i] = [touch locationInView: [touch view]].y * self.contentScaleFactor;;
         ++i;
     }
-    SharedApplication.postEventToLogic("TouchesCancel"_slice, i, ev);
+    SharedApplication.postEventToLogic(cocos2d::AppEvent::TouchesCancel{i, ev});
 }
 
 #pragma mark - UIView - Responder
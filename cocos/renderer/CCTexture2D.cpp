@@ -453,6 +453,41 @@ bool Texture2D::initWithString(const std::string& text, const FontDefinition& te
 #endif
 
     bool ret = false;
+    bgfx::TextureFormat::Enum pixelFormat = g_defaultAlphaPixelFormat;
+    unsigned char* outTempData = nullptr;
+    ssize_t outTempDataLen = 0;
+
+    int imageWidth;
+    int imageHeight;
+    bool hasPremultipliedAlpha;
+    Data outData = getStringData(text, textDefinition, imageWidth, imageHeight, hasPremultipliedAlpha);
+    if(outData.isNull())
+    {
+        return false;
+    }
+
+    Size  imageSize = Size((float)imageWidth, (float)imageHeight);
+    //pixelFormat = convertDataToFormat(outData.getBytes(), imageWidth*imageHeight*4, PixelFormat::RGBA8888, pixelFormat, &outTempData, &outTempDataLen);
+    outTempData = outData.getBytes();
+    outTempDataLen = imageWidth * imageHeight * 4;
+    ret = initWithDataCopy(outTempData, outTempDataLen, pixelFormat, imageWidth, imageHeight, imageSize);
+
+    //if (outTempData != nullptr && outTempData != outData.getBytes())
+    //{
+    //    free(outTempData);
+    //}
+    _hasPremultipliedAlpha = hasPremultipliedAlpha;
+
+    return ret;
+}
+
+Data Texture2D::getStringData(const std::string& text, const FontDefinition& textDefinition, int& width, int& height, bool& hasPremultipliedAlpha)
+{
+    if(text.empty())
+    {
+        return Data();
+    }
+
     Device::TextAlign align;
 
     if (TextVAlignment::TOP == textDefinition._vertAlignment)
@@ -473,19 +508,13 @@ bool Texture2D::initWithString(const std::string& text, const FontDefinition& te
     else
     {
         CCASSERT(false, "Not supported alignment format!");
-        return false;
+        return Data();
     }
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
     CCASSERT(textDefinition._stroke._strokeEnabled == false, "Currently stroke doesn't support win32!");
 #endif
 
-    bgfx::TextureFormat::Enum pixelFormat = g_defaultAlphaPixelFormat;
-    unsigned char* outTempData = nullptr;
-    ssize_t outTempDataLen = 0;
-
-    int imageWidth;
-    int imageHeight;
     auto textDef = textDefinition;
     auto contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
     textDef._fontSize *= contentScaleFactor;
@@ -494,26 +523,7 @@ bool Texture2D::initWithString(const std::string& text, const FontDefinition& te
     textDef._stroke._strokeSize *= contentScaleFactor;
     textDef._shadow._shadowEnabled = false;
 
-    bool hasPremultipliedAlpha;
-    Data outData = Device::getTextureDataForText(text.c_str(), textDef, align, imageWidth, imageHeight, hasPremultipliedAlpha);
-    if(outData.isNull())
-    {
-        return false;
-    }
-
-    Size  imageSize = Size((float)imageWidth, (float)imageHeight);
-    //pixelFormat = convertDataToFormat(outData.getBytes(), imageWidth*imageHeight*4, PixelFormat::RGBA8888, pixelFormat, &outTempData, &outTempDataLen);
-    outTempData = outData.getBytes();
-    outTempDataLen = imageWidth * imageHeight * 4;
-    ret = initWithDataCopy(outTempData, outTempDataLen, pixelFormat, imageWidth, imageHeight, imageSize);
-
-    //if (outTempData != nullptr && outTempData != outData.getBytes())
-    //{
-    //    free(outTempData);
-    //}
-    _hasPremultipliedAlpha = hasPremultipliedAlpha;
-
-    return ret;
+    return Device::getTextureDataForText(text.c_str(), textDef, align, width, height, hasPremultipliedAlpha);
 }
 
 
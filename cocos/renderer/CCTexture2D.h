@@ -28,6 +28,7 @@ THE SOFTWARE.
 #define __CCTEXTURE2D_H__
 
 #include "base/ccTypes.h"
+#include "base/CCData.h"
 #include "bx/allocator.h"
 #include <unordered_map>
 
@@ -301,6 +302,11 @@ public:
      */
     bool initWithString(const std::string& text, const FontDefinition& textDefinition);
 
+    /** Renders a string with the platform text renderer into RGBA8888 pixels of width x height,
+     the pixels of initWithString. Returns null data for an empty string.
+     */
+    static Data getStringData(const std::string& text, const FontDefinition& textDefinition, int& width, int& height, bool& hasPremultipliedAlpha);
+
     /** Sets the min filter, mag filter, wrap s and wrap t texture parameters.
     If the texture size is NPOT (non power of 2), then in can only use GL_CLAMP_TO_EDGE in GL_TEXTURE_WRAP_{S,T}.
 
@@ -501,6 +507,7 @@ protected:
     NinePatchInfo* _ninePatchInfo;
     friend class SpriteFrameCache;
     friend class TextureCache;
+    friend class StringAtlas;
     friend class ui::Scale9Sprite;
     bool _valid;
     std::string _filePath;
@@ -526,6 +526,22 @@ void TextureAtlas::drawNumberOfQuads(ssize_t numberOfQuads, ssize_t start, Sprit
 
 }
 
+void TextureAtlas::batchQuads(SpriteProgram* p, const uint64_t state, const Mat4& modelWorld, const Color4F& color)
+{
+    this->batchNumberOfQuads(_totalQuads, 0, p, state, modelWorld, color);
+}
+
+void TextureAtlas::batchNumberOfQuads(ssize_t numberOfQuads, ssize_t start, SpriteProgram* p, const uint64_t state, const Mat4& modelWorld, const Color4F& color)
+{
+    CCASSERT(numberOfQuads>=0 && start>=0 && start+numberOfQuads<=_totalQuads, "numberOfQuads and start out of range");
+
+    if(!numberOfQuads)
+        return;
+
+    SharedRendererManager.setCurrent(SharedRenderer.getTarget());
+    SharedRenderer.push(_quads + start, uint32_t(numberOfQuads), p, _texture, state, _texture->getFlags(), modelWorld, color);
+}
+
 
 NS_CC_END
 
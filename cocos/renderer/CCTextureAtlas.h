@@ -200,6 +200,16 @@ public:
     /** Draws all the Atlas's Quads.
     */
     void drawQuads(SpriteProgram* p = nullptr, const uint64_t state = 0, const Mat4* modelWorld = nullptr);
+
+    /** Draws n quads from an index transformed by modelWorld, their colors multiplied by color.
+    The quads are transformed on the CPU, so unlike drawNumberOfQuads they batch with
+    everything drawn before using the same program, texture and state.
+    */
+    void batchNumberOfQuads(ssize_t numberOfQuads, ssize_t start, SpriteProgram* p, const uint64_t state, const Mat4& modelWorld, const Color4F& color);
+
+    /** Batches all the Atlas's Quads, see batchNumberOfQuads.
+    */
+    void batchQuads(SpriteProgram* p, const uint64_t state, const Mat4& modelWorld, const Color4F& color);
     /** Listen the event that renderer was recreated on Android.
      */
     void listenRendererRecreated(EventCustom* event);
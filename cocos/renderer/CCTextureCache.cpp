@@ -34,7 +34,7 @@ THE SOFTWARE.
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
-#include "base/Async.h"
+#include "base/JobSystem.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 #include "base/CCNinePatchImageParser.h"
@@ -113,10 +113,11 @@ void TextureCache::addImageAsync(String filename, const std::function<void(Textu
     std::string file(filename);
     FileUtils::getInstance()->loadFileAsyncUnsafe(fullpath, [this, file, callback](uint8_t* data, ssize_t size)
     {
-        SharedAsyncThread.Loader.run([this, data, size]()
+        SharedJobSystem.run([this, data, size]()
         {
             bimg::ImageContainer* imageContainer = bimg::imageParse(&allocator_, data, static_cast<uint32_t>(size));
             free(data);
+            JobSystem::setUploadBytes(imageContainer ? imageContainer->m_size : 0);
             return TValues::create(imageContainer);
         }, [this, file, callback](TValues* result) 
         {
@@ -184,10 +185,11 @@ void TextureCache::addImageAsyncOnTexture(String filename, Texture2D* texInput,
     std::string file(filename);
     FileUtils::getInstance()->loadFileAsyncUnsafe(fullpath, [this, file, texInput, callback](uint8_t* data, ssize_t size)
     {
-        SharedAsyncThread.Loader.run([this, data, size]()
+        SharedJobSystem.run([this, data, size]()
         {
             bimg::ImageContainer* imageContainer = bimg::imageParse(&allocator_, data, static_cast<uint32_t>(size));
             free(data);
+            JobSystem::setUploadBytes(imageContainer ? imageContainer->m_size : 0);
             return TValues::create(imageContainer);
         }, [this, file, texInput, callback](TValues* result)
         {
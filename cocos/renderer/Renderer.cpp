@@ -9,6 +9,12 @@
 
 NS_CC_BEGIN
 
+namespace
+{
+    // the batch is drawn with 16 bit indices
+    const size_t MaxBatchVertices = 65536;
+    const uint32_t MaxBatchQuads = MaxBatchVertices / 4;
+}
 
 void IRenderer::render()
 {
@@ -29,8 +35,11 @@ Renderer::Renderer()
     , outlineProgram_(SpriteProgram::create("vs_label.bin"_slice, "fs_labeloutline.bin"_slice))
     , gradientProgram_(SpriteProgram::create("vs_labelposition.bin"_slice, "fs_labelgradient.bin"_slice))
     , gradientOutlineProgram_(SpriteProgram::create("vs_labelposition.bin"_slice, "fs_labelgradientoutline.bin"_slice))
-    //, distanceFieldProgram_(SpriteProgram::create("vs_labelposition.bin"_slice, "fs_labeldf.bin"_slice))
-    //, distanceFieldGlowProgram_(SpriteProgram::create("vs_labelposition.bin"_slice, "fs_labeldfglow.bin"_slice))
+    , distanceFieldProgram_(SpriteProgram::create("vs_label.bin"_slice, "fs_labeldf.bin"_slice))
+    , distanceFieldGlowProgram_(SpriteProgram::create("vs_label.bin"_slice, "fs_labeldfglow.bin"_slice))
+    , distanceFieldOutlineProgram_(SpriteProgram::create("vs_label.bin"_slice, "fs_labeldfoutline.bin"_slice))
+    , labelBatchProgram_(SpriteProgram::create("vs_spritemodel.bin"_slice, "fs_labelbatch.bin"_slice))
+    , labelEffectProgram_(SpriteProgram::create("vs_spritemodel.bin"_slice, "fs_labeleffect.bin"_slice))
     , lastProgram_(nullptr)
     , lastTexture_(nullptr)
     , lastState_(0)
@@ -94,12 +103,28 @@ SpriteProgram* Renderer::getDistanceFieldGlowProgram() const
     return distanceFieldGlowProgram_;
 }
 
+SpriteProgram* Renderer::getDistanceFieldOutlineProgram() const
+{
+    return distanceFieldOutlineProgram_;
+}
+
+SpriteProgram* Renderer::getLabelBatchProgram() const
+{
+    return labelBatchProgram_;
+}
+
+SpriteProgram* Renderer::getLabelEffectProgram() const
+{
+    return labelEffectProgram_;
+}
+
 void Renderer::push(V3F_C4B_T2F* verts, uint32_t vsize,
     uint16_t* indices, uint32_t isize,
     SpriteProgram* program, Texture2D* texture, 
     uint64_t state, uint32_t flags)
 {
-    if (program != lastProgram_ || texture != lastTexture_ || state != lastState_ || flags != lastFlags_)
+    if (program != lastProgram_ || texture != lastTexture_ || state != lastState_ || flags != lastFlags_
+        || vertices_.size() + vsize > MaxBatchVertices)
     {
         render();
     }
@@ -127,7 +152,8 @@ void Renderer::push(V3F_C4B_T2F* verts, uint32_t vsize,
     SpriteProgram* program, Texture2D* texture,
     uint64_t state, uint32_t flags, const float* modelWorld)
 {
-    if (modelWorld || program != lastProgram_ || texture != lastTexture_ || state != lastState_ || flags != lastFlags_)
+    if (modelWorld || program != lastProgram_ || texture != lastTexture_ || state != lastState_ || flags != lastFlags_
+        || vertices_.size() + vsize > MaxBatchVertices)
     {
         render();
     }
@@ -159,7 +185,8 @@ void Renderer::push(V3F_C4B_T2F* verts, uint32_t vsize,
     SpriteProgram* program, Texture2D* texture, 
     uint64_t state, uint32_t flags, const Mat4& modelWorld)
 {
-    if (program != lastProgram_ || texture != lastTexture_ || state != lastState_ || flags != lastFlags_)
+    if (program != lastProgram_ || texture != lastTexture_ || state != lastState_ || flags != lastFlags_
+        || vertices_.size() + vsize > MaxBatchVertices)
     {
         render();
     }
@@ -190,7 +217,16 @@ void Renderer::push(V3F_C4B_T2F_Quad* quads, uint32_t quadsCount,
     SpriteProgram* program, Texture2D* texture, 
     uint64_t state, uint32_t flags, const Mat4& modelWorld)
 {
-    if (program != lastProgram_ || texture != lastTexture_ || state != lastState_ || flags != lastFlags_)
+    if (quadsCount > MaxBatchQuads)
+    {
+        for (uint32_t first = 0; first < quadsCount; first += MaxBatchQuads)
+        {
+            push(quads + first, std::min(quadsCount - first, MaxBatchQuads), program, texture, state, flags, modelWorld);
+        }
+        return;
+    }
+    if (program != lastProgram_ || texture != lastTexture_ || state != lastState_ || flags != lastFlags_
+        || vertices_.size() + quadsCount * 4 > MaxBatchVertices)
     {
         render();
     }
@@ -227,8 +263,35 @@ void Renderer::push(V3F_C4B_T2F_Quad* quads, uint32_t quadsCount,
     }
 }
 
+void Renderer::push(V3F_C4B_T2F_Quad* quads, uint32_t quadsCount,
+    SpriteProgram* program, Texture2D* texture,
+    uint64_t state, uint32_t flags, const Mat4& modelWorld, const Color4F& color)
+{
+    if (color == Color4F::WHITE)
+    {
+        push(quads, quadsCount, program, texture, state, flags, modelWorld);
+        return;
+    }
+    // tinted a batch at a time, before the next one may render it
+    for (uint32_t first = 0; first < quadsCount; first += MaxBatchQuads)
+    {
+        uint32_t count = std::min(quadsCount - first, MaxBatchQuads);
+        push(quads + first, count, program, texture, state, flags, modelWorld);
+        // render() may have run in push, the quads are the last vertices either way
+        for (size_t i = vertices_.size() - count * 4; i < vertices_.size(); ++i)
+        {
+            Color4B& c = vertices_[i].colors;
+            c.r = static_cast<GLubyte>(c.r * color.r);
+            c.g = static_cast<GLubyte>(c.g * color.g);
+            c.b = static_cast<GLubyte>(c.b * color.b);
+            c.a = static_cast<GLubyte>(c.a * color.a);
+        }
+    }
+}
+
 void Renderer::render()
 {
+    CC_TRACE_SCOPE("Renderer::render");
     if (!vertices_.empty())
     {
         bgfx::TransientVertexBuffer vertexBuffer;
@@ -298,6 +361,7 @@ void DrawRenderer::push(std::vector<DrawVertex>& verts, std::vector<uint16_t>& i
 
 void DrawRenderer::render()
 {
+    CC_TRACE_SCOPE("DrawRenderer::render");
     if (!vertices_.empty())
     {
         bgfx::TransientVertexBuffer vertexBuffer;
@@ -375,6 +439,7 @@ void LineRenderer::push(VecVertex* verts, uint32_t vsize, uint16_t* indices, uin
 
 void LineRenderer::render()
 {
+    CC_TRACE_SCOPE("LineRenderer::render");
     if (!vertices_.empty())
     {
         bgfx::TransientVertexBuffer vertexBuffer;
@@ -431,6 +496,7 @@ uint32_t RendererManager::getCurrentStencilState() const
 
 void RendererManager::flush()
 {
+    CC_TRACE_SCOPE("RendererManager::flush");
     if (currentRenderer_)
     {
         currentRenderer_->render();
@@ -30,11 +30,18 @@ public:
     PROPERTY_READONLY(SpriteProgram*, GradientOutlineProgram);
     PROPERTY_READONLY(SpriteProgram*, DistanceField);
     PROPERTY_READONLY(SpriteProgram*, DistanceFieldGlowProgram);
+    PROPERTY_READONLY(SpriteProgram*, DistanceFieldOutlineProgram);
+    /** A8 text with world space vertices and the text color in the vertex colors. */
+    PROPERTY_READONLY(SpriteProgram*, LabelBatchProgram);
+    /** Outlined text, its outline and its shadow as layers of one batch, colors in the vertices. */
+    PROPERTY_READONLY(SpriteProgram*, LabelEffectProgram);
     void render() override;
     void push(V3F_C4B_T2F* verts, uint32_t vsize, uint16_t* indices, uint32_t isize, SpriteProgram* program, Texture2D* texture, uint64_t state, uint32_t flags);
     void push(V3F_C4B_T2F* verts, uint32_t vsize, uint16_t* indices, uint32_t isize, SpriteProgram* program, Texture2D* texture, uint64_t state, uint32_t flags, const float* modelWorld);
     void push(V3F_C4B_T2F* verts, uint32_t vsize, uint16_t* indices, uint32_t isize, SpriteProgram* program, Texture2D* texture, uint64_t state, uint32_t flags, const Mat4& modelWorld);
     void push(V3F_C4B_T2F_Quad* quads, uint32_t quadsCount, SpriteProgram* program, Texture2D* texture, uint64_t state, uint32_t flags, const Mat4& modelWorld);
+    /** Multiplies the vertex colors by color. */
+    void push(V3F_C4B_T2F_Quad* quads, uint32_t quadsCount, SpriteProgram* program, Texture2D* texture, uint64_t state, uint32_t flags, const Mat4& modelWorld, const Color4F& color);
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size) { return true; }
 protected:
@@ -51,6 +58,9 @@ private:
     SmartPtr<SpriteProgram> gradientOutlineProgram_;
     SmartPtr<SpriteProgram> distanceFieldProgram_;
     SmartPtr<SpriteProgram> distanceFieldGlowProgram_;
+    SmartPtr<SpriteProgram> distanceFieldOutlineProgram_;
+    SmartPtr<SpriteProgram> labelBatchProgram_;
+    SmartPtr<SpriteProgram> labelEffectProgram_;
 
     std::vector<V3F_C4B_T2F> vertices_;
     std::vector<uint16_t> indices_;
@@ -130,4 +130,13 @@ void localStorageClear()
     JniHelper::callStaticVoidMethod(className, "clear");
 }
 
+/** write-behind is handled by the Java side, nothing to buffer here */
+void localStorageSetFlushInterval( float interval )
+{
+}
+
+void localStorageFlush()
+{
+}
+
 #endif // #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
@@ -35,6 +35,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
 #include <sqlite3/sqlite3.h>
 #else
@@ -48,6 +55,24 @@ static sqlite3_stmt *_stmt_remove;
 static sqlite3_stmt *_stmt_update;
 static sqlite3_stmt *_stmt_clear;
 
+// write-behind state
+// _dbMutex guards the connection and statements, _pendingMutex guards the overlay.
+// The flusher always locks _dbMutex before _pendingMutex, readers never hold both.
+struct PendingItem
+{
+    std::string value;
+    bool removed;
+};
+static std::mutex _dbMutex;
+static std::mutex _pendingMutex;
+static std::condition_variable _flushCondition;
+static std::unordered_map<std::string, PendingItem> _pendingItems;
+static bool _pendingClear = false;
+static bool _flushThreadStop = false;
+// read by the flush thread while the API thread may set it
+static std::atomic<float> _flushInterval(0.0f);
+static std::thread _flushThread;
+
 
 static void localStorageCreateTable()
 {
@@ -61,6 +86,107 @@ static void localStorageCreateTable()
         printf("Error in CREATE TABLE\n");
 }
 
+static void localStorageWriteItem( const std::string& key, const std::string& value)
+{
+    int ok = sqlite3_bind_text(_stmt_update, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    ok |= sqlite3_bind_text(_stmt_update, 2, value.c_str(), -1, SQLITE_TRANSIENT);
+
+    ok |= sqlite3_step(_stmt_update);
+
+    ok |= sqlite3_reset(_stmt_update);
+
+    if( ok != SQLITE_OK && ok != SQLITE_DONE)
+        printf("Error in localStorage.setItem()\n");
+}
+
+static void localStorageDeleteItem( const std::string& key )
+{
+    int ok = sqlite3_bind_text(_stmt_remove, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+
+    ok |= sqlite3_step(_stmt_remove);
+
+    ok |= sqlite3_reset(_stmt_remove);
+
+    if( ok != SQLITE_OK && ok != SQLITE_DONE)
+        printf("Error in localStorage.removeItem()\n");
+}
+
+static void localStorageDeleteAll()
+{
+    int ok = sqlite3_step(_stmt_clear);
+
+    ok |= sqlite3_reset(_stmt_clear);
+
+    if( ok != SQLITE_OK && ok != SQLITE_DONE)
+        printf("Error in localStorage.clear()\n");
+}
+
+/** writes the overlay to the database in one transaction */
+static void localStorageFlushPending()
+{
+    std::lock_guard<std::mutex> dbLock(_dbMutex);
+
+    std::unordered_map<std::string, PendingItem> items;
+    bool clear = false;
+    {
+        std::lock_guard<std::mutex> pendingLock(_pendingMutex);
+        items.swap(_pendingItems);
+        clear = _pendingClear;
+        _pendingClear = false;
+    }
+    if (items.empty() && !clear)
+        return;
+
+    if (sqlite3_exec(_db, "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        printf("Error in localStorage flush BEGIN\n");
+
+    if (clear)
+        localStorageDeleteAll();
+    for (const auto& item : items)
+    {
+        if (item.second.removed)
+            localStorageDeleteItem(item.first);
+        else
+            localStorageWriteItem(item.first, item.second.value);
+    }
+
+    if (sqlite3_exec(_db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        printf("Error in localStorage flush COMMIT\n");
+}
+
+static void localStorageFlushLoop()
+{
+    std::unique_lock<std::mutex> lock(_pendingMutex);
+    while (!_flushThreadStop)
+    {
+        // at least 1 ms, a shorter interval would wait for nothing and spin
+        auto interval = std::chrono::milliseconds(std::max(1LL, (long long)(_flushInterval.load() * 1000.0f)));
+        _flushCondition.wait_for(lock, interval, []() { return _flushThreadStop; });
+        lock.unlock();
+        localStorageFlushPending();
+        lock.lock();
+    }
+}
+
+static void localStorageStopFlushThread()
+{
+    if (_flushThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(_pendingMutex);
+            _flushThreadStop = true;
+        }
+        _flushCondition.notify_one();
+        _flushThread.join();
+    }
+    localStorageFlushPending();
+}
+
+static bool localStorageWriteBehind()
+{
+    return _flushInterval.load() > 0.0f;
+}
+
 void localStorageInit( const std::string& fullpath/* = "" */)
 {
     if (!_initialized) {
@@ -72,6 +198,13 @@ void localStorageInit( const std::string& fullpath/* = "" */)
         else
             ret = sqlite3_open(fullpath.c_str(), &_db);
 
+        // WAL turns each commit into an append, NORMAL only syncs on checkpoint.
+        if (!fullpath.empty())
+        {
+            sqlite3_exec(_db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+            sqlite3_exec(_db, "PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+        }
+
         localStorageCreateTable();
 
         // SELECT
@@ -96,15 +229,24 @@ void localStorageInit( const std::string& fullpath/* = "" */)
         }
 		
         _initialized = 1;
+
+        if (localStorageWriteBehind())
+        {
+            _flushThreadStop = false;
+            _flushThread = std::thread(localStorageFlushLoop);
+        }
     }
 }
 
 void localStorageFree()
 {
     if (_initialized) {
+        localStorageStopFlushThread();
+
         sqlite3_finalize(_stmt_select);
         sqlite3_finalize(_stmt_remove);
         sqlite3_finalize(_stmt_update);
+        sqlite3_finalize(_stmt_clear);
 
         sqlite3_close(_db);
 		
@@ -112,20 +254,44 @@ void localStorageFree()
     }
 }
 
+void localStorageSetFlushInterval( float interval )
+{
+    if (_initialized)
+        localStorageStopFlushThread();
+
+    _flushInterval.store(interval);
+
+    if (_initialized && localStorageWriteBehind())
+    {
+        _flushThreadStop = false;
+        _flushThread = std::thread(localStorageFlushLoop);
+    }
+}
+
+void localStorageFlush()
+{
+    assert( _initialized );
+
+    // written on the calling thread, a flush the thread is running holds _dbMutex until it commits
+    localStorageFlushPending();
+}
+
 /** sets an item in the LS */
 void localStorageSetItem( const std::string& key, const std::string& value)
 {
     assert( _initialized );
-	
-    int ok = sqlite3_bind_text(_stmt_update, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-    ok |= sqlite3_bind_text(_stmt_update, 2, value.c_str(), -1, SQLITE_TRANSIENT);
 
-    ok |= sqlite3_step(_stmt_update);
-
-    ok |= sqlite3_reset(_stmt_update);
+    if (localStorageWriteBehind())
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        PendingItem& item = _pendingItems[key];
+        item.value = value;
+        item.removed = false;
+        return;
+    }
 
-    if( ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.setItem()\n");
+    std::lock_guard<std::mutex> lock(_dbMutex);
+    localStorageWriteItem(key, value);
 }
 
 /** gets an item from the LS */
@@ -133,6 +299,23 @@ bool localStorageGetItem( const std::string& key, std::string *outItem )
 {
     assert( _initialized );
 
+    if (localStorageWriteBehind())
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        auto it = _pendingItems.find(key);
+        if (it != _pendingItems.end())
+        {
+            if (it->second.removed)
+                return false;
+            outItem->assign(it->second.value);
+            return true;
+        }
+        if (_pendingClear)
+            return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_dbMutex);
+
     int ok = sqlite3_reset(_stmt_select);
 
     ok |= sqlite3_bind_text(_stmt_select, 1, key.c_str(), -1, SQLITE_TRANSIENT);
@@ -160,27 +343,34 @@ void localStorageRemoveItem( const std::string& key )
 {
     assert( _initialized );
 
-    int ok = sqlite3_bind_text(_stmt_remove, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-
-    ok |= sqlite3_step(_stmt_remove);
-
-    ok |= sqlite3_reset(_stmt_remove);
+    if (localStorageWriteBehind())
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        PendingItem& item = _pendingItems[key];
+        item.value.clear();
+        item.removed = true;
+        return;
+    }
 
-    if( ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.removeItem()\n");
+    std::lock_guard<std::mutex> lock(_dbMutex);
+    localStorageDeleteItem(key);
 }
 
 /** removes all items from the LS */
 void localStorageClear()
 {
     assert( _initialized );
-    
-    int ok = sqlite3_step(_stmt_clear);
 
-    ok |= sqlite3_reset(_stmt_clear);
+    if (localStorageWriteBehind())
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _pendingItems.clear();
+        _pendingClear = true;
+        return;
+    }
 
-    if( ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.clear()\n");
+    std::lock_guard<std::mutex> lock(_dbMutex);
+    localStorageDeleteAll();
 }
 
 #endif // #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
@@ -54,6 +54,15 @@ void CC_DLL localStorageRemoveItem( const std::string& key );
 /** Removes all items from the JS. */
 void CC_DLL localStorageClear();
 
+/** Sets the write-behind flush interval in seconds.
+ If interval is greater than zero, setItem/removeItem/clear are buffered in memory
+ and written to the database in a single transaction by a background thread.
+ If interval is zero or less, every call is written to the database immediately (default). */
+void CC_DLL localStorageSetFlushInterval( float interval );
+
+/** Writes all buffered items to the database now, returns once they are committed. */
+void CC_DLL localStorageFlush();
+
 // end group
 /// @}
 
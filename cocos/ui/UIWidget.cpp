@@ -50,6 +50,7 @@ _highlight(false),
 _affectByClipping(false),
 _ignoreSize(false),
 _propagateTouchEvents(true),
+_hitTestGridEnabled(false),
 _brightStyle(BrightStyle::NONE),
 _sizeType(SizeType::ABSOLUTE),
 _positionType(PositionType::ABSOLUTE),
@@ -427,6 +428,7 @@ void Widget::setTouchEnabled(bool enable)
         _touchListener = EventListenerTouchOneByOne::create();
         CC_SAFE_RETAIN(_touchListener);
         _touchListener->setSwallowTouches(true);
+        _touchListener->setHitTestEnabled(_hitTestGridEnabled);
         _touchListener->onTouchBegan = CC_CALLBACK_2(Widget::onTouchBegan, this);
         _touchListener->onTouchMoved = CC_CALLBACK_2(Widget::onTouchMoved, this);
         _touchListener->onTouchEnded = CC_CALLBACK_2(Widget::onTouchEnded, this);
@@ -611,6 +613,31 @@ bool Widget::isSwallowTouches()const
     return false;
 }
 
+void Widget::setHitTestGridEnabled(bool enabled)
+{
+    if (enabled == _hitTestGridEnabled)
+    {
+        return;
+    }
+    _hitTestGridEnabled = enabled;
+    // the dispatcher reads it when the listener is added, so a registered one is replaced
+    if (_touchListener)
+    {
+        auto listener = _touchListener->clone();
+        listener->setHitTestEnabled(enabled);
+        _eventDispatcher->removeEventListener(_touchListener);
+        CC_SAFE_RELEASE(_touchListener);
+        _touchListener = listener;
+        CC_SAFE_RETAIN(_touchListener);
+        _eventDispatcher->addEventListenerWithSceneGraphPriority(_touchListener, this);
+    }
+}
+
+bool Widget::isHitTestGridEnabled()const
+{
+    return _hitTestGridEnabled;
+}
+
 bool Widget::onTouchBegan(Touch *touch, Event *unusedEvent)
 {
     _hitted = false;
@@ -1015,6 +1042,7 @@ void Widget::copyProperties(Widget *widget)
     _focused = widget->_focused;
     _focusEnabled = widget->_focusEnabled;
     _propagateTouchEvents = widget->_propagateTouchEvents;
+    setHitTestGridEnabled(widget->_hitTestGridEnabled);
 
     copySpecialProperties(widget);
 }
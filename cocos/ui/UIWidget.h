@@ -459,6 +459,8 @@ public:
     /**
      * Checks a point is in widget's content space.
      * This function is used for determining touch area of widget.
+     * Touches outside the widget's bounding box are dropped before it is called
+     * when the hit test grid is enabled, see setHitTestGridEnabled.
      *
      * @param pt        The point in `Vec2`.
      * @return true if the point is in widget's content space, false otherwise.
@@ -609,6 +611,21 @@ public:
      */
     bool isSwallowTouches()const;
 
+    /**
+     * Lets the event dispatcher drop touches outside the widget's bounding box
+     * without calling onTouchBegan, see EventListenerTouchOneByOne::setHitTestEnabled.
+     * Only enable it when hitTest doesn't claim points outside the content rect.
+     * The default value is false.
+     * @param enabled True to skip the widget for touches outside its bounds.
+     */
+    void setHitTestGridEnabled(bool enabled);
+
+    /**
+     * Return whether touches outside the widget's bounds are dropped before onTouchBegan.
+     * @return Whether the hit test grid is enabled.
+     */
+    bool isHitTestGridEnabled()const;
+
     /**
      * Query whether widget is focused or not.
      *@return  whether the widget is focused or not
@@ -790,6 +807,7 @@ protected:
     bool _affectByClipping;
     bool _ignoreSize;
     bool _propagateTouchEvents;
+    bool _hitTestGridEnabled;
 
     BrightStyle _brightStyle;
     SizeType _sizeType;
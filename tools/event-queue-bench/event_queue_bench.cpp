@@ -0,0 +1,174 @@
+// Times TypedEventQueue against the named events of EventQueue::post, the
+// bx::SpScUnboundedQueueT path the Application queues used before.
+// See README.md for building it.
+
+#include "ccHeader.h"
+#include "base/EventQueue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+USING_NS_CC;
+
+namespace
+{
+    // the size of the input messages Application posts, see AppEvent::MouseMove
+    struct MoveMessage
+    {
+        static constexpr std::size_t Id = "Move"_hash;
+        intptr_t window;
+        double x, y;
+    };
+
+    const int BurstSize = 128;
+    const int Bursts = 20000;
+
+    double now()
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // both paths dispatch the same way the Application pumps do, the sum keeps the work from being dropped
+    struct Sink
+    {
+        double sum = 0;
+        int count = 0;
+    };
+
+    void pollNamed(EventQueue& queue, Sink& sink)
+    {
+        for (Own<QEvent> event = queue.poll(); event != nullptr; event = queue.poll())
+        {
+            switch (Switch::hash(event->getName()))
+            {
+                case "Move"_hash:
+                {
+                    intptr_t window;
+                    double x, y;
+                    event->get(window, x, y);
+                    sink.sum += x + y + window;
+                    sink.count++;
+                    break;
+                }
+            }
+        }
+    }
+
+    template <typename Queue>
+    void pollTyped(Queue& queue, Sink& sink)
+    {
+        queue.poll([&sink](const TEvent& event)
+        {
+            switch (event.getId())
+            {
+                case MoveMessage::Id:
+                {
+                    const MoveMessage& move = event.get<MoveMessage>();
+                    sink.sum += move.x + move.y + move.window;
+                    sink.count++;
+                    break;
+                }
+            }
+        });
+    }
+
+    // bursts posted and polled on one thread, the cost per message without contention
+    void benchBursts()
+    {
+        Sink namedSink, typedSink;
+        EventQueue named;
+        double begin = now();
+        for (int burst = 0; burst < Bursts; ++burst)
+        {
+            for (int i = 0; i < BurstSize; ++i)
+            {
+                named.post("Move"_slice, intptr_t(1), double(i), double(burst));
+            }
+            pollNamed(named, namedSink);
+        }
+        double namedTime = now() - begin;
+
+        TypedEventQueue<> typed;
+        begin = now();
+        for (int burst = 0; burst < Bursts; ++burst)
+        {
+            for (int i = 0; i < BurstSize; ++i)
+            {
+                typed.post(MoveMessage{1, double(i), double(burst)});
+            }
+            pollTyped(typed, typedSink);
+        }
+        double typedTime = now() - begin;
+
+        printf("bursts of %d on one thread: EventQueue %.1f ns/msg, TypedEventQueue %.1f ns/msg, %d pooled blocks\n",
+            BurstSize, namedTime / namedSink.count, typedTime / typedSink.count, typed.getBlockCount());
+        if (namedSink.count != typedSink.count || namedSink.sum != typedSink.sum)
+        {
+            printf("the queues delivered different messages\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // one producer thread posting bursts, as input arrives between frames, the consumer polls
+    // until a burst arrived and the producer waits for it before the next one, so the ring never floods
+    template <typename Post, typename Poll>
+    double crossThread(const Post& post, const Poll& poll, Sink& sink)
+    {
+        std::atomic<int> consumed(0);
+        double begin = now();
+        std::thread producer([&post, &consumed]()
+        {
+            for (int burst = 0; burst < Bursts; ++burst)
+            {
+                for (int i = 0; i < BurstSize; ++i)
+                {
+                    post(burst * BurstSize + i);
+                }
+                while (consumed.load(std::memory_order_acquire) < (burst + 1) * BurstSize)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        while (sink.count < Bursts * BurstSize)
+        {
+            int before = sink.count;
+            poll(sink);
+            consumed.store(sink.count, std::memory_order_release);
+            if (sink.count == before)
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        return now() - begin;
+    }
+
+    void benchCrossThread()
+    {
+        Sink namedSink, typedSink;
+        EventQueue named;
+        double namedTime = crossThread(
+            [&named](int i) { named.post("Move"_slice, intptr_t(1), double(i), 0.0); },
+            [&named](Sink& sink) { pollNamed(named, sink); },
+            namedSink);
+
+        TypedEventQueue<> typed;
+        double typedTime = crossThread(
+            [&typed](int i) { typed.post(MoveMessage{1, double(i), 0.0}); },
+            [&typed](Sink& sink) { pollTyped(typed, sink); },
+            typedSink);
+
+        printf("bursts of %d across threads: EventQueue %.1f ns/msg, TypedEventQueue %.1f ns/msg, %d pooled blocks\n",
+            BurstSize, namedTime / namedSink.count, typedTime / typedSink.count, typed.getBlockCount());
+    }
+}
+
+int main()
+{
+    benchBursts();
+    benchCrossThread();
+    return EXIT_SUCCESS;
+}
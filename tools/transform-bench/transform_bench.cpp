@@ -0,0 +1,163 @@
+// Times the TransformSystem against the regular visit path on hierarchies of
+// 10k, 50k and 100k nodes, and checks that both draw with the same transforms.
+// See README.md for building it.
+
+#include "ccHeader.h"
+#include "2d/CCNode.h"
+#include "2d/CCTransformSystem.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+USING_NS_CC;
+
+namespace
+{
+    const int NodeCounts[] = {10000, 50000, 100000};
+    const int FanOut = 8;
+    const int Frames = 60;
+    const int ParallelThreshold = 4096;
+
+    // keeps the transform draw is called with, the same for every path
+    class Probe : public Node
+    {
+    public:
+        void draw(IRenderer* renderer, const Mat4& transform, uint32_t flags) override
+        {
+            world = transform;
+        }
+        Mat4 world;
+    };
+
+    struct Tree
+    {
+        Node* root;
+        std::vector<Probe*> nodes;
+    };
+
+    // breadth first with FanOut children per node, the shape of a large tile map or particle scene
+    Tree build(int count)
+    {
+        Tree tree;
+        tree.root = new (std::nothrow) Probe();
+        tree.root->init();
+        for (int i = 0; i < count; ++i)
+        {
+            Node* parent = i < FanOut ? tree.root : tree.nodes[i / FanOut - 1];
+            Probe* node = new (std::nothrow) Probe();
+            node->init();
+            node->setPosition(float(i % 97), float(i % 89));
+            node->setRotation(float(i % 360));
+            parent->addChild(node);
+            node->release();
+            tree.nodes.push_back(node);
+        }
+        return tree;
+    }
+
+    enum class Change
+    {
+        None,
+        Some,              // a tenth of the nodes moved in update, before the TransformSystem runs
+        SomeAfterUpdate,   // the same nodes moved after it, as a layout or a label does during visit
+        Root               // the root moved, every world transform changes
+    };
+
+    const char* const ChangeNames[] = {"static", "10% moved", "10% moved late", "root moved"};
+
+    void apply(Tree& tree, std::mt19937& rng, int frame, Change change)
+    {
+        if (change == Change::Root)
+        {
+            tree.root->setRotation(float(frame));
+            return;
+        }
+        int moved = static_cast<int>(tree.nodes.size()) / 10;
+        for (int i = 0; i < moved && change != Change::None; ++i)
+        {
+            Probe* node = tree.nodes[rng() % tree.nodes.size()];
+            node->setPosition(float(frame), float(rng() % 100));
+        }
+    }
+
+    // frames of the same changes on every path, the system is nullptr for the regular one
+    double run(Tree& tree, TransformSystem* system, Change change)
+    {
+        std::mt19937 rng(5);
+        auto begin = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < Frames; ++frame)
+        {
+            if (change != Change::SomeAfterUpdate)
+            {
+                apply(tree, rng, frame, change);
+            }
+            if (system)
+            {
+                system->update(Mat4::IDENTITY);
+            }
+            if (change == Change::SomeAfterUpdate)
+            {
+                apply(tree, rng, frame, change);
+            }
+            tree.root->visit(nullptr, Mat4::IDENTITY, 0);
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() / Frames;
+    }
+
+    bool same(const Tree& a, const Tree& b)
+    {
+        for (size_t i = 0; i < a.nodes.size(); ++i)
+        {
+            if (memcmp(a.nodes[i]->world.m, b.nodes[i]->world.m, sizeof(a.nodes[i]->world.m)) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool bench(int count)
+    {
+        Tree regular = build(count);
+        Tree serial = build(count);
+        Tree parallel = build(count);
+        TransformSystem serialSystem(serial.root);
+        TransformSystem parallelSystem(parallel.root);
+        parallelSystem.setParallelThreshold(ParallelThreshold);
+
+        printf("%d nodes in %d levels, ms per frame: visit, TransformSystem, parallel from %d\n",
+            count, serialSystem.getLevelCount(), ParallelThreshold);
+        bool ok = true;
+        for (Change change : {Change::None, Change::Some, Change::SomeAfterUpdate, Change::Root})
+        {
+            double regularTime = run(regular, nullptr, change);
+            double serialTime = run(serial, &serialSystem, change);
+            double parallelTime = run(parallel, &parallelSystem, change);
+            printf("%15s: %7.2f %7.2f %7.2f\n", ChangeNames[static_cast<int>(change)], regularTime, serialTime, parallelTime);
+            if (!same(regular, serial) || !same(regular, parallel))
+            {
+                printf("the TransformSystem drew with different transforms\n");
+                ok = false;
+                break;
+            }
+        }
+        regular.root->release();
+        serial.root->release();
+        parallel.root->release();
+        return ok;
+    }
+}
+
+int main()
+{
+    for (int count : NodeCounts)
+    {
+        if (!bench(count))
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
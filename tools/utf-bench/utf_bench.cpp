@@ -0,0 +1,207 @@
+// Checks StringUtils::UTF8ToUTF16 and UTF16ToUTF8 against the ConvertUTF reference
+// on random input, then times both on 4 KB texts from all Latin to all CJK.
+// See README.md for building it against the SSE2, NEON and scalar paths.
+
+#include "ccHeader.h"
+#include "base/ccUTF8.h"
+#include "ConvertUTF/ConvertUTF.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using cocos2d::StringUtils::UTF8ToUTF16;
+using cocos2d::StringUtils::UTF16ToUTF8;
+
+namespace
+{
+    const int FuzzRounds = 300000;
+    const int MaxFuzzLength = 80;
+    const size_t CorpusBytes = 4096;
+    const int BenchRounds = 20000;
+
+    // what ccUTF8.cpp did through utfConvert before the ASCII runs, strict, false on any error
+    bool referenceToUTF16(const std::string& from, std::u16string& to)
+    {
+        if (from.empty())
+        {
+            to.clear();
+            return true;
+        }
+        std::u16string working(from.length(), 0);
+        auto in = reinterpret_cast<const UTF8*>(from.data());
+        auto out = reinterpret_cast<UTF16*>(&working[0]);
+        if (ConvertUTF8toUTF16(&in, in + from.length(), &out, out + working.length(), strictConversion) != conversionOK)
+        {
+            return false;
+        }
+        working.resize(reinterpret_cast<char16_t*>(out) - &working[0]);
+        to = std::move(working);
+        return true;
+    }
+
+    bool referenceToUTF8(const std::u16string& from, std::string& to)
+    {
+        if (from.empty())
+        {
+            to.clear();
+            return true;
+        }
+        std::string working(from.length() * 4, 0);
+        auto in = reinterpret_cast<const UTF16*>(from.data());
+        auto out = reinterpret_cast<UTF8*>(&working[0]);
+        if (ConvertUTF16toUTF8(&in, in + from.length(), &out, out + working.length(), strictConversion) != conversionOK)
+        {
+            return false;
+        }
+        working.resize(reinterpret_cast<char*>(out) - &working[0]);
+        to = std::move(working);
+        return true;
+    }
+
+    void appendCodePoint(std::string& text, char32_t codePoint)
+    {
+        std::u32string one(1, codePoint);
+        std::string utf8;
+        cocos2d::StringUtils::UTF32ToUTF8(one, utf8);
+        text += utf8;
+    }
+
+    // random bytes, or text mixing ASCII with 2 byte, CJK and 4 byte sequences, with stray continuation bytes
+    std::string makeUTF8(std::mt19937& rng)
+    {
+        int length = rng() % MaxFuzzLength;
+        int mode = rng() % 3;
+        std::string text;
+        for (int i = 0; i < length; ++i)
+        {
+            if (mode == 0)
+            {
+                text.push_back(static_cast<char>(rng() % 256));
+                continue;
+            }
+            int kind = rng() % 10;
+            if (kind < 6)
+                text.push_back(static_cast<char>(32 + rng() % 95));
+            else if (kind < 8)
+                appendCodePoint(text, 0x80 + rng() % 0x780);
+            else if (kind < 9)
+                appendCodePoint(text, 0x4E00 + rng() % 0x5000);
+            else
+                appendCodePoint(text, 0x10000 + rng() % 0x10000);
+            if (mode == 2 && rng() % 20 == 0)
+                text.push_back(static_cast<char>(0x80 + rng() % 0x40));
+        }
+        return text;
+    }
+
+    // mostly ASCII, with any unit and lone or paired surrogates
+    std::u16string makeUTF16(std::mt19937& rng)
+    {
+        int length = rng() % MaxFuzzLength;
+        std::u16string text;
+        for (int i = 0; i < length; ++i)
+        {
+            int kind = rng() % 10;
+            if (kind < 6)
+                text.push_back(static_cast<char16_t>(rng() % 0x80));
+            else if (kind < 8)
+                text.push_back(static_cast<char16_t>(rng() % 0x10000));
+            else
+                text.push_back(static_cast<char16_t>(0xD800 + rng() % 0x800));
+        }
+        return text;
+    }
+
+    bool fuzz()
+    {
+        std::mt19937 rng(7);
+        for (int round = 0; round < FuzzRounds; ++round)
+        {
+            std::string utf8 = makeUTF8(rng);
+            // not empty, a failed conversion must leave the output alone in both
+            std::u16string converted = u"x", expected = u"x";
+            bool ok = UTF8ToUTF16(utf8, converted);
+            if (ok != referenceToUTF16(utf8, expected) || converted != expected)
+            {
+                printf("UTF8ToUTF16 differs from ConvertUTF in round %d\n", round);
+                return false;
+            }
+
+            std::u16string utf16 = makeUTF16(rng);
+            std::string narrowed = "x", narrowedExpected = "x";
+            ok = UTF16ToUTF8(utf16, narrowed);
+            if (ok != referenceToUTF8(utf16, narrowedExpected) || narrowed != narrowedExpected)
+            {
+                printf("UTF16ToUTF8 differs from ConvertUTF in round %d\n", round);
+                return false;
+            }
+        }
+        printf("fuzz: %d rounds match ConvertUTF\n", FuzzRounds);
+        return true;
+    }
+
+    std::string makeCorpus(std::mt19937& rng, double cjkRatio)
+    {
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+        std::string text;
+        while (text.size() < CorpusBytes)
+        {
+            if (chance(rng) < cjkRatio)
+                appendCodePoint(text, 0x4E00 + rng() % 0x5000);
+            else
+                text.push_back(static_cast<char>(32 + rng() % 95));
+        }
+        return text;
+    }
+
+    template <typename Func>
+    double measure(Func func)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for (int round = 0; round < BenchRounds; ++round)
+        {
+            func();
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    void bench()
+    {
+        std::mt19937 rng(11);
+        printf("%d conversions of %d KB, StringUtils vs ConvertUTF in ms\n", BenchRounds, static_cast<int>(CorpusBytes / 1024));
+        for (double cjkRatio : {0.0, 0.05, 0.5, 1.0})
+        {
+            std::string utf8 = makeCorpus(rng, cjkRatio);
+            std::u16string utf16;
+            UTF8ToUTF16(utf8, utf16);
+            std::u16string wide;
+            std::string narrow;
+            double toUTF16 = measure([&]() { UTF8ToUTF16(utf8, wide); });
+            double toUTF16Reference = measure([&]() { referenceToUTF16(utf8, wide); });
+            double toUTF8 = measure([&]() { UTF16ToUTF8(utf16, narrow); });
+            double toUTF8Reference = measure([&]() { referenceToUTF8(utf16, narrow); });
+            printf("%3d%% CJK: 8->16 %7.1f vs %7.1f, 16->8 %7.1f vs %7.1f\n", static_cast<int>(cjkRatio * 100),
+                toUTF16, toUTF16Reference, toUTF8, toUTF8Reference);
+        }
+    }
+}
+
+int main()
+{
+#if defined(CC_UTF_NO_SIMD)
+    printf("path: scalar\n");
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    printf("path: SSE2\n");
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    printf("path: NEON\n");
+#else
+    printf("path: scalar\n");
+#endif
+    if (!fuzz())
+    {
+        return EXIT_FAILURE;
+    }
+    bench();
+    return EXIT_SUCCESS;
+}